@@ -0,0 +1,218 @@
+// Compares size and CPU time of the supported wire encodings for each PDU type, using randomly filled messages, and
+// measures the throughput of JsonWriter
+#include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+#include <v2x_etsi_asn1_lib/encoding.h>
+#include <v2x_etsi_asn1_lib/json_writer.h>
+#include <v2x_etsi_asn1_lib/logger_setup.h>
+#include <asn_random_fill.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace et = mrm::v2x_etsi_asn1_lib;
+
+struct PDU
+{
+  const char* name;
+  const asn_TYPE_descriptor_t* type;
+};
+
+static constexpr et::WireEncoding encodings[] = { et::WireEncoding::UPER,
+                                                  et::WireEncoding::APER,
+                                                  et::WireEncoding::OER };
+
+// Returns true if the message can be encoded and decoded again with all encodings
+static bool isValidSample(const asn_TYPE_descriptor_t* type, const void* msg)
+{
+  for (auto encoding : encodings)
+  {
+    auto res = et::encodeETSIMsg(type, encoding, msg);
+    if (res.buffer == nullptr || res.result.encoded < 0)
+    {
+      return false;
+    }
+    void* decoded = nullptr;
+    auto ret = et::decodeETSIMsg(type, encoding, &decoded, res.buffer, res.result.encoded);
+    ASN_STRUCT_FREE(*type, decoded);
+    free(res.buffer);
+    if (ret.code != RC_OK)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::vector<void*> randomSamples(const PDU& pdu, size_t num_samples)
+{
+  std::vector<void*> samples;
+  for (size_t attempt = 0; samples.size() < num_samples && attempt < 100 * num_samples; attempt++)
+  {
+    void* msg = nullptr;
+    if (asn_random_fill(pdu.type, &msg, 2000) == 0 && isValidSample(pdu.type, msg))
+    {
+      samples.push_back(msg);
+    }
+    else
+    {
+      ASN_STRUCT_FREE(*pdu.type, msg);
+    }
+  }
+  return samples;
+}
+
+static void benchmarkEncodings(const PDU& pdu, const std::vector<void*>& samples, size_t iterations)
+{
+  for (auto encoding : encodings)
+  {
+    using Clock = std::chrono::steady_clock;
+    size_t total_size = 0;
+    std::vector<std::vector<uint8_t>> encoded;
+    const auto encode_start = Clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+      for (const auto* msg : samples)
+      {
+        auto res = et::encodeETSIMsg(pdu.type, encoding, msg);
+        if (i == 0)
+        {
+          const auto* data = static_cast<const uint8_t*>(res.buffer);
+          encoded.emplace_back(data, data + res.result.encoded);
+          total_size += res.result.encoded;
+        }
+        free(res.buffer);
+      }
+    }
+    const auto encode_time = Clock::now() - encode_start;
+
+    const auto decode_start = Clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+      for (const auto& buffer : encoded)
+      {
+        void* msg = nullptr;
+        et::decodeETSIMsg(pdu.type, encoding, &msg, buffer.data(), buffer.size());
+        ASN_STRUCT_FREE(*pdu.type, msg);
+      }
+    }
+    const auto decode_time = Clock::now() - decode_start;
+
+    const double n = static_cast<double>(samples.size() * iterations);
+    std::cout << std::setw(6) << pdu.name << std::setw(6) << et::toString(encoding) << std::fixed
+              << std::setprecision(1) << std::setw(12) << static_cast<double>(total_size) / samples.size()
+              << std::setprecision(3) << std::setw(14)
+              << std::chrono::duration<double, std::micro>(encode_time).count() / n << std::setw(14)
+              << std::chrono::duration<double, std::micro>(decode_time).count() / n << std::endl;
+  }
+}
+
+// Text output of JsonWriter, with raw values and in SI units, compared to the XER printer of asn1c
+static void benchmarkJson(const PDU& pdu, const std::vector<void*>& samples, size_t iterations)
+{
+  auto print = [&](const char* name, size_t total_size, std::chrono::steady_clock::duration time) {
+    const double n = static_cast<double>(samples.size() * iterations);
+    const double seconds = std::chrono::duration<double>(time).count();
+    std::cout << std::setw(6) << pdu.name << std::setw(6) << name << std::fixed << std::setprecision(1)
+              << std::setw(12) << static_cast<double>(total_size) / samples.size() << std::setprecision(3)
+              << std::setw(14) << seconds * 1e6 / n << std::setprecision(1) << std::setw(14)
+              << static_cast<double>(total_size) * iterations / seconds / 1e6 << std::endl;
+  };
+
+  for (bool si_units : { false, true })
+  {
+    // one writer for all messages, which are written as JSON Lines and cleared once the buffer is large
+    et::JsonWriter writer(si_units);
+    size_t total_size = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+      for (const auto* msg : samples)
+      {
+        const auto size = writer.buffer().size();
+        writer.write(*pdu.type, msg);
+        if (i == 0)
+        {
+          total_size += writer.buffer().size() - size;
+        }
+        if (writer.buffer().size() > 1024 * 1024)
+        {
+          writer.clear();
+        }
+      }
+    }
+    print(si_units ? "si" : "json", total_size, std::chrono::steady_clock::now() - start);
+  }
+
+  size_t total_size = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+  {
+    for (const auto* msg : samples)
+    {
+      auto res = asn_encode_to_new_buffer(nullptr, ATS_BASIC_XER, pdu.type, msg);
+      if (i == 0 && res.result.encoded > 0)
+      {
+        total_size += res.result.encoded;
+      }
+      free(res.buffer);
+    }
+  }
+  print("xer", total_size, std::chrono::steady_clock::now() - start);
+}
+
+int main(int argc, char** argv)
+{
+  mrm::v2x_etsi_asn1_lib::_setLogLevel(aduulm_logger::LoggerLevel::Warn);
+  aduulm_logger::initLogger();
+
+  const size_t num_samples = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+  const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+  srandom(42);
+
+  const PDU pdus[] = {
+    { "CAM", &asn_DEF_CAM },
+    { "VAM", &asn_DEF_VAM },
+    { "CPM", &asn_DEF_CollectivePerceptionMessage },
+    { "MCM", &asn_DEF_MCM },
+  };
+  std::vector<std::vector<void*>> samples;
+  for (const auto& pdu : pdus)
+  {
+    samples.push_back(randomSamples(pdu, num_samples));
+  }
+
+  std::cout << std::setw(6) << "PDU" << std::setw(6) << "enc" << std::setw(12) << "avg bytes" << std::setw(14)
+            << "encode [us]" << std::setw(14) << "decode [us]" << std::endl;
+  for (size_t i = 0; i < std::size(pdus); i++)
+  {
+    if (samples[i].empty())
+    {
+      std::cout << std::setw(6) << pdus[i].name << "  no valid random samples" << std::endl;
+      continue;
+    }
+    benchmarkEncodings(pdus[i], samples[i], iterations);
+  }
+
+  std::cout << std::endl
+            << std::setw(6) << "PDU" << std::setw(6) << "text" << std::setw(12) << "avg bytes" << std::setw(14)
+            << "write [us]" << std::setw(14) << "MB/s" << std::endl;
+  for (size_t i = 0; i < std::size(pdus); i++)
+  {
+    if (!samples[i].empty())
+    {
+      benchmarkJson(pdus[i], samples[i], iterations);
+    }
+    for (auto* msg : samples[i])
+    {
+      ASN_STRUCT_FREE(*pdus[i].type, msg);
+    }
+  }
+}
+
+// for aduulm_logger: This has to be part of the compile unit of the executable.
+// Otherwise, undefined reference errors will result.
+DEFINE_LOGGER_VARIABLES
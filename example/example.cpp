@@ -1,4 +1,6 @@
 #include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+#include <v2x_etsi_asn1_lib/generation_manager.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
 #include <v2x_etsi_asn1_lib/utils.h>
 #include <v2x_etsi_asn1_lib/units.h>
 #include <v2x_etsi_asn1_lib/logger_setup.h>
@@ -17,9 +19,10 @@ public:
   }
 
   // Fills a CAM message with dummy data and sends it
-  void sendDummyCAM()
+  void sendDummyCAM(bool include_low_frequency_container)
   {
-    auto pMsg = et::allocateETSIMsg<CAM>(asn_DEF_CAM);
+    // the builder reuses the memory of the previous CAM instead of allocating every member
+    auto* pMsg = &cam_builder_.reset();
 
     pMsg->header.protocolVersion = 2;
     pMsg->header.messageId = MessageId_cam;
@@ -67,9 +70,7 @@ public:
 
     double vel = 1.0;
     double vel_var = 1.0;
-    hf.speed.speedValue = encodeValue(vel, SpeedValueUnit_m_s, 0, SpeedValue_outOfRange);
-    hf.speed.speedConfidence =
-        encodeConfidenceFromStdDev(std::sqrt(vel_var), SpeedConfidenceUnit_m_s, SpeedConfidence_outOfRange);
+    et::setSpeed(hf.speed, std::abs(vel), std::sqrt(vel_var));
     hf.driveDirection = (vel >= 0) ? DriveDirection_forward : DriveDirection_backward;
 
     double length = 1.0;
@@ -98,7 +99,18 @@ public:
         yrt, YawRateValueUnit_degree_per_second_, YawRateValue_negativeOutOfRange, YawRateValue_positiveOutOfRange);
     hf.yawRate.yawRateConfidence = get_yawrate_confidence(std::sqrt(yrt_var));
 
-    sendETSIMsg(&asn_DEF_CAM, et::ETSIMessageType::CAM, pMsg.get());
+    if (include_low_frequency_container)
+    {
+      auto& lf = cam_builder_.create(pMsg->cam.camParameters.lowFrequencyContainer);
+      lf.present = LowFrequencyContainer_PR_basicVehicleContainerLowFrequency;
+      auto& basic_lf = lf.choice.basicVehicleContainerLowFrequency;
+      basic_lf.vehicleRole = VehicleRole_default;
+      const uint8_t exterior_lights = 0;
+      cam_builder_.setBits(basic_lf.exteriorLights, &exterior_lights, 8);
+      // the path history (up to 23 path points) would be added with cam_builder_.append(basic_lf.pathHistory.list)
+    }
+
+    sendETSIMsg(&asn_DEF_CAM, et::ETSIMessageType::CAM, pMsg);
   }
 
 protected:
@@ -133,6 +145,9 @@ protected:
     const uint64_t reconstructed_time = et::GenerationDeltaTime2UnixTime(msg->mcm.generationDeltaTime, now);
     LOG_INF("MCM time: " << time << ", delay: " << (now - reconstructed_time)*1e-6 << "ms");
   }
+
+private:
+  et::MessageBuilder<CAM> cam_builder_;
 };
 
 int main()
@@ -162,14 +177,39 @@ int main()
   //   Receive all CPM messages from station ID 42: "station_id = 42 AND mid = 2049"
   std::string filter_query = "";
 
-  transceiver.connect(station_id, url, address_rx, address_tx, user, pw, filter_query);
+  // Receiver flow control: the broker may send up to credit_window messages ahead of the receiver thread.
+  // Larger windows increase the throughput for many small messages. With adaptive credit, at most credit_window
+  // messages are buffered in the client, which bounds the memory usage during bursts (e.g. segmented CPMs).
+  uint32_t credit_window = 100;
+  bool adaptive_credit = true;
+
+  // Keep the latest state of all stations in a lock-free table, which can be read from any thread
+  transceiver.enableStationTable();
+
+  transceiver.connect(station_id, url, address_rx, address_tx, user, pw, filter_query, credit_window, adaptive_credit);
+
+  // Decides when a CAM is due according to the ETSI triggering conditions (heading, position and speed changes,
+  // T_GenCamMin/T_GenCamMax), instead of sending one every 100 ms
+  et::GenerationManager cam_generation(et::GenerationRules::cam());
   while (1) {
     // Transceiver has its own receiver thread, so messages will be automatically received in that thread.
     // The main thread can be used to send messages.
     // Make sure to use locks to protect from threading race conditions when accessing data from receiver callback handler functions.
 
-    transceiver.sendDummyCAM();
+    // the state of the dummy CAM, in the units of StationState
+    const et::GenerationState ego_state{ 0.0, 0.0, 90.0 - 1.0 * 180 / M_PI, 1.0 };
+    const auto decision = cam_generation.check(ego_state);
+    if (decision.send)
+    {
+      transceiver.sendDummyCAM(decision.include_low_frequency_container);
+    }
+
+    for (const auto& station : transceiver.stationTable()->snapshot())
+    {
+      LOG_DEB("Station " << station.station_id << " at " << station.latitude << ", " << station.longitude);
+    }
 
+    // T_CheckCamGen, has to be at most T_GenCamMin
     using namespace std::chrono_literals;
     std::this_thread::sleep_for(100ms);
   }
@@ -0,0 +1,457 @@
+// Load generator for measuring the publish-to-handler performance of the transceiver with a broker: one sender
+// publishes a mix of randomly filled CAMs, VAMs, CPMs and MCMs at a target rate on behalf of many virtual stations,
+// and a number of receivers counts them and measures the latency from their creation time. The results are written
+// to stdout as one JSON object.
+#include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+#include <v2x_etsi_asn1_lib/encoding.h>
+#include <v2x_etsi_asn1_lib/logger_setup.h>
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <v2x_amqp_connector_lib/logger_setup.h>
+#include <asn_random_fill.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace et = mrm::v2x_etsi_asn1_lib;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+struct Options
+{
+  std::string url = "localhost:5672";
+  std::string address = "etsi";
+  std::string user = "anonymous";
+  std::string pw = "";
+  // messages per second over all stations and message types
+  double rate = 1000.0;
+  double duration = 10.0;
+  uint32_t stations = 100;
+  // station IDs station_base ... station_base + stations - 1 are used, receivers only subscribe to these
+  uint32_t station_base = 100000;
+  size_t receivers = 1;
+  // relative weights of CAM, VAM, CPM and MCM
+  std::vector<double> mix = { 1.0, 0.0, 0.0, 0.0 };
+  uint32_t credit_window = 1000;
+  std::chrono::milliseconds batch_interval{ 10 };
+  std::chrono::milliseconds warmup{ 1000 };
+  // maximum time to wait for outstanding messages after sending
+  std::chrono::milliseconds drain{ 5000 };
+  // run an in-process broker listening on url instead of using an external one
+  bool local_broker = false;
+};
+
+struct MessageKind
+{
+  const char* name;
+  const asn_TYPE_descriptor_t* type;
+  et::ETSIMessageType message_type;
+  std::vector<void*> samples;
+  size_t next_sample = 0;
+  // smooth weighted round robin state for the mix
+  double weight = 0.0;
+  double credit = 0.0;
+  uint64_t scheduled = 0;
+  uint64_t sent = 0;
+};
+
+struct ReceiverStats
+{
+  // latencies in ms per message kind, only written from the receiver thread
+  std::vector<std::vector<double>> latencies;
+  std::atomic<uint64_t> received = 0;
+};
+
+void printUsage(const char* name)
+{
+  const Options defaults;
+  std::cerr << "usage: " << name << " [--help] [--option=value ...]\n"
+            << "  --url=" << defaults.url << "  --address=" << defaults.address << "  --user=" << defaults.user
+            << "  --pw=\n"
+            << "  --rate=" << defaults.rate << "        messages per second\n"
+            << "  --duration=" << defaults.duration << "      seconds of sending\n"
+            << "  --stations=" << defaults.stations << "     number of virtual stations\n"
+            << "  --station-base=" << defaults.station_base << "  first station ID\n"
+            << "  --receivers=" << defaults.receivers << "      number of receiving connections\n"
+            << "  --mix=cam:1,vam:0,cpm:0,mcm:0  relative weights of the message types\n"
+            << "  --credit-window=" << defaults.credit_window
+            << "  --batch-interval-ms=" << defaults.batch_interval.count()
+            << "  --warmup-ms=" << defaults.warmup.count() << "  --drain-ms=" << defaults.drain.count() << "\n"
+            << "  --local-broker=0  1 to run an in-process broker on --url" << std::endl;
+}
+
+bool parseMix(const std::string& value, std::vector<double>& mix)
+{
+  static const char* names[] = { "cam", "vam", "cpm", "mcm" };
+  std::fill(mix.begin(), mix.end(), 0.0);
+  std::stringstream stream(value);
+  std::string entry;
+  while (std::getline(stream, entry, ','))
+  {
+    const auto colon = entry.find(':');
+    const auto* name = std::find(std::begin(names), std::end(names), entry.substr(0, colon));
+    if (colon == std::string::npos || name == std::end(names))
+    {
+      return false;
+    }
+    mix[name - std::begin(names)] = std::max(0.0, std::atof(entry.c_str() + colon + 1));
+  }
+  return std::any_of(mix.begin(), mix.end(), [](double weight) { return weight > 0.0; });
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    const auto eq = arg.find('=');
+    if (arg.rfind("--", 0) != 0 || eq == std::string::npos)
+    {
+      return false;
+    }
+    const auto key = arg.substr(2, eq - 2);
+    const auto value = arg.substr(eq + 1);
+    if (key == "url")
+    {
+      options.url = value;
+    }
+    else if (key == "address")
+    {
+      options.address = value;
+    }
+    else if (key == "user")
+    {
+      options.user = value;
+    }
+    else if (key == "pw")
+    {
+      options.pw = value;
+    }
+    else if (key == "rate")
+    {
+      options.rate = std::atof(value.c_str());
+    }
+    else if (key == "duration")
+    {
+      options.duration = std::atof(value.c_str());
+    }
+    else if (key == "stations")
+    {
+      options.stations = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+    }
+    else if (key == "station-base")
+    {
+      options.station_base = std::strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "receivers")
+    {
+      options.receivers = std::strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "credit-window")
+    {
+      options.credit_window = std::strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "batch-interval-ms")
+    {
+      options.batch_interval = std::chrono::milliseconds(std::max(1l, std::atol(value.c_str())));
+    }
+    else if (key == "warmup-ms")
+    {
+      options.warmup = std::chrono::milliseconds(std::atol(value.c_str()));
+    }
+    else if (key == "drain-ms")
+    {
+      options.drain = std::chrono::milliseconds(std::atol(value.c_str()));
+    }
+    else if (key == "local-broker")
+    {
+      options.local_broker = value == "1" || value == "true";
+    }
+    else if (key != "mix" || !parseMix(value, options.mix))
+    {
+      return false;
+    }
+  }
+  return options.rate > 0.0 && options.duration > 0.0;
+}
+
+// Randomly filled messages which can be encoded with UPER
+std::vector<void*> makeSamples(const asn_TYPE_descriptor_t* type, size_t num_samples)
+{
+  std::vector<void*> samples;
+  for (size_t attempt = 0; samples.size() < num_samples && attempt < 100 * num_samples; attempt++)
+  {
+    void* msg = nullptr;
+    bool valid = asn_random_fill(type, &msg, 2000) == 0;
+    if (valid)
+    {
+      auto res = et::encodeETSIMsg(type, et::WireEncoding::UPER, msg);
+      valid = res.buffer != nullptr && res.result.encoded >= 0;
+      free(res.buffer);
+    }
+    if (valid)
+    {
+      samples.push_back(msg);
+    }
+    else
+    {
+      ASN_STRUCT_FREE(*type, msg);
+    }
+  }
+  return samples;
+}
+
+template <class T>
+void registerLatencyHandler(et::ETSIAMQPTransceiverBase& receiver,
+                            const asn_TYPE_descriptor_t& type,
+                            et::ETSIMessageType message_type,
+                            size_t kind,
+                            ReceiverStats& stats)
+{
+  auto handler = [&stats, kind](const std::shared_ptr<const T>& /*msg*/, const et::BinaryETSIMessage& msg_bin) {
+    const auto latency = std::chrono::system_clock::now() - msg_bin.time;
+    stats.latencies[kind].push_back(std::chrono::duration<double, std::milli>(latency).count());
+    stats.received.fetch_add(1, std::memory_order_relaxed);
+  };
+  receiver.registerHandler<T>(type, message_type, std::move(handler));
+}
+
+// Sorts values partially, q in [0, 1]
+double percentile(std::vector<double>& values, double q)
+{
+  if (values.empty())
+  {
+    return 0.0;
+  }
+  const auto index = std::min(values.size() - 1, static_cast<size_t>(q * static_cast<double>(values.size())));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+void writeLatencies(std::ostream& out, std::vector<double> values)
+{
+  out << "{\"p50\":" << percentile(values, 0.5) << ",\"p90\":" << percentile(values, 0.9)
+      << ",\"p99\":" << percentile(values, 0.99) << ",\"p999\":" << percentile(values, 0.999)
+      << ",\"max\":" << (values.empty() ? 0.0 : *std::max_element(values.begin(), values.end())) << "}";
+}
+
+double lossRatio(uint64_t expected, uint64_t received)
+{
+  return expected == 0 ? 0.0 : 1.0 - static_cast<double>(received) / static_cast<double>(expected);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (std::any_of(argv + 1, argv + argc, [](const char* arg) { return std::strcmp(arg, "--help") == 0; }))
+  {
+    printUsage(argv[0]);
+    return 0;
+  }
+  if (!parseOptions(argc, argv, options))
+  {
+    printUsage(argv[0]);
+    return 1;
+  }
+  mrm::v2x_amqp_connector_lib::_setLogLevel(aduulm_logger::LoggerLevel::Warn);
+  mrm::v2x_etsi_asn1_lib::_setLogLevel(aduulm_logger::LoggerLevel::Warn);
+  aduulm_logger::initLogger();
+  srandom(42);
+
+  // declared before the transceivers, so that it is stopped after they disconnected
+  mrm::v2x_amqp_connector_lib::LocalBroker broker;
+  if (options.local_broker && !broker.start(options.url))
+  {
+    std::cerr << "Could not start the local broker on " << options.url << std::endl;
+    return 1;
+  }
+
+  std::vector<MessageKind> kinds = {
+    { "CAM", &asn_DEF_CAM, et::ETSIMessageType::CAM, {} },
+    { "VAM", &asn_DEF_VAM, et::ETSIMessageType::VAM, {} },
+    { "CPM", &asn_DEF_CollectivePerceptionMessage, et::ETSIMessageType::CPM, {} },
+    { "MCM", &asn_DEF_MCM, et::ETSIMessageType::MCM, {} },
+  };
+  double total_weight = 0.0;
+  for (size_t i = 0; i < kinds.size(); i++)
+  {
+    if (options.mix[i] <= 0.0)
+    {
+      continue;
+    }
+    kinds[i].samples = makeSamples(kinds[i].type, 64);
+    if (kinds[i].samples.empty())
+    {
+      std::cerr << "No valid random " << kinds[i].name << " samples" << std::endl;
+      return 1;
+    }
+    kinds[i].weight = options.mix[i];
+    total_weight += kinds[i].weight;
+  }
+
+  // receivers only get the messages of this run, so that several load generators can share a broker
+  std::ostringstream filter;
+  filter << "station_id >= " << options.station_base << " AND station_id < "
+         << static_cast<uint64_t>(options.station_base) + options.stations;
+  std::vector<std::unique_ptr<ReceiverStats>> receiver_stats;
+  std::vector<std::unique_ptr<et::ETSIAMQPTransceiverBase>> receivers;
+  for (size_t i = 0; i < options.receivers; i++)
+  {
+    auto& stats = *receiver_stats.emplace_back(std::make_unique<ReceiverStats>());
+    stats.latencies.resize(kinds.size());
+    auto& receiver = *receivers.emplace_back(std::make_unique<et::ETSIAMQPTransceiverBase>());
+    registerLatencyHandler<CAM>(receiver, asn_DEF_CAM, et::ETSIMessageType::CAM, 0, stats);
+    registerLatencyHandler<VAM>(receiver, asn_DEF_VAM, et::ETSIMessageType::VAM, 1, stats);
+    registerLatencyHandler<CollectivePerceptionMessage>(
+        receiver, asn_DEF_CollectivePerceptionMessage, et::ETSIMessageType::CPM, 2, stats);
+    registerLatencyHandler<MCM>(receiver, asn_DEF_MCM, et::ETSIMessageType::MCM, 3, stats);
+    receiver.connect(options.station_base,
+                     options.url,
+                     options.address,
+                     "",
+                     options.user,
+                     options.pw,
+                     filter.str(),
+                     options.credit_window,
+                     true);
+  }
+
+  et::ETSIAMQPTransceiverBase sender;
+  sender.connect(options.station_base, options.url, "", options.address, options.user, options.pw);
+  const auto connect_deadline = Clock::now() + std::chrono::seconds(10);
+  while (!sender.is_sender_connected() && Clock::now() < connect_deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (!sender.is_sender_connected())
+  {
+    std::cerr << "Could not connect to " << options.url << std::endl;
+    return 1;
+  }
+  // the receivers have no connection state, give them time to attach
+  std::this_thread::sleep_for(options.warmup);
+
+  // each batch interval, all messages due until then are sent, one batch per message type
+  std::vector<std::vector<et::StationETSIMessage>> batches(kinds.size());
+  uint64_t num_scheduled = 0;
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+  for (auto next = start; next < end; next += options.batch_interval)
+  {
+    std::this_thread::sleep_until(next);
+    const auto elapsed = std::chrono::duration<double>(std::min(Clock::now(), end) - start).count();
+    const auto due = static_cast<uint64_t>(elapsed * options.rate);
+    for (; num_scheduled < due; num_scheduled++)
+    {
+      MessageKind* selected = nullptr;
+      for (auto& kind : kinds)
+      {
+        kind.credit += kind.weight;
+        if (kind.weight > 0.0 && (selected == nullptr || kind.credit > selected->credit))
+        {
+          selected = &kind;
+        }
+      }
+      selected->credit -= total_weight;
+      auto* sample = selected->samples[selected->next_sample++ % selected->samples.size()];
+      const StationId_t station_id = options.station_base + num_scheduled % options.stations;
+      batches[selected - kinds.data()].push_back({ station_id, selected->type, selected->message_type, sample });
+      selected->scheduled++;
+    }
+    for (size_t i = 0; i < kinds.size(); i++)
+    {
+      if (!batches[i].empty())
+      {
+        kinds[i].sent += sender.sendETSIMsgBatch(batches[i]);
+        batches[i].clear();
+      }
+    }
+  }
+  const auto send_time = std::chrono::duration<double>(Clock::now() - start).count();
+
+  uint64_t total_sent = 0;
+  for (const auto& kind : kinds)
+  {
+    total_sent += kind.sent;
+  }
+  const uint64_t expected = total_sent * options.receivers;
+  // wait until all messages arrived or no more arrive
+  auto last_received = 0ul;
+  auto last_progress = Clock::now();
+  const auto drain_deadline = Clock::now() + options.drain;
+  while (Clock::now() < drain_deadline)
+  {
+    uint64_t received = 0;
+    for (const auto& stats : receiver_stats)
+    {
+      received += stats->received.load(std::memory_order_relaxed);
+    }
+    if (received != last_received)
+    {
+      last_received = received;
+      last_progress = Clock::now();
+    }
+    if (received >= expected || Clock::now() - last_progress > std::chrono::seconds(1))
+    {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  const auto receive_time = std::chrono::duration<double>(last_progress - start).count();
+  sender.disconnect();
+  for (auto& receiver : receivers)
+  {
+    receiver->disconnect();
+  }
+
+  std::vector<double> all_latencies;
+  uint64_t total_received = 0;
+  std::ostringstream per_type;
+  for (size_t i = 0; i < kinds.size(); i++)
+  {
+    std::vector<double> latencies;
+    for (const auto& stats : receiver_stats)
+    {
+      latencies.insert(latencies.end(), stats->latencies[i].begin(), stats->latencies[i].end());
+    }
+    all_latencies.insert(all_latencies.end(), latencies.begin(), latencies.end());
+    total_received += latencies.size();
+    per_type << (i == 0 ? "" : ",") << "\"" << kinds[i].name << "\":{\"scheduled\":" << kinds[i].scheduled
+             << ",\"sent\":" << kinds[i].sent << ",\"received\":" << latencies.size()
+             << ",\"loss\":" << lossRatio(kinds[i].sent * options.receivers, latencies.size()) << ",\"latency_ms\":";
+    writeLatencies(per_type, std::move(latencies));
+    per_type << "}";
+  }
+
+  std::cout << "{\"target_rate\":" << options.rate << ",\"duration_s\":" << send_time
+            << ",\"stations\":" << options.stations << ",\"receivers\":" << options.receivers
+            << ",\"scheduled\":" << num_scheduled << ",\"sent\":" << total_sent
+            << ",\"send_rate\":" << static_cast<double>(total_sent) / send_time << ",\"received\":" << total_received
+            << ",\"receive_rate\":"
+            << (options.receivers == 0 ? 0.0 : static_cast<double>(total_received) / options.receivers / receive_time)
+            << ",\"loss\":" << lossRatio(expected, total_received) << ",\"latency_ms\":";
+  writeLatencies(std::cout, std::move(all_latencies));
+  std::cout << ",\"per_type\":{" << per_type.str() << "}}" << std::endl;
+
+  for (auto& kind : kinds)
+  {
+    for (auto* sample : kind.samples)
+    {
+      ASN_STRUCT_FREE(*kind.type, sample);
+    }
+  }
+  return 0;
+}
+
+// for aduulm_logger: This has to be part of the compile unit of the executable.
+// Otherwise, undefined reference errors will result.
+DEFINE_LOGGER_VARIABLES
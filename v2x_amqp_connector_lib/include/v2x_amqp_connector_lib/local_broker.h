@@ -0,0 +1,157 @@
+#ifndef LIBRARY_INCLUDE_V2X_AMQP_CONNECTOR_LIB_LOCAL_BROKER_HPP_
+#define LIBRARY_INCLUDE_V2X_AMQP_CONNECTOR_LIB_LOCAL_BROKER_HPP_
+
+#include <v2x_amqp_connector_lib/selector.h>
+
+#include <proton/container.hpp>
+#include <proton/listen_handler.hpp>
+#include <proton/listener.hpp>
+#include <proton/messaging_handler.hpp>
+#include <proton/sender.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+struct LocalBrokerOptions
+{
+  // addresses with queue semantics, all others are topics
+  std::vector<std::string> queues;
+  // messages buffered per queue and per topic receiver, the oldest are dropped beyond it
+  size_t max_depth = 100000;
+  // credit granted to each sending link
+  uint32_t credit_window = 1000;
+  // interval in which expired messages nobody has taken are removed
+  std::chrono::milliseconds expiry_interval{ 1000 };
+};
+
+struct LocalBrokerStats
+{
+  uint64_t received{};
+  uint64_t delivered{};
+  // dropped because their TTL passed before a receiver had credit for them
+  uint64_t expired{};
+  // dropped because a queue or a topic receiver exceeded max_depth
+  uint64_t dropped{};
+  // currently attached receiving links
+  uint64_t receivers{};
+};
+
+// Minimal AMQP 1.0 broker running in-process, as a stand-in for the Docker broker in example/test_broker where tests
+// and benchmarks cannot use Docker or the network. Addresses are created on first use. Topics (the default, like the
+// headers exchanges of the test broker) pass a copy of each message to every attached receiver whose selector matches
+// it, queues keep messages until one matching receiver takes them (round robin). Supports the selector filter of
+// AMQPClient (see Selector), TTL expiry and the receivers' credit. Messages are delivered pre-settled; there is no
+// persistence, no authentication (connect without user or as "anonymous") and no anonymous relay.
+// All broker state is only touched on its container thread, so it needs no locking per message.
+class LocalBroker : public proton::messaging_handler
+{
+public:
+  explicit LocalBroker(LocalBrokerOptions options = {});
+  ~LocalBroker() override;
+
+  // Listens on url (host:port, port 0 picks a free one) and runs the broker on its own thread. Returns false if it is
+  // already running or could not listen.
+  bool start(const std::string& url = "127.0.0.1:0");
+  // Closes all connections and joins the broker thread. Called by the destructor.
+  void stop();
+  // Port the broker listens on, 0 if it is not running
+  [[nodiscard]] int port() const;
+  [[nodiscard]] LocalBrokerStats stats() const;
+
+private:
+  struct Entry
+  {
+    proton::message msg;
+    std::optional<std::chrono::steady_clock::time_point> expiry;
+  };
+  using EntryPtr = std::shared_ptr<const Entry>;
+  struct Node;
+  struct Subscriber
+  {
+    proton::sender sender;
+    Selector selector;
+    Node* node{};
+    // messages not yet sent, only used by topics
+    std::deque<EntryPtr> queue;
+  };
+  struct Node
+  {
+    bool is_queue = false;
+    // messages not yet sent, only used by queues
+    std::deque<EntryPtr> queue;
+    std::vector<std::shared_ptr<Subscriber>> subscribers;
+    // next subscriber of a queue in round robin order
+    size_t next_subscriber = 0;
+  };
+
+  class ListenHandler : public proton::listen_handler
+  {
+  public:
+    explicit ListenHandler(LocalBroker& broker) : broker_(broker)
+    {
+    }
+    void on_open(proton::listener& l) override;
+    proton::connection_options on_accept(proton::listener& l) override;
+    void on_error(proton::listener& l, const std::string& what) override;
+
+  private:
+    LocalBroker& broker_;
+  };
+
+  void on_container_start(proton::container& cont) override;
+  void on_sender_open(proton::sender& s) override;
+  void on_receiver_open(proton::receiver& r) override;
+  void on_message(proton::delivery& dlv, proton::message& msg) override;
+  void on_sendable(proton::sender& s) override;
+  void on_sender_close(proton::sender& s) override;
+  void on_connection_close(proton::connection& conn) override;
+  void on_transport_close(proton::transport& tp) override;
+
+  Node& get_node(const std::string& address);
+  void enqueue(std::deque<EntryPtr>& queue, EntryPtr entry);
+  // Sends queued messages as long as the receivers have credit
+  void drain(Subscriber& subscriber);
+  void drain(Node& node);
+  static bool is_expired(const Entry& entry, std::chrono::steady_clock::time_point now);
+  void remove_expired();
+  void remove_subscriber(const proton::sender& s);
+  void remove_subscribers(const proton::connection& conn);
+  // Wakes up start(), port 0 if listening failed
+  void listening(int port);
+
+  const LocalBrokerOptions options_;
+  std::string url_;
+
+  mutable std::mutex lock_;
+  std::condition_variable started_;
+  bool listening_done_ = false;
+  int port_ = 0;
+
+  // only used on the container thread
+  std::map<std::string, Node> nodes_;
+  std::map<proton::sender, std::shared_ptr<Subscriber>> subscribers_;
+
+  std::atomic<uint64_t> received_ = 0;
+  std::atomic<uint64_t> delivered_ = 0;
+  std::atomic<uint64_t> expired_ = 0;
+  std::atomic<uint64_t> dropped_ = 0;
+  std::atomic<uint64_t> num_receivers_ = 0;
+
+  ListenHandler listen_handler_{ *this };
+  std::shared_ptr<proton::container> container_;
+  std::shared_ptr<std::thread> container_thread_;
+};
+}  // namespace mrm::v2x_amqp_connector_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_AMQP_CONNECTOR_LIB_LOCAL_BROKER_HPP_ */
@@ -0,0 +1,83 @@
+#ifndef LIBRARY_INCLUDE_V2X_AMQP_CONNECTOR_LIB_SELECTOR_HPP_
+#define LIBRARY_INCLUDE_V2X_AMQP_CONNECTOR_LIB_SELECTOR_HPP_
+
+#include <proton/message.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+// Message selector as sent by AMQPClient in the "selector" source filter, i.e. the subset of the JMS / SQL92 syntax
+// used for the application properties of ETSI messages:
+//   comparisons (=, <>, <, <=, >, >=) of properties and integer, decimal, string ('...') or boolean literals,
+//   x [NOT] IN (1, 2), x [NOT] BETWEEN 1 AND 2, x IS [NOT] NULL, NOT, AND, OR and parentheses.
+// Keywords are case insensitive. Missing properties are unknown (NULL) and a message is only selected if the selector
+// is true, so "NOT(station_id = 101)" does not select messages without station_id.
+class Selector
+{
+public:
+  using Value = std::variant<std::monostate, bool, int64_t, double, std::string>;
+  // Value of the property with the given name, std::monostate if it does not exist
+  using PropertyLookup = std::function<Value(const std::string& name)>;
+
+  // Selects all messages
+  Selector() = default;
+  // Returns nullopt and logs the reason if the selector is invalid. An empty selector selects all messages.
+  static std::optional<Selector> parse(std::string_view selector);
+
+  [[nodiscard]] bool matches(const proton::message& msg) const;
+  [[nodiscard]] bool matches(const PropertyLookup& lookup) const;
+  [[nodiscard]] bool empty() const;
+
+private:
+  friend class SelectorParser;
+
+  enum class Kind : uint8_t
+  {
+    Literal,
+    Property,
+    Not,
+    And,
+    Or,
+    Compare,
+    In,
+    Between,
+    IsNull,
+  };
+  enum class CompareOp : uint8_t
+  {
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+  };
+  // Nodes refer to their children by index, the root is the last node
+  struct Node
+  {
+    Kind kind = Kind::Literal;
+    CompareOp op = CompareOp::Equal;
+    // IN, BETWEEN and IS NULL preceded by NOT
+    bool negated = false;
+    // literal value or property name
+    Value value;
+    std::vector<size_t> children;
+  };
+
+  // nullopt is unknown
+  [[nodiscard]] std::optional<bool> condition(size_t index, const PropertyLookup& lookup) const;
+  [[nodiscard]] Value operand(size_t index, const PropertyLookup& lookup) const;
+  [[nodiscard]] static std::optional<bool> compare(const Value& a, const Value& b, CompareOp op);
+
+  std::vector<Node> nodes_;
+};
+}  // namespace mrm::v2x_amqp_connector_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_AMQP_CONNECTOR_LIB_SELECTOR_HPP_ */
@@ -9,29 +9,99 @@
 #include <proton/messaging_handler.hpp>
 #include <proton/receiver.hpp>
 #include <proton/sender.hpp>
+#include <proton/tracker.hpp>
 #include <proton/work_queue.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
 #include <queue>
 #include <optional>
+#include <vector>
 
 namespace mrm::v2x_amqp_connector_lib
 {
+// Order in which the send lanes of an AMQPClient are drained
+enum class LaneScheduling
+{
+  // lane 0 first, a lane is only drained if all lanes before it are empty
+  StrictPriority,
+  // weighted round robin, each lane sends up to its weight messages per round
+  Weighted,
+};
+
+struct SendLaneStats
+{
+  size_t queue_depth{};
+  size_t max_queue_depth{};
+  uint64_t sent{};
+  // dropped because their deadline passed while queued
+  uint64_t expired{};
+  // dropped because the connection was lost
+  uint64_t discarded{};
+};
 
 class AMQPClient : public proton::messaging_handler
 {
 public:
+  // Called with true once the broker accepted a sent message, or with false if it was rejected, released, expired
+  // in its lane or dropped with the connection. Called from the container thread (or the thread calling close()),
+  // so it should return quickly.
+  using SettleCallback = std::function<void(bool accepted)>;
+
+  // Message to be queued by send() with its lane, deadline and optional settlement callback
+  struct OutgoingMessage
+  {
+    proton::message msg;
+    size_t lane = 0;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    SettleCallback on_settled;
+  };
+
+  // Credit window proton uses for receivers if nothing else is configured
+  static constexpr uint32_t default_credit_window = 10;
+
+  // credit_window: maximum number of messages the broker may send ahead of the consumer.
+  // adaptive_credit: if false, proton replenishes the credit as soon as a message has been put into the
+  //   receive queue, so the queue is unbounded if the consumer is slower than the incoming traffic.
+  //   If true, credit is only granted for free slots in the receive queue, i.e. at most credit_window
+  //   messages are queued or in flight at any time.
   AMQPClient(std::string url,
              std::string address_rx,
              std::string address_tx,
              std::string user,
              std::string pw,
-             std::string filter_query = "");
+             std::string filter_query = "",
+             uint32_t credit_window = default_credit_window,
+             bool adaptive_credit = false);
   ~AMQPClient() override;
-  bool send(const proton::message& msg);
+  // Outgoing messages are queued in lanes, which are drained as the broker grants credit. By default, there is a
+  // single lane, which keeps the order of all messages. Queued messages are kept.
+  void set_send_lanes(size_t num_lanes,
+                      LaneScheduling scheduling = LaneScheduling::StrictPriority,
+                      std::vector<uint32_t> weights = {});
+  // Queues msg in the given lane (the last one if out of range). Messages still queued at their deadline are dropped.
+  // If queued, on_settled is called exactly once with the outcome, otherwise never.
+  bool send(const proton::message& msg,
+            size_t lane = 0,
+            std::optional<std::chrono::steady_clock::time_point> deadline = {},
+            SettleCallback on_settled = {});
+  // Queues all messages under one lock and with a single drain of the lanes. Returns the number of queued messages,
+  // i.e. all or none.
+  size_t send(std::vector<OutgoingMessage> msgs);
+  [[nodiscard]] std::vector<SendLaneStats> send_lane_stats() const;
   std::optional<proton::message> receive();
   [[nodiscard]] bool is_sender_connected() const;
   [[nodiscard]] bool is_closing() const;
+  // Replaces the selector given to the constructor. If the receiver is attached, it is closed and re-attached with
+  // the new selector on the same connection; messages arriving at the broker in between are not received.
+  // May be called from any thread.
+  void set_filter_query(std::string filter_query);
+  // Closes the connection for good and wakes up receive(). Called by the destructor.
+  void close();
 
 protected:
   void close_connection();
@@ -42,18 +112,47 @@ private:
   const std::string address_tx_;
   const std::string user_;
   const std::string pw_;
-  const std::string filter_query_;
+  std::string filter_query_;  // guarded by lock_
+  const uint32_t credit_window_;
+  const bool adaptive_credit_;
 
   std::mutex lock_;
   std::optional<proton::connection> connection_;
   std::optional<proton::sender> sender_;
+  std::optional<proton::receiver> receiver_;
   proton::work_queue* work_queue_{};
+  proton::work_queue* receiver_work_queue_{};
+  std::atomic<bool> credit_update_pending_ = false;
   std::condition_variable sender_ready_;
   std::queue<proton::message> messages_;
   std::condition_variable messages_ready_;
   bool closing_connection_ = false;
   bool closing_ = false;
   bool sender_connected_ = false;
+  // selector the receiver was attached with, only used on the container thread
+  std::string receiver_filter_query_;
+
+  struct QueuedMessage
+  {
+    proton::message msg;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    SettleCallback on_settled;
+  };
+  struct SendLane
+  {
+    std::deque<QueuedMessage> queue;
+    uint32_t weight = 1;
+    // messages left in the current round of weighted scheduling
+    uint32_t round_credit = 0;
+    SendLaneStats stats;
+  };
+  mutable std::mutex send_lock_;
+  std::vector<SendLane> send_lanes_ = std::vector<SendLane>(1);
+  LaneScheduling scheduling_ = LaneScheduling::StrictPriority;
+  size_t current_lane_ = 0;
+  std::atomic<bool> drain_pending_ = false;
+  // callbacks of sent messages waiting for the outcome, guarded by send_lock_
+  std::map<proton::tracker, SettleCallback> unsettled_;
 
   std::shared_ptr<proton::container> container_;
   std::shared_ptr<std::thread> container_thread_;
@@ -62,9 +161,24 @@ private:
   void on_container_start(proton::container& cont) override;
   void on_connection_open(proton::connection& conn) override;
   void on_sender_open(proton::sender& s) override;
+  void on_sendable(proton::sender& s) override;
+  void on_receiver_open(proton::receiver& r) override;
   void on_message(proton::delivery& dlv, proton::message& msg) override;
+  void on_tracker_accept(proton::tracker& t) override;
+  void on_tracker_reject(proton::tracker& t) override;
+  void on_tracker_release(proton::tracker& t) override;
+  void on_tracker_settle(proton::tracker& t) override;
 
   void open_senders();
+  void open_receiver(proton::connection& conn);
+  void update_receiver_filter();
+  void update_credit();
+  void drain_send_lanes();
+  // Removes the messages whose deadline passed from all lanes and appends their callbacks to expired
+  void remove_expired(std::chrono::steady_clock::time_point now, std::vector<SettleCallback>& expired);
+  std::optional<QueuedMessage> next_message();
+  void discard_send_lanes();
+  void settle(const proton::tracker& tracker, bool accepted);
   void on_error(const proton::error_condition& e) override;
   void on_transport_close(proton::transport& tp) override;
   void on_transport_error(proton::transport& tp) override;
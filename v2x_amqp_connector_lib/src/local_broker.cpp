@@ -0,0 +1,367 @@
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <aduulm_logger/aduulm_logger.hpp>
+#include <proton/codec/decoder.hpp>
+#include <proton/connection_options.hpp>
+#include <proton/delivery.hpp>
+#include <proton/delivery_mode.hpp>
+#include <proton/receiver.hpp>
+#include <proton/receiver_options.hpp>
+#include <proton/sender_options.hpp>
+#include <proton/source.hpp>
+#include <proton/source_options.hpp>
+#include <proton/target.hpp>
+#include <proton/target_options.hpp>
+#include <proton/transport.hpp>
+#include <algorithm>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+namespace
+{
+// The selector AMQPClient sends as described value in the source filter, empty if there is none
+std::string selector_of(const proton::source& source)
+{
+  const auto filters = source.filters();
+  const proton::symbol key("selector");
+  if (!filters.exists(key))
+  {
+    return "";
+  }
+  const auto filter = filters.get(key);
+  if (filter.type() != proton::DESCRIBED)
+  {
+    return "";
+  }
+  proton::codec::decoder decoder(filter);
+  proton::codec::start start;
+  proton::value descriptor;
+  std::string selector;
+  decoder >> start >> descriptor >> selector >> proton::codec::finish();
+  return selector;
+}
+}  // namespace
+
+LocalBroker::LocalBroker(LocalBrokerOptions options) : options_(std::move(options))
+{
+}
+
+LocalBroker::~LocalBroker()
+{
+  stop();
+}
+
+bool LocalBroker::start(const std::string& url)
+{
+  if (container_)
+  {
+    LOG_ERR("Local broker is already running");
+    return false;
+  }
+  url_ = url;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    listening_done_ = false;
+    port_ = 0;
+  }
+  container_ = std::make_shared<proton::container>(*this);
+  container_thread_ = std::make_shared<std::thread>([this]() { container_->run(); });
+
+  std::unique_lock<std::mutex> l(lock_);
+  started_.wait(l, [this]() { return listening_done_; });
+  if (port_ == 0)
+  {
+    l.unlock();
+    stop();
+    return false;
+  }
+  LOG_INF("Local broker listening on port " << port_);
+  return true;
+}
+
+void LocalBroker::stop()
+{
+  if (!container_)
+  {
+    return;
+  }
+  container_->stop();
+  container_thread_->join();
+  container_thread_.reset();
+  container_.reset();
+  nodes_.clear();
+  subscribers_.clear();
+  num_receivers_ = 0;
+  std::lock_guard<std::mutex> l(lock_);
+  port_ = 0;
+}
+
+int LocalBroker::port() const
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return port_;
+}
+
+LocalBrokerStats LocalBroker::stats() const
+{
+  LocalBrokerStats stats;
+  stats.received = received_;
+  stats.delivered = delivered_;
+  stats.expired = expired_;
+  stats.dropped = dropped_;
+  stats.receivers = num_receivers_;
+  return stats;
+}
+
+void LocalBroker::ListenHandler::on_open(proton::listener& l)
+{
+  broker_.listening(l.port());
+}
+
+proton::connection_options LocalBroker::ListenHandler::on_accept(proton::listener& l)
+{
+  proton::connection_options co;
+  co.sasl_allowed_mechs("ANONYMOUS");
+  co.sasl_allow_insecure_mechs(true);
+  return co;
+}
+
+void LocalBroker::ListenHandler::on_error(proton::listener& l, const std::string& what)
+{
+  LOG_ERR("Local broker cannot listen on " << broker_.url_ << ": " << what);
+  broker_.listening(0);
+}
+
+void LocalBroker::listening(int port)
+{
+  std::lock_guard<std::mutex> l(lock_);
+  listening_done_ = true;
+  port_ = port;
+  started_.notify_all();
+}
+
+void LocalBroker::on_container_start(proton::container& cont)
+{
+  cont.listen(url_, listen_handler_);
+  cont.schedule(proton::duration(options_.expiry_interval.count()), [this]() { remove_expired(); });
+}
+
+void LocalBroker::on_sender_open(proton::sender& s)
+{
+  // A client attached a receiver, the broker sends to it
+  const auto address = s.source().address();
+  auto selector = Selector::parse(selector_of(s.source()));
+  s.open(proton::sender_options()
+             .delivery_mode(proton::delivery_mode::AT_MOST_ONCE)
+             .source(proton::source_options().address(address).filters(s.source().filters())));
+  if (!selector)
+  {
+    s.close(proton::error_condition("amqp:invalid-field", "invalid selector"));
+    return;
+  }
+  auto& node = get_node(address);
+  auto subscriber = std::make_shared<Subscriber>();
+  subscriber->sender = s;
+  subscriber->selector = std::move(*selector);
+  subscriber->node = &node;
+  node.subscribers.push_back(subscriber);
+  subscribers_.emplace(s, std::move(subscriber));
+  num_receivers_++;
+  LOG_DEB("Receiver attached to " << address);
+}
+
+void LocalBroker::on_receiver_open(proton::receiver& r)
+{
+  // A client attached a sender, proton grants new credit as messages arrive
+  r.open(proton::receiver_options()
+             .credit_window(static_cast<int>(options_.credit_window))
+             .target(proton::target_options().address(r.target().address())));
+}
+
+void LocalBroker::on_message(proton::delivery& dlv, proton::message& msg)
+{
+  received_++;
+  auto entry = std::make_shared<Entry>();
+  entry->msg = msg;
+  if (msg.ttl().milliseconds() > 0)
+  {
+    entry->expiry = std::chrono::steady_clock::now() + std::chrono::milliseconds(msg.ttl().milliseconds());
+  }
+  auto& node = get_node(dlv.receiver().target().address());
+  if (node.is_queue)
+  {
+    enqueue(node.queue, std::move(entry));
+    drain(node);
+    return;
+  }
+  // topics share the entry between the matching receivers
+  for (const auto& subscriber : node.subscribers)
+  {
+    if (subscriber->selector.matches(msg))
+    {
+      enqueue(subscriber->queue, entry);
+      drain(*subscriber);
+    }
+  }
+}
+
+void LocalBroker::on_sendable(proton::sender& s)
+{
+  auto it = subscribers_.find(s);
+  if (it == subscribers_.end())
+  {
+    return;
+  }
+  if (it->second->node->is_queue)
+  {
+    drain(*it->second->node);
+  }
+  else
+  {
+    drain(*it->second);
+  }
+}
+
+void LocalBroker::on_sender_close(proton::sender& s)
+{
+  remove_subscriber(s);
+}
+
+void LocalBroker::on_connection_close(proton::connection& conn)
+{
+  remove_subscribers(conn);
+}
+
+void LocalBroker::on_transport_close(proton::transport& tp)
+{
+  // the connection may be gone without closing its links
+  remove_subscribers(tp.connection());
+}
+
+LocalBroker::Node& LocalBroker::get_node(const std::string& address)
+{
+  auto it = nodes_.find(address);
+  if (it == nodes_.end())
+  {
+    it = nodes_.emplace(address, Node()).first;
+    it->second.is_queue =
+        std::find(options_.queues.begin(), options_.queues.end(), address) != options_.queues.end();
+  }
+  return it->second;
+}
+
+void LocalBroker::enqueue(std::deque<EntryPtr>& queue, EntryPtr entry)
+{
+  if (queue.size() >= options_.max_depth)
+  {
+    queue.pop_front();
+    dropped_++;
+  }
+  queue.push_back(std::move(entry));
+}
+
+void LocalBroker::drain(Subscriber& subscriber)
+{
+  const auto now = std::chrono::steady_clock::now();
+  while (!subscriber.queue.empty() && subscriber.sender.credit() > 0)
+  {
+    auto entry = std::move(subscriber.queue.front());
+    subscriber.queue.pop_front();
+    if (is_expired(*entry, now))
+    {
+      expired_++;
+      continue;
+    }
+    subscriber.sender.send(entry->msg);
+    delivered_++;
+  }
+}
+
+void LocalBroker::drain(Node& node)
+{
+  // Messages nobody selects stay in the queue, the others go to the next matching receiver with credit
+  const auto now = std::chrono::steady_clock::now();
+  auto& subscribers = node.subscribers;
+  auto has_credit = [](const auto& subscriber) { return subscriber->sender.credit() > 0; };
+  auto it = node.queue.begin();
+  while (it != node.queue.end() && std::any_of(subscribers.begin(), subscribers.end(), has_credit))
+  {
+    if (is_expired(**it, now))
+    {
+      it = node.queue.erase(it);
+      expired_++;
+      continue;
+    }
+    bool sent = false;
+    for (size_t i = 0; i < subscribers.size() && !sent; i++)
+    {
+      const auto index = (node.next_subscriber + i) % subscribers.size();
+      auto& subscriber = *subscribers[index];
+      if (subscriber.sender.credit() > 0 && subscriber.selector.matches((*it)->msg))
+      {
+        subscriber.sender.send((*it)->msg);
+        delivered_++;
+        node.next_subscriber = index + 1;
+        sent = true;
+      }
+    }
+    it = sent ? node.queue.erase(it) : std::next(it);
+  }
+}
+
+bool LocalBroker::is_expired(const Entry& entry, std::chrono::steady_clock::time_point now)
+{
+  return entry.expiry && *entry.expiry < now;
+}
+
+void LocalBroker::remove_expired()
+{
+  // Runs on the container thread, messages are otherwise only checked once they are about to be sent
+  const auto now = std::chrono::steady_clock::now();
+  auto remove = [this, now](std::deque<EntryPtr>& queue) {
+    const auto size = queue.size();
+    queue.erase(std::remove_if(queue.begin(),
+                               queue.end(),
+                               [now](const EntryPtr& entry) { return is_expired(*entry, now); }),
+                queue.end());
+    expired_ += size - queue.size();
+  };
+  for (auto& [address, node] : nodes_)
+  {
+    remove(node.queue);
+    for (auto& subscriber : node.subscribers)
+    {
+      remove(subscriber->queue);
+    }
+  }
+  container_->schedule(proton::duration(options_.expiry_interval.count()), [this]() { remove_expired(); });
+}
+
+void LocalBroker::remove_subscriber(const proton::sender& s)
+{
+  auto it = subscribers_.find(s);
+  if (it == subscribers_.end())
+  {
+    return;
+  }
+  auto& subscribers = it->second->node->subscribers;
+  subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), it->second), subscribers.end());
+  subscribers_.erase(it);
+  num_receivers_--;
+}
+
+void LocalBroker::remove_subscribers(const proton::connection& conn)
+{
+  std::vector<proton::sender> senders;
+  for (const auto& [s, subscriber] : subscribers_)
+  {
+    if (s.connection() == conn)
+    {
+      senders.push_back(s);
+    }
+  }
+  for (const auto& s : senders)
+  {
+    remove_subscriber(s);
+  }
+}
+}  // namespace mrm::v2x_amqp_connector_lib
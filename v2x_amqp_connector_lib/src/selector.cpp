@@ -0,0 +1,554 @@
+#include <v2x_amqp_connector_lib/selector.h>
+#include <aduulm_logger/aduulm_logger.hpp>
+#include <proton/scalar.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+namespace
+{
+bool is_number(const Selector::Value& value)
+{
+  return std::holds_alternative<int64_t>(value) || std::holds_alternative<double>(value);
+}
+
+double to_double(const Selector::Value& value)
+{
+  return std::holds_alternative<int64_t>(value) ? static_cast<double>(std::get<int64_t>(value)) :
+                                                  std::get<double>(value);
+}
+
+Selector::Value to_value(const proton::scalar& scalar)
+{
+  switch (scalar.type())
+  {
+    case proton::BOOLEAN:
+      return proton::get<bool>(scalar);
+    case proton::UBYTE:
+    case proton::BYTE:
+    case proton::USHORT:
+    case proton::SHORT:
+    case proton::UINT:
+    case proton::INT:
+    case proton::ULONG:
+    case proton::LONG:
+      return proton::coerce<int64_t>(scalar);
+    case proton::FLOAT:
+    case proton::DOUBLE:
+      return proton::coerce<double>(scalar);
+    case proton::STRING:
+      return proton::get<std::string>(scalar);
+    case proton::SYMBOL:
+      return std::string(proton::get<proton::symbol>(scalar));
+    default:
+      return {};
+  }
+}
+}  // namespace
+
+// Recursive descent parser building the nodes of a Selector
+class SelectorParser
+{
+public:
+  explicit SelectorParser(std::string_view input) : input_(input)
+  {
+  }
+
+  std::optional<Selector> parse()
+  {
+    Selector selector;
+    skip_space();
+    if (pos_ == input_.size())
+    {
+      return selector;
+    }
+    nodes_ = &selector.nodes_;
+    // children are added before their parents, so the root ends up last
+    const auto root = or_expression();
+    if (root && pos_ != input_.size())
+    {
+      fail("unexpected input");
+    }
+    if (!error_.empty())
+    {
+      LOG_ERR("Invalid selector \"" << input_ << "\": " << error_ << " at position " << error_pos_);
+      return {};
+    }
+    return selector;
+  }
+
+private:
+  using Kind = Selector::Kind;
+  using CompareOp = Selector::CompareOp;
+
+  std::optional<size_t> or_expression()
+  {
+    auto left = and_expression();
+    while (left && keyword("OR"))
+    {
+      const auto right = and_expression();
+      if (!right)
+      {
+        return {};
+      }
+      left = add(Kind::Or, { *left, *right });
+    }
+    return left;
+  }
+
+  std::optional<size_t> and_expression()
+  {
+    auto left = not_expression();
+    while (left && keyword("AND"))
+    {
+      const auto right = not_expression();
+      if (!right)
+      {
+        return {};
+      }
+      left = add(Kind::And, { *left, *right });
+    }
+    return left;
+  }
+
+  std::optional<size_t> not_expression()
+  {
+    if (keyword("NOT"))
+    {
+      const auto child = not_expression();
+      if (!child)
+      {
+        return {};
+      }
+      return add(Kind::Not, { *child });
+    }
+    return predicate();
+  }
+
+  std::optional<size_t> predicate()
+  {
+    if (symbol("("))
+    {
+      const auto inner = or_expression();
+      if (inner && !symbol(")"))
+      {
+        return fail("expected ')'");
+      }
+      return inner;
+    }
+    const auto left = operand();
+    if (!left)
+    {
+      return {};
+    }
+    if (auto op = compare_op())
+    {
+      const auto right = operand();
+      if (!right)
+      {
+        return {};
+      }
+      auto index = add(Kind::Compare, { *left, *right });
+      (*nodes_)[index].op = *op;
+      return index;
+    }
+    if (keyword("IS"))
+    {
+      const bool negated = keyword("NOT");
+      if (!keyword("NULL"))
+      {
+        return fail("expected NULL");
+      }
+      return add(Kind::IsNull, { *left }, negated);
+    }
+    const bool negated = keyword("NOT");
+    if (keyword("IN"))
+    {
+      std::vector<size_t> children = { *left };
+      if (!symbol("("))
+      {
+        return fail("expected '('");
+      }
+      do
+      {
+        const auto item = literal();
+        if (!item)
+        {
+          return {};
+        }
+        children.push_back(*item);
+      } while (symbol(","));
+      if (!symbol(")"))
+      {
+        return fail("expected ')'");
+      }
+      return add(Kind::In, std::move(children), negated);
+    }
+    if (keyword("BETWEEN"))
+    {
+      const auto low = operand();
+      if (!low)
+      {
+        return {};
+      }
+      if (!keyword("AND"))
+      {
+        return fail("expected AND");
+      }
+      const auto high = operand();
+      if (!high)
+      {
+        return {};
+      }
+      return add(Kind::Between, { *left, *low, *high }, negated);
+    }
+    if (negated)
+    {
+      return fail("expected IN or BETWEEN");
+    }
+    // a boolean property or literal on its own
+    return left;
+  }
+
+  std::optional<size_t> operand()
+  {
+    skip_space();
+    const auto start = pos_;
+    const auto name = identifier();
+    if (name.empty() || is_keyword(name, "TRUE") || is_keyword(name, "FALSE"))
+    {
+      pos_ = start;
+      return literal();
+    }
+    if (is_keyword(name, "NOT") || is_keyword(name, "AND") || is_keyword(name, "OR") || is_keyword(name, "NULL"))
+    {
+      pos_ = start;
+      return fail("expected a property or literal");
+    }
+    return add(Kind::Property, {}, false, std::string(name));
+  }
+
+  std::optional<size_t> literal()
+  {
+    skip_space();
+    const auto start = pos_;
+    if (pos_ < input_.size() && input_[pos_] == '\'')
+    {
+      std::string value;
+      pos_++;
+      while (pos_ < input_.size())
+      {
+        // quotes are escaped by doubling them
+        if (input_[pos_] == '\'' && (pos_ + 1 == input_.size() || input_[pos_ + 1] != '\''))
+        {
+          pos_++;
+          return add(Kind::Literal, {}, false, std::move(value));
+        }
+        value += input_[pos_];
+        pos_ += input_[pos_] == '\'' ? 2 : 1;
+      }
+      pos_ = start;
+      return fail("unterminated string");
+    }
+    const auto name = identifier();
+    if (is_keyword(name, "TRUE") || is_keyword(name, "FALSE"))
+    {
+      return add(Kind::Literal, {}, false, is_keyword(name, "TRUE"));
+    }
+    pos_ = start;
+    return number();
+  }
+
+  std::optional<size_t> number()
+  {
+    const auto start = pos_;
+    auto end = pos_;
+    if (end < input_.size() && (input_[end] == '-' || input_[end] == '+'))
+    {
+      end++;
+    }
+    bool is_decimal = false;
+    while (end < input_.size() &&
+           (std::isdigit(static_cast<unsigned char>(input_[end])) || input_[end] == '.' || input_[end] == 'e' ||
+            input_[end] == 'E' ||
+            ((input_[end] == '-' || input_[end] == '+') && (input_[end - 1] == 'e' || input_[end - 1] == 'E'))))
+    {
+      is_decimal = is_decimal || !std::isdigit(static_cast<unsigned char>(input_[end]));
+      end++;
+    }
+    const std::string text(input_.substr(start, end - start));
+    if (!is_decimal)
+    {
+      int64_t value{};
+      const auto* first = text.data() + (!text.empty() && text[0] == '+' ? 1 : 0);
+      const auto result = std::from_chars(first, text.data() + text.size(), value);
+      if (!text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size())
+      {
+        pos_ = end;
+        return add(Kind::Literal, {}, false, value);
+      }
+    }
+    else
+    {
+      char* parsed_end = nullptr;
+      const double value = std::strtod(text.c_str(), &parsed_end);
+      if (parsed_end == text.c_str() + text.size())
+      {
+        pos_ = end;
+        return add(Kind::Literal, {}, false, value);
+      }
+    }
+    return fail("expected a property or literal");
+  }
+
+  std::optional<CompareOp> compare_op()
+  {
+    // two character operators first
+    static const std::pair<const char*, CompareOp> ops[] = {
+      { "<>", CompareOp::NotEqual }, { "!=", CompareOp::NotEqual }, { "<=", CompareOp::LessEqual },
+      { ">=", CompareOp::GreaterEqual }, { "=", CompareOp::Equal }, { "<", CompareOp::Less },
+      { ">", CompareOp::Greater },
+    };
+    for (const auto& [text, op] : ops)
+    {
+      if (symbol(text))
+      {
+        return op;
+      }
+    }
+    return {};
+  }
+
+  std::string_view identifier()
+  {
+    skip_space();
+    const auto start = pos_;
+    auto is_start = [](char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$'; };
+    if (pos_ < input_.size() && is_start(input_[pos_]))
+    {
+      pos_++;
+      while (pos_ < input_.size() &&
+             (is_start(input_[pos_]) || std::isdigit(static_cast<unsigned char>(input_[pos_])) || input_[pos_] == '.'))
+      {
+        pos_++;
+      }
+    }
+    return input_.substr(start, pos_ - start);
+  }
+
+  static bool is_keyword(std::string_view word, std::string_view keyword)
+  {
+    return word.size() == keyword.size() && std::equal(word.begin(), word.end(), keyword.begin(), [](char a, char b) {
+             return std::toupper(static_cast<unsigned char>(a)) == b;
+           });
+  }
+
+  // Consumes the keyword if it comes next
+  bool keyword(std::string_view keyword)
+  {
+    const auto start = pos_;
+    if (is_keyword(identifier(), keyword))
+    {
+      return true;
+    }
+    pos_ = start;
+    return false;
+  }
+
+  // Consumes the symbol if it comes next
+  bool symbol(std::string_view symbol)
+  {
+    skip_space();
+    if (input_.substr(pos_, symbol.size()) == symbol)
+    {
+      pos_ += symbol.size();
+      return true;
+    }
+    return false;
+  }
+
+  void skip_space()
+  {
+    while (pos_ < input_.size() && std::isspace(static_cast<unsigned char>(input_[pos_])))
+    {
+      pos_++;
+    }
+  }
+
+  size_t add(Kind kind, std::vector<size_t> children, bool negated = false, Selector::Value value = {})
+  {
+    Selector::Node node;
+    node.kind = kind;
+    node.negated = negated;
+    node.value = std::move(value);
+    node.children = std::move(children);
+    nodes_->push_back(std::move(node));
+    return nodes_->size() - 1;
+  }
+
+  std::nullopt_t fail(const char* error)
+  {
+    // keep the first error, the callers only unwind
+    if (error_.empty())
+    {
+      error_ = error;
+      error_pos_ = pos_;
+    }
+    return std::nullopt;
+  }
+
+  const std::string_view input_;
+  size_t pos_ = 0;
+  std::vector<Selector::Node>* nodes_ = nullptr;
+  std::string error_;
+  size_t error_pos_ = 0;
+};
+
+std::optional<Selector> Selector::parse(std::string_view selector)
+{
+  return SelectorParser(selector).parse();
+}
+
+bool Selector::matches(const proton::message& msg) const
+{
+  if (nodes_.empty())
+  {
+    return true;
+  }
+  const auto& properties = msg.properties();
+  return matches([&properties](const std::string& name) { return to_value(properties.get(name)); });
+}
+
+bool Selector::matches(const PropertyLookup& lookup) const
+{
+  return nodes_.empty() || condition(nodes_.size() - 1, lookup).value_or(false);
+}
+
+bool Selector::empty() const
+{
+  return nodes_.empty();
+}
+
+std::optional<bool> Selector::condition(size_t index, const PropertyLookup& lookup) const
+{
+  const auto& node = nodes_[index];
+  switch (node.kind)
+  {
+    case Kind::Literal:
+    case Kind::Property: {
+      const auto value = operand(index, lookup);
+      if (std::holds_alternative<bool>(value))
+      {
+        return std::get<bool>(value);
+      }
+      return {};
+    }
+    case Kind::Not: {
+      const auto child = condition(node.children[0], lookup);
+      return child ? std::optional<bool>(!*child) : std::nullopt;
+    }
+    case Kind::And:
+    case Kind::Or: {
+      // three-valued logic: false AND unknown is false, true OR unknown is true
+      const bool is_and = node.kind == Kind::And;
+      const auto left = condition(node.children[0], lookup);
+      if (left == !is_and)
+      {
+        return left;
+      }
+      const auto right = condition(node.children[1], lookup);
+      if (right == !is_and)
+      {
+        return right;
+      }
+      return left && right ? std::optional<bool>(is_and) : std::nullopt;
+    }
+    case Kind::Compare:
+      return compare(operand(node.children[0], lookup), operand(node.children[1], lookup), node.op);
+    case Kind::In: {
+      const auto value = operand(node.children[0], lookup);
+      if (std::holds_alternative<std::monostate>(value))
+      {
+        return {};
+      }
+      const bool found =
+          std::any_of(node.children.begin() + 1, node.children.end(), [&](size_t item) {
+            return compare(value, nodes_[item].value, CompareOp::Equal).value_or(false);
+          });
+      return found != node.negated;
+    }
+    case Kind::Between: {
+      const auto value = operand(node.children[0], lookup);
+      const auto low = compare(value, operand(node.children[1], lookup), CompareOp::GreaterEqual);
+      const auto high = compare(value, operand(node.children[2], lookup), CompareOp::LessEqual);
+      if (!low || !high)
+      {
+        return {};
+      }
+      return (*low && *high) != node.negated;
+    }
+    case Kind::IsNull:
+      return std::holds_alternative<std::monostate>(operand(node.children[0], lookup)) != node.negated;
+  }
+  return {};
+}
+
+Selector::Value Selector::operand(size_t index, const PropertyLookup& lookup) const
+{
+  const auto& node = nodes_[index];
+  if (node.kind == Kind::Property)
+  {
+    return lookup(std::get<std::string>(node.value));
+  }
+  return node.value;
+}
+
+std::optional<bool> Selector::compare(const Value& a, const Value& b, CompareOp op)
+{
+  if (std::holds_alternative<std::monostate>(a) || std::holds_alternative<std::monostate>(b))
+  {
+    return {};
+  }
+  auto apply = [op](const auto& x, const auto& y) {
+    switch (op)
+    {
+      case CompareOp::Equal:
+        return x == y;
+      case CompareOp::NotEqual:
+        return x != y;
+      case CompareOp::Less:
+        return x < y;
+      case CompareOp::LessEqual:
+        return x <= y;
+      case CompareOp::Greater:
+        return x > y;
+      case CompareOp::GreaterEqual:
+        return x >= y;
+    }
+    return false;
+  };
+  if (std::holds_alternative<int64_t>(a) && std::holds_alternative<int64_t>(b))
+  {
+    return apply(std::get<int64_t>(a), std::get<int64_t>(b));
+  }
+  if (is_number(a) && is_number(b))
+  {
+    return apply(to_double(a), to_double(b));
+  }
+  if (std::holds_alternative<std::string>(a) && std::holds_alternative<std::string>(b))
+  {
+    return apply(std::get<std::string>(a), std::get<std::string>(b));
+  }
+  if (std::holds_alternative<bool>(a) && std::holds_alternative<bool>(b) &&
+      (op == CompareOp::Equal || op == CompareOp::NotEqual))
+  {
+    return apply(std::get<bool>(a), std::get<bool>(b));
+  }
+  // different types never match
+  return false;
+}
+}  // namespace mrm::v2x_amqp_connector_lib
@@ -5,6 +5,8 @@
 #include <proton/reconnect_options.hpp>
 #include <proton/codec/encoder.hpp>
 #include <proton/source.hpp>
+#include <algorithm>
+#include <iterator>
 #include <thread>
 
 namespace mrm::v2x_amqp_connector_lib
@@ -14,13 +16,17 @@ AMQPClient::AMQPClient(std::string url,
                        std::string address_tx,
                        std::string user,
                        std::string pw,
-                       std::string filter_query)
+                       std::string filter_query,
+                       uint32_t credit_window,
+                       bool adaptive_credit)
   : url_(std::move(url))
   , address_rx_(std::move(address_rx))
   , address_tx_(std::move(address_tx))
   , user_(std::move(user))
   , pw_(std::move(pw))
   , filter_query_(std::move(filter_query))
+  , credit_window_(std::max<uint32_t>(credit_window, 1))
+  , adaptive_credit_(adaptive_credit)
 {
   LOG_DEB("AMQPClient initialized");
   container_thread_ = std::make_shared<std::thread>([&]() {
@@ -32,9 +38,16 @@ AMQPClient::AMQPClient(std::string url,
       LOG_INF("Container stopped.");
       closing_connection_ = false;
       sender_connected_ = false;
-      sender_.reset();
-      connection_.reset();
-      work_queue_ = nullptr;
+      {
+        std::lock_guard<std::mutex> l(lock_);
+        sender_.reset();
+        receiver_.reset();
+        connection_.reset();
+        work_queue_ = nullptr;
+        receiver_work_queue_ = nullptr;
+      }
+      credit_update_pending_ = false;
+      discard_send_lanes();
       using namespace std::chrono_literals;
       std::this_thread::sleep_for(200ms);
     }
@@ -43,33 +56,95 @@ AMQPClient::AMQPClient(std::string url,
 
 AMQPClient::~AMQPClient()
 {
-  closing_ = true;
-  close_connection();
+  close();
   container_->stop();
   container_thread_->join();
   container_.reset();
   container_thread_.reset();
 }
 
-bool AMQPClient::send(const proton::message& msg)
+void AMQPClient::set_send_lanes(size_t num_lanes, LaneScheduling scheduling, std::vector<uint32_t> weights)
+{
+  std::lock_guard<std::mutex> l(send_lock_);
+  num_lanes = std::max<size_t>(num_lanes, 1);
+  // messages of removed lanes move to the new last lane
+  for (size_t i = num_lanes; i < send_lanes_.size(); i++)
+  {
+    auto& queue = send_lanes_[num_lanes - 1].queue;
+    std::move(send_lanes_[i].queue.begin(), send_lanes_[i].queue.end(), std::back_inserter(queue));
+  }
+  send_lanes_.resize(num_lanes);
+  for (size_t i = 0; i < num_lanes; i++)
+  {
+    send_lanes_[i].weight = i < weights.size() ? std::max<uint32_t>(weights[i], 1) : 1;
+    send_lanes_[i].round_credit = 0;
+  }
+  scheduling_ = scheduling;
+  current_lane_ = 0;
+}
+
+bool AMQPClient::send(const proton::message& msg,
+                      size_t lane,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
+                      SettleCallback on_settled)
 {
   if (!sender_connected_)
   {
     LOG_WARN_THROTTLE(5., "sender not connected");
     return false;
   }
-  // Use [=] to copy the message, we cannot pass it by reference since it
-  // will be used in another thread.
-  work_queue()->add([=]() {
-    if (!sender_)
+  {
+    std::lock_guard<std::mutex> l(send_lock_);
+    auto& send_lane = send_lanes_[std::min(lane, send_lanes_.size() - 1)];
+    send_lane.queue.push_back({ msg, deadline, std::move(on_settled) });
+    send_lane.stats.max_queue_depth = std::max(send_lane.stats.max_queue_depth, send_lane.queue.size());
+  }
+  // one pending drain sends all queued messages, so there is no need to add one per message
+  if (!drain_pending_.exchange(true))
+  {
+    work_queue()->add([this]() { drain_send_lanes(); });
+  }
+  return true;
+}
+
+size_t AMQPClient::send(std::vector<OutgoingMessage> msgs)
+{
+  if (!sender_connected_)
+  {
+    LOG_WARN_THROTTLE(5., "sender not connected");
+    return 0;
+  }
+  if (msgs.empty())
+  {
+    return 0;
+  }
+  {
+    std::lock_guard<std::mutex> l(send_lock_);
+    for (auto& msg : msgs)
     {
-      LOG_DEB("sender not yet created");
-      return;
+      auto& send_lane = send_lanes_[std::min(msg.lane, send_lanes_.size() - 1)];
+      send_lane.queue.push_back({ std::move(msg.msg), msg.deadline, std::move(msg.on_settled) });
+      send_lane.stats.max_queue_depth = std::max(send_lane.stats.max_queue_depth, send_lane.queue.size());
     }
-    LOG_DEB("sending message");
-    sender_->send(msg);
-  });
-  return true;
+  }
+  if (!drain_pending_.exchange(true))
+  {
+    work_queue()->add([this]() { drain_send_lanes(); });
+  }
+  return msgs.size();
+}
+
+std::vector<SendLaneStats> AMQPClient::send_lane_stats() const
+{
+  std::lock_guard<std::mutex> l(send_lock_);
+  std::vector<SendLaneStats> stats;
+  stats.reserve(send_lanes_.size());
+  for (const auto& lane : send_lanes_)
+  {
+    stats.push_back(lane.stats);
+    stats.back().queue_depth = lane.queue.size();
+  }
+  return stats;
 }
 
 std::optional<proton::message> AMQPClient::receive()
@@ -85,9 +160,43 @@ std::optional<proton::message> AMQPClient::receive()
   }
   auto msg = std::move(messages_.front());
   messages_.pop();
+  // Grant new credit in batches of half the window to keep the number of flow frames low
+  if (adaptive_credit_ && receiver_work_queue_ != nullptr && messages_.size() <= credit_window_ / 2 &&
+      !credit_update_pending_.exchange(true))
+  {
+    receiver_work_queue_->add([this]() { update_credit(); });
+  }
   return { msg };
 }
 
+void AMQPClient::set_filter_query(std::string filter_query)
+{
+  proton::work_queue* work_queue = nullptr;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    filter_query_ = std::move(filter_query);
+    work_queue = receiver_work_queue_;
+  }
+  // without a receiver, the new selector is used once it is attached in on_connection_open()
+  if (work_queue != nullptr)
+  {
+    work_queue->add([this]() { update_receiver_filter(); });
+  }
+}
+
+void AMQPClient::close()
+{
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    if (closing_)
+    {
+      return;
+    }
+    closing_ = true;
+  }
+  close_connection();
+}
+
 void AMQPClient::close_connection()
 {
   LOG_INF("Closing connection");
@@ -150,21 +259,7 @@ void AMQPClient::on_connection_open(proton::connection& conn)
   }
   if (!address_rx_.empty())
   {
-    auto options = proton::source_options();
-    if (!filter_query_.empty())
-    {
-      proton::source::filter_map filters;
-      proton::symbol key("selector");
-      proton::value res;
-      proton::codec::encoder encoder{ res };
-      encoder << proton::codec::start(proton::DESCRIBED, proton::NULL_TYPE, true)
-              << proton::symbol("apache.org:selector-filter:string") << proton::value(filter_query_)
-              << proton::codec::finish();
-      filters.put(key, res);
-      options = options.filters(filters);
-    }
-    auto opts = proton::receiver_options().source(options);
-    conn.open_receiver(address_rx_, opts);
+    open_receiver(conn);
   }
   LOG_DEB("on_connection_open done");
 }
@@ -179,6 +274,49 @@ void AMQPClient::on_sender_open(proton::sender& s)
   LOG_DEB("on_sender_open done");
   sender_ready_.notify_all();
 }
+void AMQPClient::on_sendable(proton::sender& s)
+{
+  drain_send_lanes();
+}
+void AMQPClient::on_tracker_accept(proton::tracker& t)
+{
+  settle(t, true);
+}
+void AMQPClient::on_tracker_reject(proton::tracker& t)
+{
+  settle(t, false);
+}
+void AMQPClient::on_tracker_release(proton::tracker& t)
+{
+  settle(t, false);
+}
+void AMQPClient::on_tracker_settle(proton::tracker& t)
+{
+  // any other outcome, accepted, rejected and released messages have been settled before
+  settle(t, false);
+}
+void AMQPClient::on_receiver_open(proton::receiver& r)
+{
+  LOG_DEB("on_receiver_open");
+  bool update_filter = false;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    receiver_ = r;
+    receiver_work_queue_ = &r.work_queue();
+    // set_filter_query() was called while the receiver was being attached
+    update_filter = filter_query_ != receiver_filter_query_;
+  }
+  if (update_filter)
+  {
+    update_receiver_filter();
+    return;
+  }
+  if (adaptive_credit_)
+  {
+    update_credit();
+  }
+  LOG_DEB("on_receiver_open done");
+}
 void AMQPClient::on_message(proton::delivery& dlv, proton::message& msg)
 {
   std::lock_guard<std::mutex> l(lock_);
@@ -199,6 +337,230 @@ void AMQPClient::open_senders()
   connection_->open_sender(address_tx_);
 }
 
+void AMQPClient::open_receiver(proton::connection& conn)
+{
+  auto options = proton::source_options();
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    receiver_filter_query_ = filter_query_;
+  }
+  const auto& filter_query = receiver_filter_query_;
+  if (!filter_query.empty())
+  {
+    proton::source::filter_map filters;
+    proton::symbol key("selector");
+    proton::value res;
+    proton::codec::encoder encoder{ res };
+    encoder << proton::codec::start(proton::DESCRIBED, proton::NULL_TYPE, true)
+            << proton::symbol("apache.org:selector-filter:string") << proton::value(filter_query)
+            << proton::codec::finish();
+    filters.put(key, res);
+    options = options.filters(filters);
+  }
+  // A credit window of 0 disables automatic credit management by proton
+  auto opts = proton::receiver_options().source(options).credit_window(adaptive_credit_ ? 0 : credit_window_);
+  conn.open_receiver(address_rx_, opts);
+}
+
+void AMQPClient::update_receiver_filter()
+{
+  // Runs on the container thread
+  std::optional<proton::receiver> receiver;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    // if the receiver is being attached, on_receiver_open() checks whether its selector is outdated
+    if (!receiver_ || receiver_filter_query_ == filter_query_)
+    {
+      return;
+    }
+    receiver.swap(receiver_);
+  }
+  LOG_INF("Re-attaching receiver with new selector");
+  auto conn = receiver->connection();
+  receiver->close();
+  open_receiver(conn);
+}
+
+void AMQPClient::drain_send_lanes()
+{
+  // Runs on the container thread
+  drain_pending_ = false;
+  if (!sender_)
+  {
+    LOG_DEB("sender not yet created");
+    return;
+  }
+  // Messages stay in the lanes while the broker grants no credit, where they can still be overtaken by more important
+  // ones. on_sendable() continues once there is credit again.
+  std::vector<SettleCallback> expired;
+  remove_expired(std::chrono::steady_clock::now(), expired);
+  while (sender_->credit() > 0)
+  {
+    auto msg = next_message();
+    if (!msg)
+    {
+      break;
+    }
+    LOG_DEB("sending message");
+    auto tracker = sender_->send(msg->msg);
+    if (msg->on_settled)
+    {
+      std::lock_guard<std::mutex> l(send_lock_);
+      unsettled_.emplace(std::move(tracker), std::move(msg->on_settled));
+    }
+  }
+  for (auto& on_settled : expired)
+  {
+    on_settled(false);
+  }
+}
+
+void AMQPClient::remove_expired(std::chrono::steady_clock::time_point now, std::vector<SettleCallback>& expired)
+{
+  // Deadlines are given per message, so an expired message may be queued behind one that is still valid
+  auto is_expired = [now](const QueuedMessage& msg) { return msg.deadline && *msg.deadline < now; };
+  std::lock_guard<std::mutex> l(send_lock_);
+  for (auto& lane : send_lanes_)
+  {
+    auto& queue = lane.queue;
+    auto kept = std::find_if(queue.begin(), queue.end(), is_expired);
+    for (auto it = kept; it != queue.end(); ++it)
+    {
+      if (!is_expired(*it))
+      {
+        *kept++ = std::move(*it);
+        continue;
+      }
+      if (it->on_settled)
+      {
+        expired.push_back(std::move(it->on_settled));
+      }
+      lane.stats.expired++;
+    }
+    queue.erase(kept, queue.end());
+  }
+}
+
+std::optional<AMQPClient::QueuedMessage> AMQPClient::next_message()
+{
+  std::lock_guard<std::mutex> l(send_lock_);
+  SendLane* next = nullptr;
+  if (scheduling_ == LaneScheduling::StrictPriority)
+  {
+    for (auto& lane : send_lanes_)
+    {
+      if (!lane.queue.empty())
+      {
+        next = &lane;
+        break;
+      }
+    }
+  }
+  else
+  {
+    // Stays at a lane until it is empty or has used up its weight for this round. Refilling every lane on the way
+    // takes at most one pass, after which any non-empty lane has credit.
+    for (size_t i = 0; i <= 2 * send_lanes_.size() && next == nullptr; i++)
+    {
+      auto& lane = send_lanes_[current_lane_];
+      if (!lane.queue.empty() && lane.round_credit > 0)
+      {
+        lane.round_credit--;
+        next = &lane;
+      }
+      else
+      {
+        lane.round_credit = lane.weight;
+        current_lane_ = (current_lane_ + 1) % send_lanes_.size();
+      }
+    }
+  }
+  if (next == nullptr)
+  {
+    return {};
+  }
+  auto msg = std::move(next->queue.front());
+  next->queue.pop_front();
+  next->stats.sent++;
+  return msg;
+}
+
+void AMQPClient::discard_send_lanes()
+{
+  std::vector<SettleCallback> discarded;
+  {
+    std::lock_guard<std::mutex> l(send_lock_);
+    for (auto& lane : send_lanes_)
+    {
+      lane.stats.discarded += lane.queue.size();
+      for (auto& msg : lane.queue)
+      {
+        if (msg.on_settled)
+        {
+          discarded.push_back(std::move(msg.on_settled));
+        }
+      }
+      lane.queue.clear();
+      lane.round_credit = 0;
+    }
+    // the outcome of messages sent on the lost connection is unknown
+    for (auto& [tracker, on_settled] : unsettled_)
+    {
+      discarded.push_back(std::move(on_settled));
+    }
+    unsettled_.clear();
+    current_lane_ = 0;
+    drain_pending_ = false;
+  }
+  for (auto& on_settled : discarded)
+  {
+    on_settled(false);
+  }
+}
+
+void AMQPClient::settle(const proton::tracker& tracker, bool accepted)
+{
+  SettleCallback on_settled;
+  {
+    std::lock_guard<std::mutex> l(send_lock_);
+    auto it = unsettled_.find(tracker);
+    if (it == unsettled_.end())
+    {
+      return;
+    }
+    on_settled = std::move(it->second);
+    unsettled_.erase(it);
+  }
+  on_settled(accepted);
+}
+
+void AMQPClient::update_credit()
+{
+  // Runs on the container thread. Tops up the credit such that queued messages and outstanding
+  // credit together do not exceed the credit window.
+  credit_update_pending_ = false;
+  size_t queued = 0;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    if (!receiver_)
+    {
+      return;
+    }
+    queued = messages_.size();
+  }
+  if (queued >= credit_window_)
+  {
+    return;
+  }
+  const auto target = static_cast<int>(credit_window_ - queued);
+  const auto credit = receiver_->credit();
+  if (target > credit)
+  {
+    LOG_DEB("adding " << target - credit << " credit (" << queued << " messages queued)");
+    receiver_->add_credit(target - credit);
+  }
+}
+
 void AMQPClient::on_error(const proton::error_condition& e)
 {
   LOG_ERR("unexpected error: " << e);
@@ -0,0 +1,223 @@
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <v2x_amqp_connector_lib/v2x_amqp_connector_lib.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+using namespace std::chrono_literals;
+using test::brokerUrl;
+using test::makeMessage;
+using test::receiveStationIds;
+using test::receiveStationIdsUntil;
+using test::waitFor;
+
+namespace
+{
+struct SettleCounter
+{
+  AMQPClient::SettleCallback callback()
+  {
+    return [this](bool accepted) { (accepted ? num_accepted : num_failed)++; };
+  }
+
+  std::atomic<int> num_accepted = 0;
+  std::atomic<int> num_failed = 0;
+};
+
+AMQPClient::OutgoingMessage outgoing(uint32_t station_id, size_t lane)
+{
+  AMQPClient::OutgoingMessage msg;
+  msg.msg = makeMessage(station_id);
+  msg.lane = lane;
+  return msg;
+}
+
+// Sends the messages at once, so that the order in which they arrive only depends on the scheduling of the lanes
+std::vector<uint32_t> sendThroughLanes(AMQPClient& sender,
+                                       AMQPClient& receiver,
+                                       std::vector<AMQPClient::OutgoingMessage> msgs)
+{
+  const auto num = msgs.size();
+  EXPECT_EQ(sender.send(std::move(msgs)), num);
+  return receiveStationIds(receiver, num);
+}
+}  // namespace
+
+TEST(AMQPClientTests, reportsAcceptedMessages)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  AMQPClient sender(brokerUrl(broker), "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return sender.is_sender_connected(); }));
+
+  SettleCounter counter;
+  for (uint32_t station_id = 1; station_id <= 3; station_id++)
+  {
+    ASSERT_TRUE(sender.send(makeMessage(station_id), 0, {}, counter.callback()));
+  }
+  // the broker accepts messages even if nobody receives them
+  ASSERT_TRUE(waitFor([&]() { return counter.num_accepted == 3; }));
+  ASSERT_EQ(counter.num_failed, 0);
+  ASSERT_EQ(broker.stats().received, 3);
+}
+
+TEST(AMQPClientTests, discardsQueuedMessagesOnDisconnect)
+{
+  // a broker granting no credit, so that the messages stay in the send lanes
+  LocalBrokerOptions options;
+  options.credit_window = 0;
+  LocalBroker broker(options);
+  ASSERT_TRUE(broker.start());
+  AMQPClient sender(brokerUrl(broker), "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return sender.is_sender_connected(); }));
+
+  SettleCounter counter;
+  for (uint32_t station_id = 1; station_id <= 3; station_id++)
+  {
+    ASSERT_TRUE(sender.send(makeMessage(station_id), 0, {}, counter.callback()));
+  }
+  ASSERT_EQ(sender.send_lane_stats()[0].queue_depth, 3);
+
+  broker.stop();
+  ASSERT_TRUE(waitFor([&]() { return counter.num_failed == 3; }));
+  std::this_thread::sleep_for(50ms);
+  ASSERT_EQ(counter.num_failed, 3);
+  ASSERT_EQ(counter.num_accepted, 0);
+  const auto stats = sender.send_lane_stats()[0];
+  ASSERT_EQ(stats.queue_depth, 0);
+  ASSERT_EQ(stats.discarded, 3);
+  ASSERT_EQ(stats.sent, 0);
+}
+
+TEST(AMQPClientTests, reattachesReceiverWithNewSelector)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  AMQPClient receiver(url, "etsi", "", "anonymous", "", "station_id = 1");
+  AMQPClient sender(url, "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }));
+
+  ASSERT_TRUE(sender.send(makeMessage(2)));
+  ASSERT_TRUE(sender.send(makeMessage(1)));
+  ASSERT_EQ(receiveStationIds(receiver, 1), std::vector<uint32_t>({ 1 }));
+
+  // messages arriving while the receiver is re-attached are not received, so keep sending until the new selector
+  // has taken effect
+  receiver.set_filter_query("station_id >= 2");
+  std::atomic<bool> done = false;
+  std::thread resend([&]() {
+    while (!done)
+    {
+      sender.send(makeMessage(2));
+      std::this_thread::sleep_for(10ms);
+    }
+  });
+  const auto station_ids = receiveStationIdsUntil(receiver, [](uint32_t station_id) { return station_id == 2; });
+  done = true;
+  resend.join();
+  ASSERT_EQ(station_ids, std::vector<uint32_t>({ 2 }));
+  ASSERT_EQ(broker.stats().receivers, 1);
+
+  // the old selector is gone, messages still in flight from above may arrive before
+  ASSERT_TRUE(sender.send(makeMessage(1)));
+  ASSERT_TRUE(sender.send(makeMessage(3)));
+  const auto rest = receiveStationIdsUntil(receiver, [](uint32_t station_id) { return station_id == 3; });
+  ASSERT_FALSE(rest.empty());
+  ASSERT_EQ(rest.back(), 3);
+  ASSERT_EQ(std::count(rest.begin(), rest.end(), 1), 0);
+}
+
+TEST(AMQPClientTests, drainsLanesInStrictPriority)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  AMQPClient receiver(url, "etsi", "", "anonymous", "");
+  AMQPClient sender(url, "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }));
+  sender.set_send_lanes(2);
+
+  ASSERT_EQ(sendThroughLanes(sender, receiver, { outgoing(11, 1), outgoing(12, 1), outgoing(1, 0), outgoing(2, 0) }),
+            std::vector<uint32_t>({ 1, 2, 11, 12 }));
+  // out of range lanes are mapped to the last one
+  ASSERT_EQ(sendThroughLanes(sender, receiver, { outgoing(21, 5), outgoing(3, 0) }), std::vector<uint32_t>({ 3, 21 }));
+
+  const auto stats = sender.send_lane_stats();
+  ASSERT_EQ(stats.size(), 2);
+  ASSERT_EQ(stats[0].sent, 3);
+  ASSERT_EQ(stats[0].max_queue_depth, 2);
+  ASSERT_EQ(stats[1].sent, 3);
+  ASSERT_EQ(stats[1].max_queue_depth, 2);
+  for (const auto& lane : stats)
+  {
+    ASSERT_EQ(lane.queue_depth, 0);
+    ASSERT_EQ(lane.expired, 0);
+    ASSERT_EQ(lane.discarded, 0);
+  }
+}
+
+TEST(AMQPClientTests, drainsLanesWeighted)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  AMQPClient receiver(url, "etsi", "", "anonymous", "");
+  AMQPClient sender(url, "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }));
+  sender.set_send_lanes(2, LaneScheduling::Weighted, { 2, 1 });
+
+  // two messages of lane 0 per message of lane 1, as long as both have messages
+  ASSERT_EQ(sendThroughLanes(sender,
+                             receiver,
+                             { outgoing(11, 1),
+                               outgoing(12, 1),
+                               outgoing(13, 1),
+                               outgoing(14, 1),
+                               outgoing(1, 0),
+                               outgoing(2, 0),
+                               outgoing(3, 0),
+                               outgoing(4, 0) }),
+            std::vector<uint32_t>({ 1, 2, 11, 3, 4, 12, 13, 14 }));
+  const auto stats = sender.send_lane_stats();
+  ASSERT_EQ(stats[0].sent, 4);
+  ASSERT_EQ(stats[1].sent, 4);
+}
+
+TEST(AMQPClientTests, dropsExpiredMessages)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  AMQPClient receiver(url, "etsi", "", "anonymous", "");
+  AMQPClient sender(url, "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }));
+  sender.set_send_lanes(2);
+
+  // expired messages are dropped anywhere in their lane, also behind messages which are still valid
+  SettleCounter counter;
+  const auto past = std::chrono::steady_clock::now() - 1s;
+  std::vector<AMQPClient::OutgoingMessage> msgs = { outgoing(1, 0), outgoing(2, 0), outgoing(3, 0), outgoing(11, 1) };
+  msgs[0].deadline = std::chrono::steady_clock::now() + 10s;
+  msgs[1].deadline = past;
+  msgs[1].on_settled = counter.callback();
+  msgs[3].deadline = past;
+  ASSERT_EQ(sender.send(std::move(msgs)), 4);
+  ASSERT_EQ(receiveStationIds(receiver, 2), std::vector<uint32_t>({ 1, 3 }));
+  ASSERT_TRUE(waitFor([&]() { return counter.num_failed == 1; }));
+  ASSERT_EQ(counter.num_accepted, 0);
+
+  const auto stats = sender.send_lane_stats();
+  ASSERT_EQ(stats[0].sent, 2);
+  ASSERT_EQ(stats[0].expired, 1);
+  ASSERT_EQ(stats[0].max_queue_depth, 3);
+  ASSERT_EQ(stats[1].sent, 0);
+  ASSERT_EQ(stats[1].expired, 1);
+  ASSERT_EQ(stats[1].queue_depth, 0);
+}
+}  // namespace mrm::v2x_amqp_connector_lib
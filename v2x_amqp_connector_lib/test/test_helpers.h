@@ -0,0 +1,88 @@
+#ifndef V2X_AMQP_CONNECTOR_LIB_TEST_TEST_HELPERS_H_
+#define V2X_AMQP_CONNECTOR_LIB_TEST_TEST_HELPERS_H_
+
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <v2x_amqp_connector_lib/v2x_amqp_connector_lib.h>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helpers shared by the tests running against a LocalBroker
+namespace mrm::v2x_amqp_connector_lib::test
+{
+using namespace std::chrono_literals;
+
+inline std::string brokerUrl(const LocalBroker& broker)
+{
+  return "127.0.0.1:" + std::to_string(broker.port());
+}
+
+inline bool waitFor(const std::function<bool()>& condition, std::chrono::milliseconds timeout = 5s)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!condition())
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+inline proton::message makeMessage(uint32_t station_id, proton::duration ttl = proton::duration(0))
+{
+  proton::message msg;
+  msg.properties().put("mid", static_cast<uint16_t>(2050));
+  msg.properties().put("station_id", station_id);
+  msg.ttl(ttl);
+  return msg;
+}
+
+inline uint32_t stationId(const proton::message& msg)
+{
+  return proton::get<uint32_t>(msg.properties().get("station_id"));
+}
+
+// Station IDs of the received messages until done returns true for one of them, closes the client if that does not
+// happen in time
+inline std::vector<uint32_t> receiveStationIdsUntil(AMQPClient& client, const std::function<bool(uint32_t)>& done)
+{
+  auto received = std::async(std::launch::async, [&]() {
+    std::vector<uint32_t> station_ids;
+    while (station_ids.empty() || !done(station_ids.back()))
+    {
+      auto msg = client.receive();
+      if (!msg)
+      {
+        break;
+      }
+      station_ids.push_back(stationId(*msg));
+    }
+    return station_ids;
+  });
+  if (received.wait_for(5s) != std::future_status::ready)
+  {
+    client.close();
+  }
+  return received.get();
+}
+
+// Station IDs of the next num messages
+inline std::vector<uint32_t> receiveStationIds(AMQPClient& client, size_t num)
+{
+  if (num == 0)
+  {
+    return {};
+  }
+  size_t num_received = 0;
+  return receiveStationIdsUntil(client, [&](uint32_t /*station_id*/) { return ++num_received == num; });
+}
+}  // namespace mrm::v2x_amqp_connector_lib::test
+
+#endif /* V2X_AMQP_CONNECTOR_LIB_TEST_TEST_HELPERS_H_ */
@@ -0,0 +1,104 @@
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <v2x_amqp_connector_lib/v2x_amqp_connector_lib.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+
+#include <thread>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+using namespace std::chrono_literals;
+using test::brokerUrl;
+using test::makeMessage;
+using test::receiveStationIds;
+using test::waitFor;
+
+TEST(LocalBrokerTests, deliversSelectedMessagesOfTopics)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  AMQPClient selective(url, "etsi", "", "anonymous", "", "station_id = 2 OR station_id = 3");
+  AMQPClient all(url, "etsi", "", "anonymous", "");
+  AMQPClient sender(url, "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 2 && sender.is_sender_connected(); }));
+
+  for (uint32_t station_id = 1; station_id <= 4; station_id++)
+  {
+    ASSERT_TRUE(sender.send(makeMessage(station_id)));
+  }
+  ASSERT_EQ(receiveStationIds(selective, 2), std::vector<uint32_t>({ 2, 3 }));
+  ASSERT_EQ(receiveStationIds(all, 4), std::vector<uint32_t>({ 1, 2, 3, 4 }));
+  ASSERT_EQ(broker.stats().received, 4);
+  ASSERT_EQ(broker.stats().delivered, 6);
+}
+
+TEST(LocalBrokerTests, expiresQueuedMessages)
+{
+  LocalBrokerOptions options;
+  options.queues = { "queue" };
+  LocalBroker broker(options);
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  AMQPClient sender(url, "", "queue", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return sender.is_sender_connected(); }));
+
+  // queues keep messages until a receiver attaches, unless they expire before
+  ASSERT_TRUE(sender.send(makeMessage(1, proton::duration(1))));
+  ASSERT_TRUE(sender.send(makeMessage(2)));
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().received == 2; }));
+  std::this_thread::sleep_for(10ms);
+
+  AMQPClient receiver(url, "queue", "", "anonymous", "");
+  ASSERT_EQ(receiveStationIds(receiver, 1), std::vector<uint32_t>({ 2 }));
+  ASSERT_EQ(broker.stats().expired, 1);
+}
+
+TEST(LocalBrokerTests, distributesQueueRoundRobin)
+{
+  LocalBrokerOptions options;
+  options.queues = { "queue" };
+  LocalBroker broker(options);
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  // attached one after the other, so that the first one is the first in round robin order
+  AMQPClient first(url, "queue", "", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1; }));
+  AMQPClient second(url, "queue", "", "anonymous", "");
+  AMQPClient sender(url, "", "queue", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 2 && sender.is_sender_connected(); }));
+
+  for (uint32_t station_id = 1; station_id <= 6; station_id++)
+  {
+    ASSERT_TRUE(sender.send(makeMessage(station_id)));
+  }
+  ASSERT_EQ(receiveStationIds(first, 3), std::vector<uint32_t>({ 1, 3, 5 }));
+  ASSERT_EQ(receiveStationIds(second, 3), std::vector<uint32_t>({ 2, 4, 6 }));
+  ASSERT_EQ(broker.stats().delivered, 6);
+}
+
+TEST(LocalBrokerTests, sendsWithinCreditOfReceivers)
+{
+  LocalBrokerOptions options;
+  options.queues = { "queue" };
+  LocalBroker broker(options);
+  ASSERT_TRUE(broker.start());
+  const auto url = brokerUrl(broker);
+  // with adaptive credit, the receiver only grants credit for free slots of its receive queue
+  AMQPClient receiver(url, "queue", "", "anonymous", "", "", 2, true);
+  AMQPClient sender(url, "", "queue", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }));
+
+  for (uint32_t station_id = 1; station_id <= 5; station_id++)
+  {
+    ASSERT_TRUE(sender.send(makeMessage(station_id)));
+  }
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().received == 5; }));
+  std::this_thread::sleep_for(50ms);
+  ASSERT_EQ(broker.stats().delivered, 2);
+
+  // receiving grants new credit for the rest
+  ASSERT_EQ(receiveStationIds(receiver, 5), std::vector<uint32_t>({ 1, 2, 3, 4, 5 }));
+  ASSERT_EQ(broker.stats().delivered, 5);
+}
+}  // namespace mrm::v2x_amqp_connector_lib
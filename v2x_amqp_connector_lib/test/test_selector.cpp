@@ -0,0 +1,60 @@
+#include <v2x_amqp_connector_lib/selector.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+namespace mrm::v2x_amqp_connector_lib
+{
+namespace
+{
+bool matches(const std::string& selector, const std::map<std::string, Selector::Value>& properties)
+{
+  const auto parsed = Selector::parse(selector);
+  EXPECT_TRUE(parsed) << selector;
+  return parsed && parsed->matches([&](const std::string& name) {
+           auto it = properties.find(name);
+           return it != properties.end() ? it->second : Selector::Value();
+         });
+}
+}  // namespace
+
+TEST(SelectorTests, evaluatesSelectors)
+{
+  ASSERT_TRUE(matches("", {}));
+  ASSERT_TRUE(matches("station_id = 42 AND mid = 2049", { { "station_id", 42 }, { "mid", 2049 } }));
+  ASSERT_FALSE(matches("station_id = 42 AND mid = 2049", { { "station_id", 42 }, { "mid", 2050 } }));
+  ASSERT_TRUE(matches("NOT(station_id = 101)", { { "station_id", 102 } }));
+  ASSERT_FALSE(matches("NOT(station_id = 101)", { { "station_id", 101 } }));
+  ASSERT_TRUE(matches("station_id >= 100 and station_id < 200", { { "station_id", 199 } }));
+  ASSERT_FALSE(matches("station_id >= 100 and station_id < 200", { { "station_id", 200 } }));
+  ASSERT_TRUE(matches("mid IN (2048, 2050) AND enc = 'uper'", { { "mid", 2050 }, { "enc", std::string("uper") } }));
+  ASSERT_TRUE(matches("mid NOT IN (2048, 2050)", { { "mid", 2049 } }));
+  ASSERT_TRUE(matches("station_id BETWEEN 1 AND 3", { { "station_id", 3 } }));
+  ASSERT_TRUE(matches("station_id NOT BETWEEN 1 AND 3", { { "station_id", 4 } }));
+  ASSERT_TRUE(matches("speed > 1.5 AND speed <= 2", { { "speed", 2 } }));
+  ASSERT_TRUE(matches("name = 'it''s' OR name <> 'x'", { { "name", std::string("it's") } }));
+  ASSERT_TRUE(matches("destination_station_id IS NULL", {}));
+  ASSERT_TRUE(matches("accepted AND NOT rejected", { { "accepted", true }, { "rejected", false } }));
+  // different types never match
+  ASSERT_FALSE(matches("station_id = '42'", { { "station_id", 42 } }));
+}
+
+TEST(SelectorTests, treatsMissingPropertiesAsUnknown)
+{
+  ASSERT_FALSE(matches("NOT(station_id = 101)", {}));
+  ASSERT_FALSE(matches("station_id NOT IN (1, 2)", {}));
+  ASSERT_FALSE(matches("destination_station_id = 7 AND mid = 2049", { { "mid", 2049 } }));
+  ASSERT_TRUE(matches("destination_station_id = 7 OR mid = 2049", { { "mid", 2049 } }));
+  ASSERT_TRUE(matches("destination_station_id IS NULL OR destination_station_id = 7", {}));
+}
+
+TEST(SelectorTests, rejectsInvalidSelectors)
+{
+  for (const auto* selector : { "station_id =", "station_id = 1 AND", "(mid = 1", "mid IN 1", "mid IN ()",
+                                "enc = 'uper", "mid NOT 1", "mid = 1 mid", "station_id IS 1", "mid = 1.2.3" })
+  {
+    ASSERT_FALSE(Selector::parse(selector)) << selector;
+  }
+}
+}  // namespace mrm::v2x_amqp_connector_lib
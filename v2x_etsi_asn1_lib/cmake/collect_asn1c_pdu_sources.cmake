@@ -0,0 +1,50 @@
+if(NOT DEFINED ASN1C_OUTPUT_DIR)
+    message(FATAL_ERROR "Missing ASN.1 output directory (ASN1C_OUTPUT_DIR)")
+elseif(NOT DEFINED ASN1C_SOURCE_FILE)
+    message(FATAL_ERROR "Missing ASN.1 source file (ASN1C_SOURCE_FILE)")
+elseif(NOT DEFINED ASN1C_PDUS)
+    message(FATAL_ERROR "Missing comma separated list of PDU types (ASN1C_PDUS)")
+endif()
+
+# Collects the sources of the given PDU types and of all types they reach. asn1c includes the header of every
+# referenced type, either at the top or (for types held by pointer) at the end of a header, so following the quoted
+# includes of the generated files finds the complete closure.
+string(REPLACE "," ";" _pending "${ASN1C_PDUS}")
+foreach(_pdu ${_pending})
+    if(NOT EXISTS "${ASN1C_OUTPUT_DIR}/${_pdu}.h")
+        message(FATAL_ERROR "Unknown PDU type ${_pdu}, no ${_pdu}.h was generated by asn1c")
+    endif()
+endforeach()
+
+set(_visited "")
+while(_pending)
+    list(GET _pending 0 _type)
+    list(REMOVE_AT _pending 0)
+    list(FIND _visited ${_type} _index)
+    if(_index GREATER -1)
+        continue()
+    endif()
+    list(APPEND _visited ${_type})
+
+    foreach(_file "${ASN1C_OUTPUT_DIR}/${_type}.h" "${ASN1C_OUTPUT_DIR}/${_type}.c")
+        if(NOT EXISTS "${_file}")
+            continue()
+        endif()
+        file(STRINGS "${_file}" _includes REGEX "^#include \"[^\"]+\\.h\"")
+        foreach(_include ${_includes})
+            string(REGEX REPLACE "^#include \"([^\"]+)\\.h\".*" "\\1" _referenced "${_include}")
+            # only the generated types, the support code is added as a whole
+            if(EXISTS "${ASN1C_OUTPUT_DIR}/${_referenced}.h")
+                list(APPEND _pending ${_referenced})
+            endif()
+        endforeach()
+    endforeach()
+endwhile()
+
+list(SORT _visited)
+file(WRITE "${ASN1C_SOURCE_FILE}" "# generated file\n")
+foreach(_type ${_visited})
+    if(EXISTS "${ASN1C_OUTPUT_DIR}/${_type}.c")
+        file(APPEND "${ASN1C_SOURCE_FILE}" "${ASN1C_OUTPUT_DIR}/${_type}.c\n")
+    endif()
+endforeach()
@@ -39,6 +39,24 @@ foreach(_file ${_files})
     endif()
 endforeach()
 
+# count the allocations of the decoders against a per-thread budget, see src/asn_alloc_budget.c
+file(READ asn_internal.h _content)
+string(REGEX REPLACE "#define[ \t]+CALLOC\\(nmemb,[ \t]*size\\)[^\n]*"
+    "void *asn_budget_calloc(size_t nmemb, size_t size);\nvoid *asn_budget_malloc(size_t size);\nvoid *asn_budget_realloc(void *ptr, size_t size);\n#define CALLOC(nmemb, size) asn_budget_calloc(nmemb, size)"
+    _content "${_content}")
+string(REGEX REPLACE "#define[ \t]+MALLOC\\(size\\)[^\n]*"
+    "#define MALLOC(size) asn_budget_malloc(size)" _content "${_content}")
+string(REGEX REPLACE "#define[ \t]+REALLOC\\(oldptr,[ \t]*size\\)[^\n]*"
+    "#define REALLOC(oldptr, size) asn_budget_realloc(oldptr, size)" _content "${_content}")
+foreach(_function "asn_budget_calloc(nmemb" "asn_budget_malloc(size" "asn_budget_realloc(oldptr")
+    string(FIND "${_content}" "${_function}" _pos)
+    if(_pos EQUAL -1)
+        message(FATAL_ERROR "could not apply the allocation budget to asn_internal.h")
+    endif()
+endforeach()
+file(WRITE asn_internal.h "${_content}")
+message(STATUS "applied allocation budget")
+
 ## those fixes are for Windows builds using MSVC
 # add inclusion of inttypes.h
 file(READ OBJECT_IDENTIFIER.c _content)
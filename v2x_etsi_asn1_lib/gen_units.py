@@ -53,6 +53,7 @@ if __name__ == '__main__':
 
         last_unit_num = None
         last_unit = None
+        table = []
         print("#pragma once")
         for line in lines:
             if is_unit_line(line):
@@ -68,4 +69,17 @@ if __name__ == '__main__':
                 val = f"static constexpr double {name}Unit_{last_unit} = {last_unit_num};"
                 val = val.replace("__", '_').replace('__', '_')
                 print(val)
+                table.append((name, val.split()[3]))
                 last_unit = None
+
+        # lookup by ASN.1 type name, e.g. to convert values of asn1c descriptors
+        print("")
+        print("struct UnitScale")
+        print("{")
+        print("  const char* type_name;")
+        print("  double scale;")
+        print("};")
+        print("static constexpr UnitScale unit_scales[] = {")
+        for name, constant in table:
+            print(f'  {{ "{name}", {constant} }},')
+        print("};")
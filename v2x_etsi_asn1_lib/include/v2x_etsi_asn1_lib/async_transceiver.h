@@ -0,0 +1,315 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_ASYNC_TRANSCEIVER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_ASYNC_TRANSCEIVER_HPP_
+
+#include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Resumes a suspended coroutine, e.g. by posting the handle to an event loop or a thread pool. Coroutines waiting for
+// the transceiver are always resumed through it, never on the receiver thread or the AMQP container thread.
+using Executor = std::function<void(std::coroutine_handle<> handle)>;
+
+// Return type of coroutines which run detached: they start right away and free their state when they return
+struct DetachedTask
+{
+  struct promise_type
+  {
+    DetachedTask get_return_object()
+    {
+      return {};
+    }
+    std::suspend_never initial_suspend() noexcept
+    {
+      return {};
+    }
+    std::suspend_never final_suspend() noexcept
+    {
+      return {};
+    }
+    void return_void()
+    {
+    }
+    void unhandled_exception()
+    {
+      std::terminate();
+    }
+  };
+};
+
+// Decoded message and its metadata, as passed to the handlers of ETSIAMQPTransceiverBase
+template <class T>
+struct ReceivedETSIMessage
+{
+  std::shared_ptr<const T> msg;
+  BinaryETSIMessage msg_bin;
+};
+
+// All segments of a CPM, as passed to ETSIAMQPTransceiverBase::handleCompleteCPM()
+struct CompleteCPM
+{
+  StationId_t station_id{};
+  std::map<uint8_t, std::shared_ptr<const CollectivePerceptionMessage>> segments;
+  uint64_t time{};
+};
+
+// Bounded queue of values pushed by one thread and awaited by coroutines. Values are only queued once next() has been
+// called, so that streams nobody reads do not hold messages. If the queue is full, the oldest value is dropped.
+// A coroutine waiting in next() must not be destroyed before it has been resumed, close() resumes all of them.
+template <class T>
+class AsyncStream
+{
+public:
+  class Awaiter
+  {
+  public:
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+      return stream_.suspend(*this, handle);
+    }
+    // nullopt once the stream has been closed
+    std::optional<T> await_resume()
+    {
+      return std::move(value_);
+    }
+
+  private:
+    friend class AsyncStream;
+    explicit Awaiter(AsyncStream& stream) : stream_(stream)
+    {
+    }
+
+    AsyncStream& stream_;
+    std::coroutine_handle<> handle_;
+    std::optional<T> value_;
+  };
+
+  AsyncStream(Executor executor, size_t capacity)
+    : executor_(std::move(executor)), capacity_(std::max<size_t>(1, capacity))
+  {
+  }
+
+  [[nodiscard]] Awaiter next()
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    active_ = true;
+    return Awaiter(*this);
+  }
+
+  void push(T value)
+  {
+    std::unique_lock<std::mutex> l(lock_);
+    if (!active_ || closed_)
+    {
+      return;
+    }
+    if (!waiters_.empty())
+    {
+      auto* waiter = waiters_.front();
+      waiters_.pop_front();
+      waiter->value_ = std::move(value);
+      l.unlock();
+      executor_(waiter->handle_);
+      return;
+    }
+    if (queue_.size() >= capacity_)
+    {
+      queue_.pop_front();
+      num_dropped_++;
+    }
+    queue_.push_back(std::move(value));
+  }
+
+  // Resumes all waiting coroutines with nullopt, later calls of next() return nullopt without suspending
+  void close()
+  {
+    std::deque<Awaiter*> waiters;
+    {
+      std::lock_guard<std::mutex> l(lock_);
+      closed_ = true;
+      queue_.clear();
+      waiters.swap(waiters_);
+    }
+    for (auto* waiter : waiters)
+    {
+      executor_(waiter->handle_);
+    }
+  }
+
+  [[nodiscard]] uint64_t numDropped() const
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    return num_dropped_;
+  }
+
+private:
+  // Returns false if a value is available or the stream is closed, so that the coroutine continues right away
+  bool suspend(Awaiter& awaiter, std::coroutine_handle<> handle)
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    if (!queue_.empty())
+    {
+      awaiter.value_ = std::move(queue_.front());
+      queue_.pop_front();
+      return false;
+    }
+    if (closed_)
+    {
+      return false;
+    }
+    awaiter.handle_ = handle;
+    waiters_.push_back(&awaiter);
+    return true;
+  }
+
+  const Executor executor_;
+  const size_t capacity_;
+  mutable std::mutex lock_;
+  std::deque<T> queue_;
+  std::deque<Awaiter*> waiters_;
+  bool active_ = false;
+  bool closed_ = false;
+  uint64_t num_dropped_ = 0;
+};
+
+// Transceiver with a coroutine interface instead of the handleCAM() etc. callbacks, e.g.
+//
+//   DetachedTask camLoop(AsyncETSITransceiver& transceiver)
+//   {
+//     while (auto cam = co_await transceiver.next<CAM>())
+//     {
+//       ...
+//       const bool accepted = co_await transceiver.send(&asn_DEF_CAM, ETSIMessageType::CAM, &own_cam);
+//     }
+//   }
+//
+// Each message type has its own bounded stream, coroutines waiting for messages are resumed through the executor.
+// Handlers registered with registerHandler() replace the streams of their message types.
+class AsyncETSITransceiver : public ETSIAMQPTransceiverBase
+{
+public:
+  class SendAwaiter
+  {
+  public:
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+    bool await_suspend(std::coroutine_handle<> handle);
+    // true once the message has been delivered (with AMQP: accepted by the broker), false if it could not be sent,
+    // was rejected or dropped
+    bool await_resume() const noexcept
+    {
+      return accepted_;
+    }
+
+  private:
+    friend class AsyncETSITransceiver;
+    enum class State : uint8_t
+    {
+      Sending,
+      Suspended,
+      Settled,
+    };
+
+    SendAwaiter(AsyncETSITransceiver& transceiver,
+                StationId_t station_id,
+                const asn_TYPE_descriptor_t* type,
+                ETSIMessageType message_type,
+                void* msg,
+                std::optional<StationId_t> destination_station_id);
+
+    AsyncETSITransceiver& transceiver_;
+    const StationId_t station_id_;
+    const asn_TYPE_descriptor_t* const type_;
+    const ETSIMessageType message_type_;
+    void* const msg_;
+    const std::optional<StationId_t> destination_station_id_;
+    std::coroutine_handle<> handle_;
+    std::atomic<State> state_ = State::Sending;
+    bool accepted_ = false;
+  };
+
+  // queue_capacity: number of messages buffered per message type, the oldest are dropped if it is exceeded
+  explicit AsyncETSITransceiver(Executor executor, size_t queue_capacity = 1024);
+  ~AsyncETSITransceiver() override;
+
+  // Waits for the next CAM, VAM, MCM or CPM segment (T = CollectivePerceptionMessage). Messages of a type are only
+  // buffered after next() has been called for it once. Yields nullopt after close().
+  template <class T>
+  [[nodiscard]] typename AsyncStream<ReceivedETSIMessage<T>>::Awaiter next();
+  // Waits for the next CPM of which all segments have been received
+  [[nodiscard]] AsyncStream<CompleteCPM>::Awaiter nextCompleteCPM();
+  // Encodes msg and sends it, the message has to stay valid until the awaiter has been awaited. The coroutine is
+  // resumed once the transport has delivered the message, see SendAwaiter::await_resume().
+  [[nodiscard]] SendAwaiter send(const asn_TYPE_descriptor_t* type,
+                                 ETSIMessageType message_type,
+                                 void* msg,
+                                 std::optional<StationId_t> destination_station_id = {});
+  // Like send(), but on behalf of the given station, see sendETSIMsgAs()
+  [[nodiscard]] SendAwaiter sendAs(StationId_t station_id,
+                                   const asn_TYPE_descriptor_t* type,
+                                   ETSIMessageType message_type,
+                                   void* msg,
+                                   std::optional<StationId_t> destination_station_id = {});
+  // Resumes all coroutines waiting for messages with nullopt. Called by the destructor after disconnecting.
+  void close();
+  // Messages dropped because the stream of their type was full, over all types
+  [[nodiscard]] uint64_t numDropped() const;
+
+protected:
+  void handleCAM(const std::shared_ptr<const CAM>& msg, const BinaryETSIMessage& msg_bin) override;
+  void handleVAM(const std::shared_ptr<const VAM>& msg, const BinaryETSIMessage& msg_bin) override;
+  void handleCPM(const std::shared_ptr<const CollectivePerceptionMessage>& msg,
+                 const BinaryETSIMessage& msg_bin) override;
+  void handleCompleteCPM(StationId_t station_id,
+                         std::map<uint8_t, std::shared_ptr<const CollectivePerceptionMessage>> msgs,
+                         uint64_t time) override;
+  void handleMCM(const std::shared_ptr<const MCM>& msg, const BinaryETSIMessage& msg_bin) override;
+
+private:
+  const Executor executor_;
+  AsyncStream<ReceivedETSIMessage<CAM>> cams_;
+  AsyncStream<ReceivedETSIMessage<VAM>> vams_;
+  AsyncStream<ReceivedETSIMessage<CollectivePerceptionMessage>> cpms_;
+  AsyncStream<ReceivedETSIMessage<MCM>> mcms_;
+  AsyncStream<CompleteCPM> complete_cpms_;
+};
+
+template <class T>
+typename AsyncStream<ReceivedETSIMessage<T>>::Awaiter AsyncETSITransceiver::next()
+{
+  if constexpr (std::is_same_v<T, CAM>)
+  {
+    return cams_.next();
+  }
+  else if constexpr (std::is_same_v<T, VAM>)
+  {
+    return vams_.next();
+  }
+  else if constexpr (std::is_same_v<T, CollectivePerceptionMessage>)
+  {
+    return cpms_.next();
+  }
+  else
+  {
+    static_assert(std::is_same_v<T, MCM>, "next() supports CAM, VAM, CollectivePerceptionMessage and MCM");
+    return mcms_.next();
+  }
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_ASYNC_TRANSCEIVER_HPP_ */
@@ -0,0 +1,74 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_COVARIANCE_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_COVARIANCE_HPP_
+
+#include "v2x_etsi_asn1_lib/message_arena.h"
+
+#include <CollectivePerceptionMessage.h>
+#include <PerceivedObject.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Components of the state of a perceived object, in the bit order of MatrixIncludedComponents. Velocity and
+// acceleration are magnitude and direction instead of x and y if they are given in polar form.
+enum CovarianceComponent : uint8_t
+{
+  CovarianceComponent_xPosition,
+  CovarianceComponent_yPosition,
+  CovarianceComponent_zPosition,
+  CovarianceComponent_xVelocityOrVelocityMagnitude,
+  CovarianceComponent_yVelocityOrVelocityDirection,
+  CovarianceComponent_zSpeed,
+  CovarianceComponent_xAccelOrAccelMagnitude,
+  CovarianceComponent_yAccelOrAccelDirection,
+  CovarianceComponent_zAcceleration,
+  CovarianceComponent_zAngle,
+  CovarianceComponent_yAngle,
+  CovarianceComponent_xAngle,
+  CovarianceComponent_zAngularVelocity,
+  CovarianceComponent_objectDimensionZ,
+  CovarianceComponent_objectDimensionY,
+  CovarianceComponent_objectDimensionX,
+};
+
+constexpr size_t num_covariance_components = 16;
+
+// Dense covariance matrix of a perceived object in SI units (m, m/s, m/s^2, rad, rad/s), row-major with rows and
+// columns in CovarianceComponent order. Rows and columns of components which are absent or whose confidence is
+// unavailable or out of range are NaN. Components without a correlation in the message are uncorrelated.
+struct alignas(64) ObjectCovariance
+{
+  double values[num_covariance_components * num_covariance_components];
+  // bit n is set if the variance of component n is known
+  uint16_t available;
+
+  [[nodiscard]] double operator()(size_t row, size_t col) const
+  {
+    return values[row * num_covariance_components + col];
+  }
+  double& operator()(size_t row, size_t col)
+  {
+    return values[row * num_covariance_components + col];
+  }
+};
+
+// Decodes the covariances of all perceived objects in the PerceivedObjectContainers of the CPM, in message order,
+// from their confidences and lowerTriangularCorrelationMatrices. The matrices are built in a few passes over all
+// objects at once: gathering the confidences and correlations from the asn1c structs, then scaling them in dense
+// loops which the compiler can vectorize. Replaces the contents of covariances.
+void decodeCpmCovariances(const CollectivePerceptionMessage& cpm, std::vector<ObjectCovariance>& covariances);
+
+// Sets the confidences of the components present in each perceived object of the CPM (in message order) and replaces
+// its lowerTriangularCorrelationMatrices by a single matrix of all present components with a known variance.
+// covariances must have one entry per object. Memory is taken from arena if given (for messages of a MessageBuilder),
+// otherwise it is calloc()ed and the previous matrices are freed, as for messages freed with ASN_STRUCT_FREE.
+// Returns false if the number of objects does not match.
+bool encodeCpmCovariances(CollectivePerceptionMessage& cpm,
+                          const std::vector<ObjectCovariance>& covariances,
+                          MessageArena* arena = nullptr);
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_COVARIANCE_HPP_ */
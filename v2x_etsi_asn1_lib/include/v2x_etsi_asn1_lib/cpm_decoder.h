@@ -0,0 +1,62 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_DECODER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_DECODER_HPP_
+
+#include <CollectivePerceptionMessage.h>
+#include <WrappedCpmContainer.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Position of a container in a UPER encoded CPM. The container content (the open type) is a complete UPER encoding
+// of the container type, but it is not octet-aligned within the CPM.
+struct EncodedCpmContainer
+{
+  long container_id{};
+  size_t bit_offset{};
+  // size of the content in bytes
+  size_t size{};
+};
+
+// Selects container IDs for decodeCPMSelective(), bit n selects container ID n
+constexpr uint32_t cpmContainerMask(std::initializer_list<long> container_ids)
+{
+  uint32_t mask = 0;
+  for (auto id : container_ids)
+  {
+    mask |= 1u << id;
+  }
+  return mask;
+}
+
+// Finds the containers of a UPER encoded CPM by walking the header and the management container, without decoding
+// any container. Returns false if the buffer does not start with a valid CPM.
+bool findCpmContainers(const uint8_t* data, size_t size, std::vector<EncodedCpmContainer>& containers);
+
+// Counts the perceived objects in all PerceivedObjectContainers of a UPER encoded CPM from the list sizes, without
+// decoding the objects. Returns false if the buffer does not start with a valid CPM.
+bool countCpmPerceivedObjects(const uint8_t* data, size_t size, size_t& count);
+
+// Decodes a UPER encoded CPM with only the containers whose ID is selected in container_mask, the others are
+// skipped using their length prefix. The positions of the skipped containers are stored in skipped (if given),
+// so that they can be decoded later with decodeCpmContainer(). ctx is passed to the asn1c decoders of the containers,
+// e.g. to bound their stack usage. Like the asn1c decoders, *msg has to be freed by the caller even if decoding failed.
+asn_dec_rval_t decodeCPMSelective(CollectivePerceptionMessage** msg,
+                                  const uint8_t* data,
+                                  size_t size,
+                                  uint32_t container_mask,
+                                  std::vector<EncodedCpmContainer>* skipped = nullptr,
+                                  const asn_codec_ctx_t* ctx = nullptr);
+
+// Decodes a single container of the CPM in data. Only the container IDs defined in CPM-PDU-Descriptions are
+// supported. *container has to be freed by the caller (asn_DEF_WrappedCpmContainer) even if decoding failed.
+asn_dec_rval_t decodeCpmContainer(WrappedCpmContainer** container,
+                                  const uint8_t* data,
+                                  size_t size,
+                                  const EncodedCpmContainer& encoded,
+                                  const asn_codec_ctx_t* ctx = nullptr);
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_DECODER_HPP_ */
@@ -0,0 +1,76 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_OBJECT_SELECTOR_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_OBJECT_SELECTOR_HPP_
+
+#include <v2x_etsi_asn1_lib/station_table.h>
+#include <PerceivedObject.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Object inclusion rules of TS 103 324, clause 6.1.2.3
+struct CpmObjectRules
+{
+  // objects whose objectAge is below this are not sent yet (tentative tracks)
+  std::chrono::milliseconds min_object_age{ 0 };
+  // an object is sent again at the latest after this time
+  std::chrono::milliseconds max_interval{ 1000 };
+  double position_threshold = 4.0;   // metres
+  double speed_threshold = 0.5;      // m/s
+  double direction_threshold = 4.0;  // degrees, direction of the velocity
+};
+
+// Selects the perceived objects which have to be included in the next CPM. An object is included if it has not been
+// sent before, or if its position, speed or direction of motion changed by more than the thresholds since it was
+// last sent, or if it was last sent more than max_interval ago. Objects are tracked by their objectId, objects
+// without objectId are always included.
+//
+// Redundancy mitigation: objects whose associatedStationID refers to a station in the station table are skipped,
+// since that station announces itself with its own CAMs/VAMs. The max_age of the table defines how recent these
+// messages have to be.
+//
+// The positions are compared in the CPM coordinate system, i.e. relative to the reference position, which is fixed
+// for RSUs. Not thread-safe.
+class CpmObjectSelector
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit CpmObjectSelector(const CpmObjectRules& rules = {}, std::shared_ptr<const StationTable> stations = nullptr);
+
+  // objects contains all currently tracked objects. The selected objects are assumed to be sent, objects missing in
+  // objects are forgotten and treated as new when they reappear.
+  std::vector<const PerceivedObject*> select(const std::vector<const PerceivedObject*>& objects,
+                                             Clock::time_point now = Clock::now());
+
+  // Number of objects skipped by the redundancy mitigation in the last call of select()
+  [[nodiscard]] size_t numRedundant() const;
+
+private:
+  struct SentObject
+  {
+    Clock::time_point time;
+    double x;
+    double y;
+    double speed;      // NaN if not sent
+    double direction;  // degrees, NaN if not sent
+    uint64_t cycle;
+  };
+
+  [[nodiscard]] bool isRedundant(const PerceivedObject& obj) const;
+  [[nodiscard]] bool isDue(const SentObject& current, const SentObject& sent) const;
+  static SentObject objectState(const PerceivedObject& obj, Clock::time_point now, uint64_t cycle);
+
+  const CpmObjectRules rules_;
+  const std::shared_ptr<const StationTable> stations_;
+  std::unordered_map<long, SentObject> sent_objects_;
+  uint64_t cycle_ = 0;
+  size_t num_redundant_ = 0;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_OBJECT_SELECTOR_HPP_ */
@@ -0,0 +1,44 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_SEGMENTER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_SEGMENTER_HPP_
+
+#include <CollectivePerceptionMessage.h>
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Maximum number of segments of a CPM (MessageSegmentationInfo)
+constexpr size_t max_cpm_segments = 8;
+
+struct SegmentedCPM
+{
+  // UPER encoded segments, ready for sendEncodedETSIMsg()
+  std::vector<std::vector<uint8_t>> segments;
+  // objects which did not fit into max_cpm_segments segments
+  std::vector<const PerceivedObject*> omitted_objects;
+};
+
+// Returns an upper bound of the number of bytes the UPER encoding of obj adds to a PerceivedObjectContainer,
+// or -1 if obj cannot be encoded
+ssize_t estimatePerceivedObjectSize(const PerceivedObject& obj);
+
+// Splits the objects into as few CPM segments of at most max_size bytes (UPER) as possible. msg provides the
+// header, the management container and the containers to send; a PerceivedObjectContainer in msg is ignored.
+// The originating vehicle/RSU container is repeated in each segment, the other containers are only sent in the
+// first one. All segments share the reference time of msg and get consistent segmentation info (none if a single
+// segment is sufficient). The objects are only referenced during encoding, msg and the objects are not modified.
+// numberOfPerceivedObjects is set to num_perceived_objects if given (e.g. the number of all tracked objects if only
+// some of them are sent, see CpmObjectSelector), else to the number of objects.
+// Returns false if the message cannot be encoded or the containers alone exceed max_size.
+bool encodeSegmentedCPM(const CollectivePerceptionMessage& msg,
+                        const std::vector<const PerceivedObject*>& objects,
+                        size_t max_size,
+                        SegmentedCPM& result,
+                        std::optional<size_t> num_perceived_objects = {});
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_CPM_SEGMENTER_HPP_ */
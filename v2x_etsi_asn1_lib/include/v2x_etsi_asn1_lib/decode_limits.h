@@ -0,0 +1,64 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_DECODE_LIMITS_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_DECODE_LIMITS_HPP_
+
+#include <v2x_etsi_asn1_lib/message_types.h>
+#include <CollectivePerceptionMessage.h>
+#include <MCM.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Resource limits for decoding a single message, 0 means unlimited
+struct DecodeLimits
+{
+  // size of the encoded message in bytes
+  size_t max_size = 0;
+  // bytes allocated by the asn1c decoder. Reallocations are counted with their full size, so this is an upper bound.
+  size_t max_allocation = 0;
+  // stack used by the asn1c decoder in bytes (asn_codec_ctx_t::max_stack_size), which bounds the nesting depth
+  size_t max_stack_size = 0;
+  // perceived objects of a CPM or trajectory points of an MCM
+  size_t max_elements = 0;
+};
+
+enum class DecodeLimitResult
+{
+  Ok,
+  TooLarge,
+  TooManyElements,
+  AllocationExceeded,
+  DecodingFailed,  // includes exceeding max_stack_size, which asn1c does not report separately
+};
+
+const char* toString(DecodeLimitResult result);
+
+// Limits used by ETSIAMQPTransceiverBase: the size constraints of the ASN.1 definitions for the element counts,
+// generous bounds for the rest
+DecodeLimits defaultDecodeLimits(ETSIMessageType message_type);
+
+// Decodes like decodeETSIMsg() within the given limits. The size and, for UPER encoded CPMs, the number of perceived
+// objects are checked before decoding. The allocations are counted during decoding and fail once the budget is
+// exhausted. If cpm_container_mask is given, UPER encoded CPMs are decoded with decodeCPMSelective().
+// *msg has to be freed by the caller even if decoding failed.
+DecodeLimitResult decodeETSIMsgLimited(const asn_TYPE_descriptor_t* type,
+                                       WireEncoding encoding,
+                                       void** msg,
+                                       const void* buffer,
+                                       size_t size,
+                                       const DecodeLimits& limits,
+                                       std::optional<uint32_t> cpm_container_mask = {});
+
+// Number of elements limited by DecodeLimits::max_elements
+size_t countElements(const CollectivePerceptionMessage& msg);
+size_t countElements(const MCM& msg);
+
+// Budget for the allocations of the asn1c decoders on the calling thread (see patch_asn1c_skeleton.cmake).
+// Returns false if the budget was exceeded between begin and end.
+void beginAllocationBudget(size_t max_bytes);
+bool endAllocationBudget();
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_DECODE_LIMITS_HPP_ */
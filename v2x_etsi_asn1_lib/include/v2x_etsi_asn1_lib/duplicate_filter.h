@@ -0,0 +1,54 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_DUPLICATE_FILTER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_DUPLICATE_FILTER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Detects messages that were already received within a time window (e.g. the same CAM received via an RSU relay
+// and directly from the vehicle). Messages are identified by their message type, station ID and a hash of the
+// encoded payload, which is sufficient since UPER encodings are canonical.
+//
+// The memory usage is fixed: the window is split into num_buckets time slices, each with a hash set of bucket_capacity
+// fingerprints. If a bucket is full, further messages in this time slice are not remembered (and are thus never
+// reported as duplicates).
+// Not thread-safe, except for numDuplicates() and numOverflows().
+class DuplicateFilter
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  DuplicateFilter(std::chrono::milliseconds window, size_t bucket_capacity, size_t num_buckets = 4);
+
+  // Returns true if the message was already seen within the time window, otherwise remembers it and returns false
+  bool isDuplicate(uint16_t mid, uint32_t station_id, const uint8_t* data, size_t size, Clock::time_point now);
+
+  [[nodiscard]] uint64_t numDuplicates() const;
+  [[nodiscard]] uint64_t numOverflows() const;
+
+  static uint64_t fingerprint(uint16_t mid, uint32_t station_id, const uint8_t* data, size_t size);
+
+private:
+  struct Bucket
+  {
+    int64_t epoch = -1;
+    size_t size = 0;
+    std::vector<uint64_t> entries;
+  };
+
+  bool contains(const Bucket& bucket, uint64_t fp) const;
+  bool insert(Bucket& bucket, uint64_t fp) const;
+
+  const int64_t bucket_span_ns_;
+  const size_t mask_;
+  std::vector<Bucket> buckets_;
+  std::atomic<uint64_t> num_duplicates_ = 0;
+  std::atomic<uint64_t> num_overflows_ = 0;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_DUPLICATE_FILTER_HPP_ */
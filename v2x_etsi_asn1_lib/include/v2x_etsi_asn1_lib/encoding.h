@@ -0,0 +1,31 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_ENCODING_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_ENCODING_HPP_
+
+#include <v2x_etsi_asn1_lib/message_types.h>
+#include <asn_application.h>
+
+#include <optional>
+#include <string_view>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Name used for the "enc" property of AMQP messages
+const char* toString(WireEncoding encoding);
+std::optional<WireEncoding> wireEncodingFromString(std::string_view name);
+
+asn_transfer_syntax transferSyntax(WireEncoding encoding);
+
+// Decodes a complete message, *msg has to be freed by the caller even if decoding failed
+asn_dec_rval_t decodeETSIMsg(const asn_TYPE_descriptor_t* type,
+                             WireEncoding encoding,
+                             void** msg,
+                             const void* buffer,
+                             size_t size,
+                             const asn_codec_ctx_t* ctx = nullptr);
+// Returns a buffer allocated with malloc(), which is nullptr if encoding failed
+asn_encode_to_new_buffer_result_t encodeETSIMsg(const asn_TYPE_descriptor_t* type,
+                                                WireEncoding encoding,
+                                                const void* msg);
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_ENCODING_HPP_ */
@@ -0,0 +1,76 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_GENERATION_MANAGER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_GENERATION_MANAGER_HPP_
+
+#include <chrono>
+#include <optional>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Generation rules of CAMs (EN 302 637-2, clause 6.1.3) and VAMs (TS 103 300-3, clause 6.4.1)
+struct GenerationRules
+{
+  std::chrono::milliseconds min_interval;  // T_GenCamMin / T_GenVamMin
+  std::chrono::milliseconds max_interval;  // T_GenCamMax / T_GenVamMax
+  // minimum time between two messages with the low frequency container (which contains the path history of CAMs)
+  std::chrono::milliseconds low_frequency_interval;
+  double heading_threshold = 4.0;   // degrees
+  double position_threshold = 4.0;  // metres
+  double speed_threshold = 0.5;     // m/s
+  // number of consecutive messages after a dynamics triggered message that keep its interval (N_GenCam)
+  unsigned num_keep_interval = 3;
+
+  static GenerationRules cam();
+  static GenerationRules vam();
+};
+
+// Ego state the triggering conditions are evaluated on. Angles in degrees (0 = north, clockwise), like StationState.
+struct GenerationState
+{
+  double latitude{};
+  double longitude{};
+  double heading{};  // NaN if unavailable, the heading condition is not checked then
+  double speed{};
+};
+
+struct GenerationDecision
+{
+  bool send = false;
+  bool include_low_frequency_container = false;
+};
+
+// Decides when a new CAM or VAM is due. check() has to be called at least every min_interval (T_CheckCamGen),
+// e.g. from the sender loop, and the message has to be sent whenever the decision says so.
+// A message is generated
+// - when the heading, position or speed changed by more than the thresholds since the last message, but not before
+//   min_interval has elapsed. The elapsed time then becomes the generation interval (T_GenCam).
+// - when the generation interval has elapsed. After num_keep_interval such messages, the interval is reset to
+//   max_interval.
+// Not thread-safe.
+class GenerationManager
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit GenerationManager(const GenerationRules& rules);
+
+  GenerationDecision check(const GenerationState& state, Clock::time_point now = Clock::now());
+
+  // Forgets the last message, the next check() triggers a message with the low frequency container
+  void reset();
+
+  // Current generation interval (T_GenCam)
+  [[nodiscard]] std::chrono::milliseconds interval() const;
+
+private:
+  [[nodiscard]] bool dynamicsChanged(const GenerationState& state) const;
+
+  const GenerationRules rules_;
+  std::optional<Clock::time_point> last_time_;
+  std::optional<Clock::time_point> last_low_frequency_time_;
+  GenerationState last_state_;
+  std::chrono::milliseconds interval_;
+  unsigned num_timer_triggered_ = 0;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_GENERATION_MANAGER_HPP_ */
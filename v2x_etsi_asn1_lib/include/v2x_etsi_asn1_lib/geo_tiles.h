@@ -0,0 +1,39 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_GEO_TILES_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_GEO_TILES_HPP_
+
+#include <string>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Quadkeys of the Web Mercator tile pyramid (as used by Bing Maps), for area-of-interest filtering at the broker.
+// Senders add the quadkey of their reference position at a few zoom levels as message properties named
+// quadkeyProperty(zoom), e.g. "qk14", and receivers select the tiles around them with quadkeySelector().
+// The quadkey of a tile is a prefix of the quadkeys of all tiles within it.
+
+// WGS84 position in degrees
+struct GeoPosition
+{
+  double latitude{};
+  double longitude{};
+};
+
+// Maximum zoom level, tiles are at most 2.4 m wide then
+constexpr unsigned max_quadkey_zoom = 24;
+
+// Name of the message property holding the quadkey at the given zoom level
+std::string quadkeyProperty(unsigned zoom);
+// Quadkey of the tile containing the position at the given zoom level (1 to max_quadkey_zoom), with zoom digits.
+// Latitudes beyond +-85.05 degrees are clamped to the edge of the map, longitudes are wrapped to -180..180 degrees.
+std::string quadkey(double latitude, double longitude, unsigned zoom);
+// Quadkeys of all tiles at the given zoom level which intersect the bounding box of the circle with the given radius
+// (in metres) around the position. The number of tiles grows quadratically with radius / tile size, so the zoom
+// level should be chosen such that tiles are not much smaller than the radius. Areas crossing the antimeridian
+// contain the tiles on both sides of it.
+std::vector<std::string> quadkeysInArea(double latitude, double longitude, double radius, unsigned zoom);
+// Selector (AMQP selector filter / JMS message selector syntax) matching messages whose quadkey property at the given
+// zoom level is one of the tiles of quadkeysInArea(), e.g. "qk14 IN ('12020210332210', '12020210332211')"
+std::string quadkeySelector(double latitude, double longitude, double radius, unsigned zoom);
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_GEO_TILES_HPP_ */
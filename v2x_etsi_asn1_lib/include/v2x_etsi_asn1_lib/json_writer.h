@@ -0,0 +1,66 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_JSON_WRITER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_JSON_WRITER_HPP_
+
+#include <asn_application.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Streaming JSON encoder for decoded asn1c structs (CAM, VAM, CPM, MCM, ...). It walks the asn1c type descriptors and
+// appends directly to a reusable buffer, without building a DOM and without allocating once the buffer has grown to
+// the message size. Each message is written as one line (JSON Lines), with the ASN.1 member names as keys:
+// - SEQUENCE/SET: object, absent optional members are omitted
+// - CHOICE and open types: object with the selected alternative as the only member
+// - SEQUENCE OF/SET OF: array
+// - ENUMERATED: the name of the value as string
+// - BIT STRING: string of '0' and '1', OCTET STRING: hex string
+//
+// With si_units, integers of types listed in units.h are scaled to these units (e.g. SpeedValue in m/s). Named
+// special values containing "unavailable" or "OutOfRange" are written as their name then, since scaling them would
+// produce plausible but wrong numbers.
+// Not thread-safe, use one writer per thread.
+class JsonWriter
+{
+public:
+  explicit JsonWriter(bool si_units = false);
+
+  // Appends msg of the given type and a newline. Returns false if msg contains a type which cannot be written, which
+  // is written as null then.
+  bool write(const asn_TYPE_descriptor_t& type, const void* msg);
+
+  [[nodiscard]] std::string_view buffer() const;
+  // Empties the buffer, keeping its capacity
+  void clear();
+
+private:
+  struct Scale
+  {
+    double factor;
+    // 1 / factor if it is an integer, dividing by it gives correctly rounded results (e.g. 1234 / 100 = 12.34)
+    double divisor;
+  };
+
+  bool writeValue(const asn_TYPE_descriptor_t* type, const void* ptr);
+  bool writeSequence(const asn_TYPE_descriptor_t* type, const void* ptr);
+  bool writeChoice(const asn_TYPE_descriptor_t* type, const void* ptr);
+  bool writeList(const asn_TYPE_descriptor_t* type, const void* ptr);
+  void writeInteger(const asn_TYPE_descriptor_t* type, intmax_t value);
+  void writeKey(const char* name);
+  void writeString(const char* data, size_t size);
+  template <class T>
+  void writeNumber(T value);
+  const Scale* findScale(const asn_TYPE_descriptor_t* type);
+
+  const bool si_units_;
+  std::string buffer_;
+  // scale factors by descriptor, empty for types without unit
+  std::unordered_map<const asn_TYPE_descriptor_t*, std::optional<Scale>> scales_;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_JSON_WRITER_HPP_ */
@@ -0,0 +1,88 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_LOOPBACK_TRANSPORT_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_LOOPBACK_TRANSPORT_HPP_
+
+#include <v2x_etsi_asn1_lib/transport.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+class LoopbackTransport;
+
+// In-process replacement for the broker, for tests and benchmarks. Every message sent through one of the attached
+// transports is delivered to all other attached transports in the order in which it was sent. Messages are
+// delivered as AMQP messages built by makeProtonMessage(), so the receiving transceivers run the same property,
+// subject and TTL handling as with a broker.
+class LoopbackBus : public std::enable_shared_from_this<LoopbackBus>
+{
+public:
+  using Filter = std::function<bool(const proton::message& message)>;
+
+  static std::shared_ptr<LoopbackBus> create();
+
+  // Creates a transport attached to the bus. If a filter is given, only the messages it accepts are delivered to
+  // the transport, like the selector filter of an AMQP receiver.
+  std::shared_ptr<LoopbackTransport> attach(Filter filter = {});
+  // Waits until all messages sent so far have been handled or dropped by the receivers
+  bool waitUntilIdle(std::chrono::milliseconds timeout);
+  [[nodiscard]] uint64_t numSent() const;
+
+private:
+  friend class LoopbackTransport;
+
+  LoopbackBus() = default;
+  void publish(const LoopbackTransport& sender, const proton::message& message);
+  void detach(LoopbackTransport& transport);
+  void handled(size_t num_messages);
+
+  mutable std::mutex lock_;
+  std::condition_variable idle_;
+  std::vector<LoopbackTransport*> transports_;
+  // Messages queued in or being handled by one of the transports
+  uint64_t num_pending_ = 0;
+  uint64_t num_sent_ = 0;
+};
+
+class LoopbackTransport : public ETSITransport
+{
+public:
+  ~LoopbackTransport() override;
+
+  bool send(const OutgoingETSIMessage& message) override;
+  bool receive(ETSIMessageSink& sink) override;
+  bool is_sender_connected() override;
+  void close() override;
+
+  [[nodiscard]] uint64_t numReceived() const;
+  // Messages dropped because their TTL expired before they were received
+  [[nodiscard]] uint64_t numExpired() const;
+
+private:
+  friend class LoopbackBus;
+
+  struct Entry
+  {
+    proton::message message;
+    std::chrono::steady_clock::time_point expiry_time;
+  };
+
+  LoopbackTransport(std::shared_ptr<LoopbackBus> bus, LoopbackBus::Filter filter);
+  // Returns false if the transport has been closed
+  bool push(const proton::message& message, std::chrono::steady_clock::time_point now);
+
+  const std::shared_ptr<LoopbackBus> bus_;
+  const LoopbackBus::Filter filter_;
+
+  mutable std::mutex lock_;
+  std::condition_variable ready_;
+  std::deque<Entry> queue_;
+  bool closed_ = false;
+  uint64_t num_received_ = 0;
+  uint64_t num_expired_ = 0;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_LOOPBACK_TRANSPORT_HPP_ */
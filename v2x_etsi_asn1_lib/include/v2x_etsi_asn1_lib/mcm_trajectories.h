@@ -0,0 +1,134 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MCM_TRAJECTORIES_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MCM_TRAJECTORIES_HPP_
+
+#include <v2x_etsi_asn1_lib/message_types.h>
+#include <v2x_etsi_asn1_lib/spatial_index.h>
+#include <MCM.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Point of a trajectory in a local east-north frame, e.g. of the own plan
+struct TrajectorySample
+{
+  uint64_t time{};   // unix nanoseconds
+  double x{};        // metres east of the origin
+  double y{};        // metres north of the origin
+  double speed{};    // m/s, NaN if unknown
+  double heading{};  // degrees, 0 = north, clockwise, NaN if unknown
+};
+
+// Time span in which two trajectories are closer than the sum of their radii and the margin
+struct TrajectoryConflict
+{
+  size_t first{};
+  size_t second{};
+  uint64_t time{};          // unix nanoseconds at which the distance drops below the threshold
+  uint64_t closest_time{};  // unix nanoseconds of the closest approach until the distance exceeds it again
+  float distance{};         // distance at the closest approach
+};
+
+// Planned trajectories of many road users, e.g. from the MCMs received in one coordination cycle and the own plan,
+// decoded into struct-of-arrays form for batched conflict checks.
+//
+// Positions are projected into a local east-north frame around the given origin with a LocalProjection. MCM waypoints
+// are taken as offsets east (xDistance) and north (yDistance) of the reference position of the MCM. Point i of a
+// planned trajectory is at startDeltaTime + i * deltaTime (both in milliseconds) after the generation time.
+//
+// Each trajectory is resampled onto a common time grid of num_steps steps from start_time, stored row-major
+// (trajectory i at [i * stride(), i * stride() + num_steps())). Steps outside the time span of a trajectory are NaN.
+// The conflict checks run over these rows in branchless loops which the compiler vectorizes. Between two steps,
+// both road users are assumed to move linearly, so that passing each other between steps is detected as well.
+//
+// reset() keeps the allocated memory, so that a set can be reused in every cycle without allocating.
+class McmTrajectorySet
+{
+public:
+  McmTrajectorySet(double origin_latitude,
+                   double origin_longitude,
+                   std::chrono::milliseconds step = std::chrono::milliseconds(100),
+                   size_t num_steps = 64);
+
+  // Removes all trajectories and moves the time grid to start at start_time (unix nanoseconds)
+  void reset(uint64_t start_time);
+  // Adds the planned trajectory of an MCM with a RoadUserContainer. Its radius is half the diagonal of the road user,
+  // or default_radius if length or width are unavailable. Returns the index of the trajectory, or nullopt if the MCM
+  // has no planned trajectory.
+  std::optional<size_t> addMCM(const MCM& msg, uint64_t now_unix_time, float default_radius = 2.5f);
+  // Adds a trajectory given in the local frame, samples must be ordered by time
+  std::optional<size_t> addTrajectory(StationId_t station_id,
+                                      float radius,
+                                      const std::vector<TrajectorySample>& samples);
+
+  // Earliest conflict of the two trajectories, if any. If they are already too close at their first common step,
+  // the conflict starts there.
+  [[nodiscard]] std::optional<TrajectoryConflict> findConflict(size_t first, size_t second, float margin) const;
+  // Earliest conflict of the trajectory with each other one, e.g. of the own plan with all received ones
+  [[nodiscard]] std::vector<TrajectoryConflict> findConflicts(size_t index, float margin) const;
+  // Earliest conflict of every pair of trajectories, ordered by first and second
+  [[nodiscard]] std::vector<TrajectoryConflict> findConflicts(float margin) const;
+
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] uint64_t startTime() const;
+  [[nodiscard]] std::chrono::milliseconds step() const;
+  [[nodiscard]] size_t numSteps() const;
+  // Distance between the rows of trajectories in the grid arrays
+  [[nodiscard]] size_t stride() const;
+  [[nodiscard]] StationId_t stationId(size_t index) const;
+  [[nodiscard]] float radius(size_t index) const;
+  // Rows of the time grid, num_steps() values each
+  [[nodiscard]] const float* x(size_t index) const;
+  [[nodiscard]] const float* y(size_t index) const;
+  [[nodiscard]] const float* speed(size_t index) const;
+  [[nodiscard]] const float* heading(size_t index) const;
+
+private:
+  // Range of steps covered by the trajectory
+  struct StepRange
+  {
+    uint32_t begin{};
+    uint32_t end{};
+  };
+  struct Bounds
+  {
+    float min_x{};
+    float min_y{};
+    float max_x{};
+    float max_y{};
+  };
+
+  // Appends a grid row and fills it from the points in points_, which are cleared afterwards
+  std::optional<size_t> resamplePoints(StationId_t station_id, float radius);
+  [[nodiscard]] bool mayConflict(size_t first, size_t second, float margin) const;
+
+  const LocalProjection projection_;
+  const std::chrono::milliseconds step_;
+  const size_t num_steps_;
+  const size_t stride_;
+  uint64_t start_time_{};
+
+  // per trajectory
+  std::vector<StationId_t> station_ids_;
+  std::vector<float> radii_;
+  std::vector<StepRange> ranges_;
+  std::vector<Bounds> bounds_;
+  // grid rows
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> speed_;
+  std::vector<float> heading_;
+
+  // points of the trajectory being added, time in seconds since start_time_
+  std::vector<float> points_time_;
+  std::vector<float> points_x_;
+  std::vector<float> points_y_;
+  std::vector<float> points_speed_;
+  std::vector<float> points_heading_;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MCM_TRAJECTORIES_HPP_ */
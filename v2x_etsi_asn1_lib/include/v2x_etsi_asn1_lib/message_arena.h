@@ -0,0 +1,63 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_ARENA_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_ARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Bump allocator for building outgoing messages. Memory is handed out zeroed (like calloc()) from large blocks, and
+// reset() makes all of it reusable at once while keeping the blocks, so a sender building one message per cycle stops
+// allocating once the blocks fit its largest message.
+// Memory from the arena must never be passed to free() or ASN_STRUCT_FREE. Not thread-safe.
+class MessageArena
+{
+public:
+  static constexpr size_t default_block_size = 64 * 1024;
+
+  explicit MessageArena(size_t block_size = default_block_size);
+
+  // Returns zeroed memory, valid until reset() or destruction of the arena. alignment has to be a power of two.
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  template <class T>
+  T* create()
+  {
+    static_assert(std::is_trivially_destructible_v<T>, "the arena does not call destructors");
+    return static_cast<T*>(allocate(sizeof(T), alignof(T)));
+  }
+
+  template <class T>
+  T* createArray(size_t n)
+  {
+    static_assert(std::is_trivially_destructible_v<T>, "the arena does not call destructors");
+    return static_cast<T*>(allocate(sizeof(T) * n, alignof(T)));
+  }
+
+  // Invalidates all memory handed out so far, keeping the blocks for reuse
+  void reset();
+
+  // Bytes handed out since the last reset(), including alignment padding
+  [[nodiscard]] size_t used() const;
+  // Total size of all blocks
+  [[nodiscard]] size_t capacity() const;
+
+private:
+  struct Block
+  {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  const size_t block_size_;
+  std::vector<Block> blocks_;
+  // block currently allocated from, and the offset within it
+  size_t current_ = 0;
+  size_t offset_ = 0;
+  size_t used_ = 0;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_ARENA_HPP_ */
@@ -0,0 +1,159 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_BUILDER_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_BUILDER_HPP_
+
+#include "v2x_etsi_asn1_lib/message_arena.h"
+
+#include <BIT_STRING.h>
+#include <CartesianCoordinateWithConfidence.h>
+#include <Heading.h>
+#include <INTEGER.h>
+#include <OCTET_STRING.h>
+#include <ReferencePosition.h>
+#include <ReferencePositionWithConfidence.h>
+#include <Speed.h>
+#include <VelocityComponent.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Builds outgoing messages of type T (CAM, CPM, ...) in a MessageArena instead of with one calloc() per OPTIONAL
+// member and SEQUENCE OF element. The builder is meant to be kept and reused for every message:
+//
+//   auto& cam = builder.reset();
+//   auto& lf = builder.create(cam.cam.camParameters.lowFrequencyContainer);
+//   ...
+//   sendETSIMsg(&asn_DEF_CAM, ETSIMessageType::CAM, builder.get());
+//
+// All memory of a message has to come from the builder, and the message must not be freed with ASN_STRUCT_FREE.
+// It is valid until the next reset().
+template <class T>
+class MessageBuilder
+{
+public:
+  explicit MessageBuilder(size_t block_size = MessageArena::default_block_size) : arena_(block_size)
+  {
+  }
+
+  // Starts a new, zeroed message, invalidating the previous one
+  T& reset()
+  {
+    arena_.reset();
+    msg_ = arena_.create<T>();
+    return *msg_;
+  }
+
+  // The message started by the last reset(), nullptr before
+  [[nodiscard]] T* get() const
+  {
+    return msg_;
+  }
+
+  [[nodiscard]] MessageArena& arena()
+  {
+    return arena_;
+  }
+
+  // Allocates a zeroed OPTIONAL member (or any other member held by pointer)
+  template <class M>
+  M& create(M*& member)
+  {
+    member = arena_.create<M>();
+    return *member;
+  }
+
+  // Appends a zeroed element to an asn1c SEQUENCE OF list, e.g. append(cpm.payload.cpmContainers.list)
+  template <class L>
+  auto& append(L& list)
+  {
+    using Element = std::remove_pointer_t<std::remove_pointer_t<decltype(list.array)>>;
+    if (list.count == list.size)
+    {
+      reserve(list, list.size > 0 ? 2 * static_cast<size_t>(list.size) : 4);
+    }
+    auto* element = arena_.create<Element>();
+    list.array[list.count++] = element;
+    return *element;
+  }
+
+  // Grows an asn1c SEQUENCE OF list to hold at least n elements without further allocations
+  template <class L>
+  void reserve(L& list, size_t n)
+  {
+    using Element = std::remove_pointer_t<std::remove_pointer_t<decltype(list.array)>>;
+    if (n <= static_cast<size_t>(list.size))
+    {
+      return;
+    }
+    auto** array = arena_.createArray<Element*>(n);
+    if (list.count > 0)
+    {
+      std::memcpy(array, list.array, list.count * sizeof(Element*));
+    }
+    list.array = array;
+    list.size = static_cast<int>(n);
+    // elements are owned by the arena
+    list.free = nullptr;
+  }
+
+  // Sets a non-negative INTEGER (e.g. TimestampIts), like asn_umax2INTEGER()
+  void setInteger(INTEGER_t& integer, uint64_t value)
+  {
+    uint8_t bytes[9];
+    for (int i = 8; i >= 0; i--, value >>= 8)
+    {
+      bytes[i] = static_cast<uint8_t>(value);
+    }
+    // minimal two's complement encoding, keeping a leading zero byte if the next byte has its sign bit set
+    size_t start = 0;
+    while (start < 8 && bytes[start] == 0 && (bytes[start + 1] & 0x80) == 0)
+    {
+      start++;
+    }
+    setBuffer(integer, bytes + start, sizeof(bytes) - start);
+  }
+
+  void setOctets(OCTET_STRING_t& str, const void* data, size_t size)
+  {
+    setBuffer(str, data, size);
+  }
+
+  // Sets a BIT STRING from num_bits bits, most significant bit of data[0] first
+  void setBits(BIT_STRING_t& bits, const uint8_t* data, size_t num_bits)
+  {
+    setBuffer(bits, data, (num_bits + 7) / 8);
+    bits.bits_unused = static_cast<int>(bits.size * 8 - num_bits);
+  }
+
+private:
+  template <class S>
+  void setBuffer(S& str, const void* data, size_t size)
+  {
+    str.buf = arena_.createArray<uint8_t>(size);
+    str.size = size;
+    if (size > 0)
+    {
+      std::memcpy(str.buf, data, size);
+    }
+  }
+
+  MessageArena arena_;
+  T* msg_ = nullptr;
+};
+
+// Typed setters taking SI units and standard deviations, which apply the units.h scaling, clamp to the outOfRange
+// values and use the unavailable values for NaN. Angles in degrees (0 = north, clockwise). The confidence ellipse and
+// altitude confidence of positions are set to unavailable.
+void setReferencePosition(ReferencePosition_t& position, double latitude, double longitude, double altitude);
+void setReferencePosition(ReferencePositionWithConfidence_t& position,
+                          double latitude,
+                          double longitude,
+                          double altitude);
+void setSpeed(Speed_t& speed, double value, double stddev);
+void setHeading(Heading_t& heading, double value, double stddev);
+void setCartesianCoordinate(CartesianCoordinateWithConfidence_t& coordinate, double value, double stddev);
+void setVelocityComponent(VelocityComponent_t& velocity, double value, double stddev);
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_BUILDER_HPP_ */
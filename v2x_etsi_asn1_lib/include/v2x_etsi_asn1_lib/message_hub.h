@@ -0,0 +1,97 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_HUB_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_HUB_HPP_
+
+#include <v2x_etsi_asn1_lib/message_types.h>
+#include <asn_application.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Decoded message passed on by a MessageHub. The message and its metadata are shared by all subscribers.
+struct HubMessage
+{
+  const asn_TYPE_descriptor_t* type{};
+  std::shared_ptr<const void> msg;
+  std::shared_ptr<const BinaryETSIMessage> msg_bin;
+
+  // The message as T, nullptr if it is not of the given type
+  template <class T>
+  [[nodiscard]] std::shared_ptr<const T> get(const asn_TYPE_descriptor_t& expected_type) const
+  {
+    return type == &expected_type ? std::static_pointer_cast<const T>(msg) : nullptr;
+  }
+};
+
+// Selects the messages of a subscription, empty lists match everything
+struct HubFilter
+{
+  std::vector<ETSIMessageType> message_types;
+  std::vector<StationId_t> station_ids;
+  // only messages to this station or without destination
+  std::optional<StationId_t> destination_station_id;
+
+  [[nodiscard]] bool matches(const BinaryETSIMessage& msg_bin) const;
+};
+
+// Bounded queue of the messages of one subscriber. If it is full, the oldest message is dropped, so that a slow
+// subscriber never blocks the receiver thread or the other subscribers.
+class HubSubscription
+{
+public:
+  HubSubscription(HubFilter filter, size_t capacity);
+
+  // Waits up to timeout for the next message. Returns false if there was none or the subscription has been closed.
+  bool pop(HubMessage& message, std::chrono::milliseconds timeout);
+  bool tryPop(HubMessage& message);
+  // Wakes up pop(), no further messages are queued
+  void close();
+
+  [[nodiscard]] const HubFilter& filter() const;
+  [[nodiscard]] uint64_t numDropped() const;
+
+private:
+  friend class MessageHub;
+  void push(const HubMessage& message);
+
+  const HubFilter filter_;
+  const size_t capacity_;
+  mutable std::mutex lock_;
+  std::condition_variable ready_;
+  std::deque<HubMessage> queue_;
+  bool closed_ = false;
+  uint64_t num_dropped_ = 0;
+};
+
+// Fans out decoded messages to any number of in-process subscribers (e.g. fusion, logging, HMI), so that they share
+// one connection and one decoding per message instead of using a transceiver each.
+// subscribe() and unsubscribe() may be called from any thread, also while messages are published.
+class MessageHub
+{
+public:
+  MessageHub();
+
+  std::shared_ptr<HubSubscription> subscribe(HubFilter filter = {}, size_t capacity = 1024);
+  // Removes and closes the subscription
+  void unsubscribe(const std::shared_ptr<HubSubscription>& subscription);
+  // Queues the message for all subscribers whose filter matches it
+  void publish(const HubMessage& message) const;
+  [[nodiscard]] bool hasSubscribers() const;
+
+private:
+  using Subscriptions = std::vector<std::shared_ptr<HubSubscription>>;
+
+  mutable std::mutex lock_;
+  // replaced on every change, so that publish() only holds the lock to copy the pointer
+  std::shared_ptr<const Subscriptions> subscriptions_;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_HUB_HPP_ */
@@ -0,0 +1,46 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_TYPES_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_TYPES_HPP_
+
+#include <StationId.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace enums
+{
+enum ETSIMessageType_t
+{
+  DENM = 2048,
+  CPM = 2049,
+  CAM = 2050,
+  VAM = 2051,
+  MCM = 2052,
+};
+}
+using ETSIMessageType = enums::ETSIMessageType_t;
+
+// ASN.1 encoding rules used for the payload. UPER is mandatory on the radio, the others can be used on wired links
+// where CPU time matters more than size.
+enum class WireEncoding : uint8_t
+{
+  UPER,
+  APER,
+  OER,
+};
+
+struct BinaryETSIMessage
+{
+  ETSIMessageType message_type{};
+  StationId_t station_id{};
+  std::optional<StationId_t> destination_station_id{};
+  std::chrono::system_clock::time_point time{};
+  std::vector<uint8_t> data{};
+  WireEncoding encoding = WireEncoding::UPER;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_MESSAGE_TYPES_HPP_ */
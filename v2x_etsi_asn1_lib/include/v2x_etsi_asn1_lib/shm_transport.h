@@ -0,0 +1,66 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_SHM_TRANSPORT_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_SHM_TRANSPORT_HPP_
+
+#include <v2x_etsi_asn1_lib/transport.h>
+
+#include <atomic>
+#include <string>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+struct ShmRingHeader;
+struct ShmSlot;
+
+// Transport between processes on the same host using a ring buffer in POSIX shared memory, so that no broker,
+// AMQP encoding or socket is involved. Traffic to other hosts still has to go through an AMQPTransport.
+//
+// Any number of processes may open the same ring and send or receive on it. Every receiver gets every message
+// sent after it opened the ring, except for the messages sent through the same ShmTransport instance. Messages
+// are delivered as BinaryETSIMessage and dropped by the receiver if their TTL has expired.
+// Receivers do not hold back senders: a receiver falling behind by more than num_slots messages loses the oldest
+// ones, which is counted in numLost(). A sender which stalls for a whole lap of the ring while writing a slot
+// briefly holds back the sender of the next lap, which drops its message if the slot does not become free.
+class ShmTransport : public ETSITransport
+{
+public:
+  // Opens the ring with the given name, creating it if it does not exist yet. All processes have to use the same
+  // num_slots and max_message_size. Returns nullptr if the ring cannot be opened.
+  static std::shared_ptr<ShmTransport> open(std::string name,
+                                            size_t num_slots = 1024,
+                                            size_t max_message_size = 2048);
+  // Removes the ring, processes which have opened it can continue to use it
+  static bool remove(std::string name);
+
+  ShmTransport(const ShmTransport&) = delete;
+  ShmTransport& operator=(const ShmTransport&) = delete;
+  ~ShmTransport() override;
+
+  bool send(const OutgoingETSIMessage& message) override;
+  bool receive(ETSIMessageSink& sink) override;
+  bool is_sender_connected() override;
+  void close() override;
+
+  // Receives the next message if one is available, without waiting
+  bool tryReceive(BinaryETSIMessage& message);
+  [[nodiscard]] uint64_t numLost() const;
+
+private:
+  ShmTransport(void* memory, size_t mapped_size);
+
+  ShmSlot& slot(uint64_t seq) const;
+  // Takes exclusive ownership of the slot for writing message seq, returns false if that is not possible
+  static bool claim(ShmSlot& s, uint64_t seq);
+  // Moves the read position forward if the writers have overtaken it, returns true if it was moved
+  bool skipOverwritten();
+
+  void* memory_;
+  const size_t mapped_size_;
+  ShmRingHeader* header_;
+  const uint64_t writer_id_;
+  uint64_t read_seq_;
+  std::atomic<uint64_t> num_lost_ = 0;
+  std::atomic<bool> closed_ = false;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_SHM_TRANSPORT_HPP_ */
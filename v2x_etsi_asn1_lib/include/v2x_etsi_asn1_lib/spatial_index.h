@@ -0,0 +1,106 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_SPATIAL_INDEX_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_SPATIAL_INDEX_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Point in a local east-north frame, in metres
+struct LocalPoint
+{
+  double x{};
+  double y{};
+};
+
+// Equirectangular projection into a local east-north frame around an origin, which is accurate enough for a few
+// kilometres around the origin
+class LocalProjection
+{
+public:
+  LocalProjection(double origin_latitude, double origin_longitude);
+
+  [[nodiscard]] LocalPoint toLocal(double latitude, double longitude) const;
+
+private:
+  double origin_latitude_;
+  double origin_longitude_;
+  double meters_per_deg_lat_;
+  double meters_per_deg_lon_;
+};
+
+struct SpatialEntity
+{
+  enum class Kind : uint8_t
+  {
+    Station,
+    PerceivedObject,
+  };
+  Kind kind{};
+  uint32_t station_id{};  // for perceived objects: the station which perceived the object
+  uint16_t object_id{};
+  LocalPoint position{};
+  std::chrono::steady_clock::time_point update_time{};
+};
+
+// Uniform grid over the positions of received stations and perceived objects.
+// Positions are projected into a local east-north frame around the given origin with a LocalProjection. Entries are
+// updated in place when a station or object is reported again, and are dropped once they were not updated for max_age.
+// Thread-safe: updates take an exclusive lock, queries a shared lock.
+class SpatialIndex
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  SpatialIndex(double origin_latitude, double origin_longitude, double cell_size, std::chrono::nanoseconds max_age);
+
+  [[nodiscard]] LocalPoint toLocal(double latitude, double longitude) const;
+
+  void updateStation(uint32_t station_id, LocalPoint position, Clock::time_point now = Clock::now());
+  void updateObject(uint32_t station_id, uint16_t object_id, LocalPoint position, Clock::time_point now = Clock::now());
+  // Updates many entities with a single lock
+  void update(const std::vector<SpatialEntity>& entities);
+  void expire(Clock::time_point now = Clock::now());
+
+  [[nodiscard]] std::vector<SpatialEntity> queryRadius(LocalPoint center,
+                                                       double radius,
+                                                       Clock::time_point now = Clock::now()) const;
+  // polygon: vertices in order (closing edge is implicit), e.g. the outline of a corridor
+  [[nodiscard]] std::vector<SpatialEntity> queryPolygon(const std::vector<LocalPoint>& polygon,
+                                                        Clock::time_point now = Clock::now()) const;
+  [[nodiscard]] size_t size() const;
+
+private:
+  static uint64_t entityKey(SpatialEntity::Kind kind, uint32_t station_id, uint16_t object_id);
+  [[nodiscard]] int64_t cellKey(int64_t cx, int64_t cy) const;
+  [[nodiscard]] int64_t cellCoord(double v) const;
+  void updateLocked(const SpatialEntity& entity);
+  void removeFromCell(int64_t cell, uint32_t idx);
+  void expireLocked(Clock::time_point now);
+  template <class Predicate>
+  std::vector<SpatialEntity> queryBox(LocalPoint min, LocalPoint max, Clock::time_point now, Predicate pred) const;
+
+  struct Entry
+  {
+    SpatialEntity entity;
+    int64_t cell{};
+    bool used = false;
+  };
+
+  const LocalProjection projection_;
+  const double cell_size_;
+  const Clock::duration max_age_;
+
+  mutable std::shared_mutex lock_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> free_entries_;
+  std::unordered_map<uint64_t, uint32_t> entry_index_;
+  std::unordered_map<int64_t, std::vector<uint32_t>> cells_;
+  Clock::time_point last_expiry_{};
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_SPATIAL_INDEX_HPP_ */
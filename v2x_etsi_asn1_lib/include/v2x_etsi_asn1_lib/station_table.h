@@ -0,0 +1,88 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_STATION_TABLE_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_STATION_TABLE_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <v2x_etsi_asn1_lib/message_types.h>
+#include <CAM.h>
+#include <MCM.h>
+#include <VAM.h>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Latest state of a station, taken from its most recent CAM, VAM or MCM.
+// Values are converted to SI units using the scale factors from units.h, angles are in degrees as defined by ETSI
+// (0 = north, clockwise). Unavailable values are NaN.
+struct StationState
+{
+  uint32_t station_id{};
+  ETSIMessageType message_type{};  // type of the message this state was taken from
+  int32_t station_type{};
+  uint64_t time{};  // generation time in unix nanoseconds
+  double latitude{};
+  double longitude{};
+  double altitude{};
+  double heading{};
+  double speed{};
+  double yaw_rate{};
+  double longitudinal_acceleration{};
+  double length{};
+  double width{};
+};
+
+StationState stationStateFromCAM(const CAM& msg, uint64_t now_unix_time);
+StationState stationStateFromVAM(const VAM& msg, uint64_t now_unix_time);
+StationState stationStateFromMCM(const MCM& msg, uint64_t now_unix_time);
+
+// Fixed-capacity table holding the latest state per station.
+// There must be only a single writer (the receiver thread), but any number of concurrent readers. Each slot is
+// protected by a sequence lock: readers never block the writer and only retry if the slot they read was updated at
+// the same time. Stations which were not updated for more than max_age are treated as absent, and their slots are
+// reused for new stations.
+class StationTable
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Sized for the expected number of stations at a load factor of at most 50%, so that probe sequences stay short
+  StationTable(size_t num_stations, std::chrono::nanoseconds max_age);
+
+  // Returns false if all capacity() slots are taken by stations which are not expired
+  bool update(const StationState& state, Clock::time_point now = Clock::now());
+
+  [[nodiscard]] std::optional<StationState> get(uint32_t station_id, Clock::time_point now = Clock::now()) const;
+  // Consistent per station, but stations may be updated while the snapshot is taken
+  [[nodiscard]] std::vector<StationState> snapshot(Clock::time_point now = Clock::now()) const;
+
+  // Number of slots, i.e. the maximum number of stations, which is at least twice num_stations
+  [[nodiscard]] size_t capacity() const;
+
+private:
+  static constexpr size_t num_words = (sizeof(StationState) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  struct alignas(64) Slot
+  {
+    // station_id + 1, 0 for empty slots. Keys are only replaced, never cleared, so probe sequences stay intact.
+    std::atomic<uint64_t> key = 0;
+    std::atomic<uint32_t> seq = 0;
+    std::atomic<int64_t> update_time = 0;
+    std::array<std::atomic<uint64_t>, num_words> data{};
+  };
+
+  [[nodiscard]] bool isExpired(const Slot& slot, Clock::time_point now) const;
+  void write(Slot& slot, uint64_t key, const StationState& state, Clock::time_point now);
+  bool read(const Slot& slot, uint64_t key, StationState& state) const;
+
+  const size_t mask_;
+  const int64_t max_age_ns_;
+  std::unique_ptr<Slot[]> slots_;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_STATION_TABLE_HPP_ */
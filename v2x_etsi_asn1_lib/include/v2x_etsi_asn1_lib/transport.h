@@ -0,0 +1,122 @@
+#ifndef LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_TRANSPORT_HPP_
+#define LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_TRANSPORT_HPP_
+
+#include <v2x_amqp_connector_lib/v2x_amqp_connector_lib.h>
+#include <v2x_etsi_asn1_lib/message_types.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+// Priority classes of outgoing messages, each with its own send lane in transports which queue messages
+enum class SendPriority : uint8_t
+{
+  High,
+  Normal,
+  Low,
+};
+constexpr size_t num_send_priorities = 3;
+
+// Called with whether a sent message was delivered, see OutgoingETSIMessage::on_settled
+using SettleCallback = std::function<void(bool accepted)>;
+
+// Encoded message to be sent, referencing the payload of the caller
+struct OutgoingETSIMessage
+{
+  ETSIMessageType message_type{};
+  std::string_view subject{};
+  StationId_t station_id{};
+  std::optional<StationId_t> destination_station_id{};
+  std::chrono::system_clock::time_point time{};
+  // also the deadline for sending, queued messages are dropped after it
+  std::chrono::milliseconds ttl{};
+  SendPriority priority = SendPriority::Normal;
+  const uint8_t* data{};
+  size_t size{};
+  WireEncoding encoding = WireEncoding::UPER;
+  // additional string properties for selectors, e.g. the quadkeys of the sender position
+  std::vector<std::pair<std::string, std::string>> properties{};
+  // If set and send() returns true, called once with whether the message was delivered: by the AMQP transport when
+  // the broker settled it, by the other transports right away
+  SettleCallback on_settled{};
+};
+
+// Receives the messages of a transport. Transports carrying AMQP messages pass them on as they are, so that the
+// receiver checks the properties; transports carrying the message metadata themselves pass BinaryETSIMessages.
+class ETSIMessageSink
+{
+public:
+  virtual ~ETSIMessageSink() = default;
+  virtual void deliver(const proton::message& message) = 0;
+  virtual void deliver(const BinaryETSIMessage& message) = 0;
+};
+
+// Moves encoded ETSI messages between ETSIAMQPTransceiverBase instances.
+// send() may be called from any thread, receive() is called from the receiver thread of the transceiver only.
+class ETSITransport
+{
+public:
+  virtual ~ETSITransport() = default;
+  virtual bool send(const OutgoingETSIMessage& message) = 0;
+  // Sends the messages in the given order and returns the number of sent messages. Transports which queue outgoing
+  // messages take the whole batch at once.
+  virtual size_t sendBatch(const std::vector<OutgoingETSIMessage>& messages)
+  {
+    size_t num_sent = 0;
+    for (const auto& message : messages)
+    {
+      num_sent += send(message) ? 1 : 0;
+    }
+    return num_sent;
+  }
+  // Waits for the next message and passes it to the sink. Returns false once the transport has been closed.
+  // May return true without delivering a message.
+  virtual bool receive(ETSIMessageSink& sink) = 0;
+  virtual bool is_sender_connected() = 0;
+  // Makes receive() return false, called before the receiver thread is joined
+  virtual void close() = 0;
+  // Replaces the selector for received messages at runtime. Returns false if the transport does not support
+  // selectors.
+  virtual bool setFilter(const std::string& filter_query)
+  {
+    return false;
+  }
+  // Statistics of the send lanes (one per SendPriority), empty if the transport does not queue outgoing messages
+  virtual std::vector<mrm::v2x_amqp_connector_lib::SendLaneStats> sendLaneStats()
+  {
+    return {};
+  }
+};
+
+// Builds the AMQP message with the properties expected by ETSIAMQPTransceiverBase::handleMessage()
+proton::message makeProtonMessage(const OutgoingETSIMessage& message);
+
+// Transport using an AMQP broker. Outgoing messages are queued in one lane per SendPriority, which are drained in the
+// given order as the broker grants credit.
+class AMQPTransport : public ETSITransport
+{
+public:
+  explicit AMQPTransport(std::unique_ptr<mrm::v2x_amqp_connector_lib::AMQPClient> client,
+                         mrm::v2x_amqp_connector_lib::LaneScheduling scheduling =
+                             mrm::v2x_amqp_connector_lib::LaneScheduling::StrictPriority,
+                         std::vector<uint32_t> weights = {});
+
+  bool send(const OutgoingETSIMessage& message) override;
+  size_t sendBatch(const std::vector<OutgoingETSIMessage>& messages) override;
+  bool receive(ETSIMessageSink& sink) override;
+  bool is_sender_connected() override;
+  void close() override;
+  bool setFilter(const std::string& filter_query) override;
+  std::vector<mrm::v2x_amqp_connector_lib::SendLaneStats> sendLaneStats() override;
+
+private:
+  std::unique_ptr<mrm::v2x_amqp_connector_lib::AMQPClient> client_;
+};
+}  // namespace mrm::v2x_etsi_asn1_lib
+
+#endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_TRANSPORT_HPP_ */
@@ -80,3 +80,93 @@ static constexpr double MessageRateHzUnit_Hz = 1;
 static constexpr double MitigationPerTechnologyClassUnit_ms = 1;
 static constexpr double PredictionDistanceConfidenceUnit_metre = 0.1;
 static constexpr double DistanceOffsetUnit_metre = 0.01;
+
+struct UnitScale
+{
+  const char* type_name;
+  double scale;
+};
+static constexpr UnitScale unit_scales[] = {
+  { "AccelerationConfidence", AccelerationConfidenceUnit_m_s_2 },
+  { "AccelerationMagnitudeValue", AccelerationMagnitudeValueUnit_m_s_2 },
+  { "AccelerationValue", AccelerationValueUnit_m_s_2 },
+  { "AirHumidity", AirHumidityUnit_ },
+  { "AltitudeValue", AltitudeValueUnit_metre },
+  { "AngleConfidence", AngleConfidenceUnit_degrees },
+  { "AxlesCount", AxlesCountUnit_Number_of_axles },
+  { "BarometricPressure", BarometricPressureUnit_Pascal },
+  { "BogiesCount", BogiesCountUnit_Number_of_bogies },
+  { "CartesianAngleValue", CartesianAngleValueUnit_degrees },
+  { "CartesianAngularAccelerationComponentValue",
+    CartesianAngularAccelerationComponentValueUnit_degree_s_2_degrees_per_second_squared_ },
+  { "CartesianAngularVelocityComponentValue", CartesianAngularVelocityComponentValueUnit_degree_s },
+  { "CartesianCoordinateSmall", CartesianCoordinateSmallUnit_m },
+  { "CartesianCoordinate", CartesianCoordinateUnit_m },
+  { "CartesianCoordinateLarge", CartesianCoordinateLargeUnit_m },
+  { "ConfidenceLevel", ConfidenceLevelUnit_ },
+  { "CoordinateConfidence", CoordinateConfidenceUnit_m },
+  { "CorrelationCellValue", CorrelationCellValueUnit_ },
+  { "CurvatureValue", CurvatureValueUnit_metres },
+  { "DeltaAltitude", DeltaAltitudeUnit_metre },
+  { "DeltaLatitude", DeltaLatitudeUnit_degree },
+  { "DeltaLongitude", DeltaLongitudeUnit_degree },
+  { "DeltaTimeMilliSecondPositive", DeltaTimeMilliSecondPositiveUnit_s },
+  { "DeltaTimeMilliSecondSigned", DeltaTimeMilliSecondSignedUnit_s },
+  { "DeltaTimeQuarterSecond", DeltaTimeQuarterSecondUnit_0_001_s },
+  { "DeltaTimeTenthOfSecond", DeltaTimeTenthOfSecondUnit_s },
+  { "DeltaTimeSecond", DeltaTimeSecondUnit_s },
+  { "DeltaTimeTenSeconds", DeltaTimeTenSecondsUnit_s },
+  { "HeadingConfidence", HeadingConfidenceUnit_degree },
+  { "HeadingValue", HeadingValueUnit_degree },
+  { "HeightLonCarr", HeightLonCarrUnit_metre },
+  { "LaneWidth", LaneWidthUnit_metre },
+  { "Latitude", LatitudeUnit_degree },
+  { "LateralAccelerationValue", LateralAccelerationValueUnit_m_s_2 },
+  { "Longitude", LongitudeUnit_degree },
+  { "LongitudinalAccelerationValue", LongitudinalAccelerationValueUnit_m_s_2 },
+  { "LongitudinalLanePositionValue", LongitudinalLanePositionValueUnit_metre },
+  { "LongitudinalLanePositionConfidence", LongitudinalLanePositionConfidenceUnit_metre },
+  { "NumberOfOccupants", NumberOfOccupantsUnit_person },
+  { "ObjectPerceptionQuality", ObjectPerceptionQualityUnit_n_a },
+  { "ObjectDimensionValue", ObjectDimensionValueUnit_m },
+  { "ObjectDimensionConfidence", ObjectDimensionConfidenceUnit_m },
+  { "PathDeltaTime", PathDeltaTimeUnit_second },
+  { "PosCentMass", PosCentMassUnit_metre },
+  { "PosFrontAx", PosFrontAxUnit_metre },
+  { "Position1d", Position1dUnit_metre },
+  { "PosLonCarr", PosLonCarrUnit_metre },
+  { "PosPillar", PosPillarUnit_metre },
+  { "PrecipitationIntensity", PrecipitationIntensityUnit_mm_h },
+  { "ProtectedZoneRadius", ProtectedZoneRadiusUnit_metre },
+  { "SemiAxisLength", SemiAxisLengthUnit_metre },
+  { "SpeedConfidence", SpeedConfidenceUnit_m_s },
+  { "SpeedLimit", SpeedLimitUnit_km_h },
+  { "SpeedValue", SpeedValueUnit_m_s },
+  { "VelocityComponentValue", VelocityComponentValueUnit_m_s },
+  { "StabilityLossProbability", StabilityLossProbabilityUnit_ },
+  { "StandardLength12b", StandardLength12bUnit_metre },
+  { "StandardLength9b", StandardLength9bUnit_metre },
+  { "StandardLength1B", StandardLength1BUnit_metre },
+  { "StandardLength2B", StandardLength2BUnit_metre },
+  { "SteeringWheelAngleConfidence", SteeringWheelAngleConfidenceUnit_degree },
+  { "SteeringWheelAngleValue", SteeringWheelAngleValueUnit_degree },
+  { "Temperature", TemperatureUnit_degrees_Celsius },
+  { "TimestampIts", TimestampItsUnit_s },
+  { "TrajectoryInterceptionProbability", TrajectoryInterceptionProbabilityUnit_ },
+  { "TransmissionInterval", TransmissionIntervalUnit_s },
+  { "TurningRadius", TurningRadiusUnit_metre },
+  { "ValidityDuration", ValidityDurationUnit_s },
+  { "VehicleHeight", VehicleHeightUnit_metre },
+  { "VehicleLengthValue", VehicleLengthValueUnit_metre },
+  { "VehicleMass", VehicleMassUnit_gramm },
+  { "VehicleWidth", VehicleWidthUnit_metre },
+  { "VerticalAccelerationValue", VerticalAccelerationValueUnit_m_s_2 },
+  { "WheelBaseVehicle", WheelBaseVehicleUnit_metre },
+  { "Wgs84AngleConfidence", Wgs84AngleConfidenceUnit_degrees },
+  { "Wgs84AngleValue", Wgs84AngleValueUnit_degrees },
+  { "YawRateValue", YawRateValueUnit_degree_per_second_ },
+  { "MessageRateHz", MessageRateHzUnit_Hz },
+  { "MitigationPerTechnologyClass", MitigationPerTechnologyClassUnit_ms },
+  { "PredictionDistanceConfidence", PredictionDistanceConfidenceUnit_metre },
+  { "DistanceOffset", DistanceOffsetUnit_metre },
+};
@@ -4,55 +4,134 @@
 #include <aduulm_logger/aduulm_logger.hpp>
 #include <v2x_amqp_connector_lib/v2x_amqp_connector_lib.h>
 #include <v2x_etsi_asn1_lib/time_conversions.h>
+#include <v2x_etsi_asn1_lib/cpm_decoder.h>
+#include <v2x_etsi_asn1_lib/decode_limits.h>
+#include <v2x_etsi_asn1_lib/duplicate_filter.h>
+#include <v2x_etsi_asn1_lib/geo_tiles.h>
+#include <v2x_etsi_asn1_lib/message_hub.h>
+#include <v2x_etsi_asn1_lib/message_types.h>
+#include <v2x_etsi_asn1_lib/spatial_index.h>
+#include <v2x_etsi_asn1_lib/station_table.h>
+#include <v2x_etsi_asn1_lib/transport.h>
 #include <CollectivePerceptionMessage.h>
 #include <CAM.h>
 #include <MCM.h>
 #include <VAM.h>
 
+#include <array>
+#include <atomic>
+
 namespace mrm::v2x_etsi_asn1_lib
 {
-namespace enums
-{
-enum ETSIMessageType_t
+// Frees asn1c structs owned by a shared_ptr
+template <class T>
+struct ASNStructDeleter
 {
-  DENM = 2048,
-  CPM = 2049,
-  CAM = 2050,
-  VAM = 2051,
-  MCM = 2052,
+  const asn_TYPE_descriptor_t* type;
+  void operator()(T* msg) const
+  {
+    ASN_STRUCT_FREE(*type, msg);
+  }
 };
+
+template <class T>
+static inline std::shared_ptr<T> allocateETSIMsg(const asn_TYPE_descriptor_t& type)
+{
+  return { static_cast<T*>(calloc(1, sizeof(T))), ASNStructDeleter<T>{ &type } };
 }
-using ETSIMessageType = enums::ETSIMessageType_t;
 
-struct BinaryETSIMessage
+// Type-erased handler for decoded messages of one message type
+struct ETSIMessageHandler
 {
-  ETSIMessageType message_type{};
-  StationId_t station_id{};
-  std::optional<StationId_t> destination_station_id{};
-  std::chrono::system_clock::time_point time{};
-  std::vector<uint8_t> data{};
+  const asn_TYPE_descriptor_t* type{};
+  // msg is shared with the subscribers of the message hub, if any
+  void (*dispatch)(const ETSIMessageHandler& handler,
+                   const std::shared_ptr<const void>& msg,
+                   const BinaryETSIMessage& msg_bin){};
+  std::shared_ptr<void> callable;
+  std::string subject;
+  DecodeLimits limits;
+  SendPriority priority = SendPriority::Normal;
 };
 
-template <class T>
-static inline std::shared_ptr<T> allocateETSIMsg(const asn_TYPE_descriptor_t& type)
+// Message sent on behalf of one of several stations, see ETSIAMQPTransceiverBase::sendETSIMsgBatch()
+struct StationETSIMessage
 {
-  return { static_cast<T*>(calloc(1, sizeof(T))), [type](T* msg) { ASN_STRUCT_FREE(type, msg); } };
-}
+  StationId_t station_id{};
+  const asn_TYPE_descriptor_t* type{};
+  ETSIMessageType message_type{};
+  void* msg{};
+  std::optional<StationId_t> destination_station_id{};
+};
 
-class ETSIAMQPTransceiverBase
+class ETSIAMQPTransceiverBase : private ETSIMessageSink
 {
 public:
   ETSIAMQPTransceiverBase();
   virtual ~ETSIAMQPTransceiverBase();
 
+  // See AMQPClient for the meaning of credit_window and adaptive_credit
   void connect(StationId_t station_id,
                std::string url,
                std::string address_rx,
                std::string address_tx,
                std::string user,
                std::string pw,
-               std::string filter_query = "");
+               std::string filter_query = "",
+               uint32_t credit_window = mrm::v2x_amqp_connector_lib::AMQPClient::default_credit_window,
+               bool adaptive_credit = false);
+  // Uses the given transport instead of connecting to an AMQP broker, e.g. a ShmTransport
+  void connect(StationId_t station_id, std::shared_ptr<ETSITransport> transport);
   void disconnect();
+  // Drops messages whose exact copy was already received within the given time window before decoding them.
+  // Must be called before connect().
+  void enableDuplicateSuppression(std::chrono::milliseconds window = std::chrono::seconds(1),
+                                  size_t capacity = 4096);
+  [[nodiscard]] uint64_t numSuppressedDuplicates() const;
+  // Keeps the latest state of every station sending CAMs, VAMs or MCMs in a table which can be read from other
+  // threads without locking. Must be called before connect().
+  void enableStationTable(size_t num_stations = 1024, std::chrono::milliseconds max_age = std::chrono::seconds(5));
+  [[nodiscard]] std::shared_ptr<const StationTable> stationTable() const;
+  // Indexes the positions of stations (from CAMs and VAMs) and perceived objects (from CPMs) in a grid in a local
+  // east-north frame around the given origin. Must be called before connect().
+  void enableSpatialIndex(double origin_latitude,
+                          double origin_longitude,
+                          double cell_size = 50.0,
+                          std::chrono::milliseconds max_age = std::chrono::seconds(2));
+  [[nodiscard]] std::shared_ptr<const SpatialIndex> spatialIndex() const;
+  // Passes every decoded message to the subscribers of the returned hub in addition to the handler, so that several
+  // components of a process can share this connection and the decoded messages. Must be called before connect().
+  std::shared_ptr<MessageHub> enableMessageHub();
+  // Decodes only the CPM containers selected in container_mask (see cpmContainerMask()), e.g. only the
+  // PerceivedObjectContainers or, with a mask of 0, only the management container. The other containers are not
+  // part of the messages passed to handleCPM(), but can be decoded from msg_bin.data with findCpmContainers() and
+  // decodeCpmContainer(). Only applies to UPER encoded messages. Must be called before connect().
+  void enableSelectiveCPMDecoding(uint32_t container_mask);
+  // Resource limits for decoding messages of the given type, see defaultDecodeLimits() for the defaults. Messages
+  // exceeding them are dropped and counted. The message type has to be listed in type2str or registered with
+  // registerHandler() before, otherwise false is returned. Must be called before connect().
+  bool setDecodeLimits(ETSIMessageType message_type, const DecodeLimits& limits);
+  [[nodiscard]] uint64_t numRejectedMessages() const;
+  // Encoding used by sendETSIMsg(), UPER by default. Receivers detect the encoding from the message, so this only
+  // has to be changed on the sending side, e.g. for links between backend servers.
+  void setWireEncoding(WireEncoding encoding);
+  [[nodiscard]] WireEncoding wireEncoding() const;
+  // Adds the quadkeys of the reference position at the given zoom levels to sent messages (see geo_tiles.h), so that
+  // receivers can select messages by area at the broker. sendETSIMsg() takes the reference position of CAMs, VAMs
+  // and CPMs, sendEncodedETSIMsg() the given one. Must be called before connect().
+  void enableGeoTileProperties(std::vector<unsigned> zoom_levels = { 10, 13, 16 });
+  // Replaces the selector given to connect() at runtime without dropping the connection, e.g. with quadkeySelector()
+  // around the current position. Returns false if the transport does not support selectors.
+  bool setReceiveFilter(const std::string& filter_query);
+  // Priority class of sent messages of the given type. By default DENMs are sent with high priority, CPMs with low
+  // priority and all other messages with normal priority, so that CPM bursts do not delay CAMs or MCMs. Like for
+  // setDecodeLimits(), the message type has to be known. Must be called before connect().
+  bool setSendPriority(ETSIMessageType message_type, SendPriority priority);
+  // Order in which the send lanes of the priority classes are drained by the AMQP transport, weights are given per
+  // SendPriority. Must be called before connect().
+  void setSendScheduling(mrm::v2x_amqp_connector_lib::LaneScheduling scheduling, std::vector<uint32_t> weights = {});
+  // Queue depth and drop counters per SendPriority, empty if the transport does not queue outgoing messages
+  [[nodiscard]] std::vector<mrm::v2x_amqp_connector_lib::SendLaneStats> sendLaneStats() const;
   bool sendETSIMsg(const asn_TYPE_descriptor_t* type,
                    ETSIMessageType message_type,
                    void* pMsg,
@@ -60,7 +139,41 @@ public:
   bool sendEncodedETSIMsg(const char* buffer,
                           size_t size,
                           ETSIMessageType message_type,
-                          std::optional<StationId_t> destination_station_id = {});
+                          std::optional<StationId_t> destination_station_id = {},
+                          WireEncoding encoding = WireEncoding::UPER,
+                          std::optional<GeoPosition> reference_position = {});
+  // Like sendETSIMsg() and sendEncodedETSIMsg(), but on behalf of the given station instead of the one passed to
+  // connect(), so that one connection can carry the messages of many simulated stations. The station ID in the
+  // message header is not changed. If true is returned, on_settled is called once the transport delivered the
+  // message (see OutgoingETSIMessage::on_settled).
+  bool sendETSIMsgAs(StationId_t station_id,
+                     const asn_TYPE_descriptor_t* type,
+                     ETSIMessageType message_type,
+                     void* pMsg,
+                     std::optional<StationId_t> destination_station_id = {},
+                     SettleCallback on_settled = {});
+  bool sendEncodedETSIMsgAs(StationId_t station_id,
+                            const char* buffer,
+                            size_t size,
+                            ETSIMessageType message_type,
+                            std::optional<StationId_t> destination_station_id = {},
+                            WireEncoding encoding = WireEncoding::UPER,
+                            std::optional<GeoPosition> reference_position = {},
+                            SettleCallback on_settled = {});
+  // Encodes the messages of any number of stations and hands them to the transport at once, e.g. one simulation step
+  // of all vehicles. Messages which cannot be encoded are skipped. Returns the number of sent messages.
+  size_t sendETSIMsgBatch(const std::vector<StationETSIMessage>& messages);
+
+  // Registers a handler for the given message type, replacing any existing handler (including the built-in ones
+  // calling handleCAM() etc.), but keeping its decode limits. The handler is called as
+  // handler(const std::shared_ptr<const T>&, const BinaryETSIMessage&) from the receiver thread. For message types not
+  // listed in type2str, a subject has to be given, which is used as the AMQP message subject. Returns false without
+  // registering the handler if it is missing. Must be called before connect().
+  template <class T, class F>
+  bool registerHandler(const asn_TYPE_descriptor_t& type,
+                       ETSIMessageType message_type,
+                       F&& handler,
+                       std::string subject = "");
 
   static uint64_t decodeTimestampIts(const TimestampIts_t* timestamp);
   static void encodeTimestampIts(uint64_t timestamp, TimestampIts_t* timestamp_out);
@@ -81,19 +194,69 @@ protected:
   virtual void handleMessage(const proton::message& message);
   virtual void handleBinaryMessage(const BinaryETSIMessage& message);
 
+  [[nodiscard]] const ETSIMessageHandler* findHandler(ETSIMessageType message_type) const;
+  [[nodiscard]] ETSIMessageHandler* findHandler(ETSIMessageType message_type);
+  bool setHandler(ETSIMessageType message_type, ETSIMessageHandler handler);
+
   StationId_t station_id_;
-  std::map<ETSIMessageType,
-           std::tuple<const asn_TYPE_descriptor_t*,
-                      const std::function<void(std::shared_ptr<void>&, const BinaryETSIMessage&)>>>
-      etsi_msg_handlers_;
+  // Handlers for message types ETSIMessageType::DENM + i, with i < num_dense_handlers
+  static constexpr size_t num_dense_handlers = 64;
+  std::array<ETSIMessageHandler, num_dense_handlers> etsi_msg_handlers_;
+  // Handlers for message types outside of the dense range
+  std::map<uint32_t, ETSIMessageHandler> sparse_msg_handlers_;
 
 private:
-  std::shared_ptr<mrm::v2x_amqp_connector_lib::AMQPClient> client_;
+  void deliver(const proton::message& message) override;
+  void deliver(const BinaryETSIMessage& message) override;
+  // Fills message with the metadata and properties for sending the buffer, returns false if the message type has no
+  // subject
+  bool makeOutgoingMessage(StationId_t station_id,
+                           const char* buffer,
+                           size_t size,
+                           ETSIMessageType message_type,
+                           std::optional<StationId_t> destination_station_id,
+                           WireEncoding encoding,
+                           const std::optional<GeoPosition>& reference_position,
+                           std::chrono::system_clock::time_point time,
+                           OutgoingETSIMessage& message) const;
+
+  std::shared_ptr<ETSITransport> transport_;
   std::shared_ptr<std::thread> receiver_thread_;
+  std::unique_ptr<DuplicateFilter> duplicate_filter_;
+  std::shared_ptr<StationTable> station_table_;
+  std::shared_ptr<SpatialIndex> spatial_index_;
+  std::shared_ptr<MessageHub> message_hub_;
+  std::atomic<WireEncoding> encoding_ = WireEncoding::UPER;
+  std::optional<uint32_t> cpm_container_mask_;
+  std::vector<unsigned> tile_zoom_levels_;
+  mrm::v2x_amqp_connector_lib::LaneScheduling send_scheduling_ =
+      mrm::v2x_amqp_connector_lib::LaneScheduling::StrictPriority;
+  std::vector<uint32_t> send_weights_;
+  std::atomic<uint64_t> num_rejected_messages_ = 0;
 
   std::map<StationId_t, std::map<uint64_t, std::map<uint8_t, std::shared_ptr<const CollectivePerceptionMessage>>>>
       received_cpm_msgs_;
 };
+
+template <class T, class F>
+bool ETSIAMQPTransceiverBase::registerHandler(const asn_TYPE_descriptor_t& type,
+                                              ETSIMessageType message_type,
+                                              F&& handler,
+                                              std::string subject)
+{
+  using Callable = std::decay_t<F>;
+  ETSIMessageHandler entry;
+  entry.type = &type;
+  entry.callable = std::make_shared<Callable>(std::forward<F>(handler));
+  entry.dispatch = [](const ETSIMessageHandler& self,
+                      const std::shared_ptr<const void>& msg,
+                      const BinaryETSIMessage& msg_bin) {
+    const std::shared_ptr<const T> typed_msg(msg, static_cast<const T*>(msg.get()));
+    (*static_cast<Callable*>(self.callable.get()))(typed_msg, msg_bin);
+  };
+  entry.subject = std::move(subject);
+  return setHandler(message_type, std::move(entry));
+}
 }  // namespace mrm::v2x_etsi_asn1_lib
 
 #endif /* LIBRARY_INCLUDE_V2X_ETSI_ASN1_LIB_HPP_ */
@@ -0,0 +1,61 @@
+/*
+ * Allocation budget for the asn1c support code. patch_asn1c_skeleton.cmake redirects the CALLOC, MALLOC and
+ * REALLOC macros of asn_internal.h to the functions below. Outside of asn_alloc_budget_begin()/end(), they behave
+ * like the standard functions. Within, allocations fail once the budget of the calling thread is exhausted, which
+ * makes the decoder return RC_FAIL.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static _Thread_local int budget_active;
+static _Thread_local int budget_exceeded;
+static _Thread_local size_t budget_remaining;
+
+static int budget_take(size_t size)
+{
+  if (!budget_active)
+  {
+    return 1;
+  }
+  if (size > budget_remaining)
+  {
+    budget_exceeded = 1;
+    return 0;
+  }
+  budget_remaining -= size;
+  return 1;
+}
+
+void *asn_budget_calloc(size_t nmemb, size_t size)
+{
+  if (size != 0 && nmemb > SIZE_MAX / size)
+  {
+    return NULL;
+  }
+  return budget_take(nmemb * size) ? calloc(nmemb, size) : NULL;
+}
+
+void *asn_budget_malloc(size_t size)
+{
+  return budget_take(size) ? malloc(size) : NULL;
+}
+
+/* The previous size is unknown, so the full new size is taken from the budget */
+void *asn_budget_realloc(void *ptr, size_t size)
+{
+  return budget_take(size) ? realloc(ptr, size) : NULL;
+}
+
+void asn_alloc_budget_begin(size_t max_bytes)
+{
+  budget_active = 1;
+  budget_exceeded = 0;
+  budget_remaining = max_bytes;
+}
+
+int asn_alloc_budget_end(void)
+{
+  budget_active = 0;
+  return budget_exceeded;
+}
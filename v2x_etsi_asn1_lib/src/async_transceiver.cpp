@@ -0,0 +1,123 @@
+#include "v2x_etsi_asn1_lib/async_transceiver.h"
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+AsyncETSITransceiver::SendAwaiter::SendAwaiter(AsyncETSITransceiver& transceiver,
+                                               StationId_t station_id,
+                                               const asn_TYPE_descriptor_t* type,
+                                               ETSIMessageType message_type,
+                                               void* msg,
+                                               std::optional<StationId_t> destination_station_id)
+  : transceiver_(transceiver)
+  , station_id_(station_id)
+  , type_(type)
+  , message_type_(message_type)
+  , msg_(msg)
+  , destination_station_id_(destination_station_id)
+{
+}
+
+bool AsyncETSITransceiver::SendAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+  handle_ = handle;
+  // the loopback and shared memory transports settle messages while they are being sent, so the callback may run
+  // before the coroutine is suspended; whichever of the two comes last resumes it
+  const bool sent = transceiver_.sendETSIMsgAs(
+      station_id_, type_, message_type_, msg_, destination_station_id_, [this](bool accepted) {
+        accepted_ = accepted;
+        if (state_.exchange(State::Settled) == State::Suspended)
+        {
+          transceiver_.executor_(handle_);
+        }
+      });
+  if (!sent)
+  {
+    return false;
+  }
+  return state_.exchange(State::Suspended) != State::Settled;
+}
+
+AsyncETSITransceiver::AsyncETSITransceiver(Executor executor, size_t queue_capacity)
+  : executor_(executor)
+  , cams_(executor, queue_capacity)
+  , vams_(executor, queue_capacity)
+  , cpms_(executor, queue_capacity)
+  , mcms_(executor, queue_capacity)
+  , complete_cpms_(executor, queue_capacity)
+{
+}
+
+AsyncETSITransceiver::~AsyncETSITransceiver()
+{
+  // the receiver thread must not push to the streams while they are destroyed
+  disconnect();
+  close();
+}
+
+AsyncStream<CompleteCPM>::Awaiter AsyncETSITransceiver::nextCompleteCPM()
+{
+  return complete_cpms_.next();
+}
+
+AsyncETSITransceiver::SendAwaiter AsyncETSITransceiver::send(const asn_TYPE_descriptor_t* type,
+                                                             ETSIMessageType message_type,
+                                                             void* msg,
+                                                             std::optional<StationId_t> destination_station_id)
+{
+  return SendAwaiter(*this, station_id_, type, message_type, msg, destination_station_id);
+}
+
+AsyncETSITransceiver::SendAwaiter AsyncETSITransceiver::sendAs(StationId_t station_id,
+                                                               const asn_TYPE_descriptor_t* type,
+                                                               ETSIMessageType message_type,
+                                                               void* msg,
+                                                               std::optional<StationId_t> destination_station_id)
+{
+  return SendAwaiter(*this, station_id, type, message_type, msg, destination_station_id);
+}
+
+void AsyncETSITransceiver::close()
+{
+  cams_.close();
+  vams_.close();
+  cpms_.close();
+  mcms_.close();
+  complete_cpms_.close();
+}
+
+uint64_t AsyncETSITransceiver::numDropped() const
+{
+  return cams_.numDropped() + vams_.numDropped() + cpms_.numDropped() + mcms_.numDropped() +
+         complete_cpms_.numDropped();
+}
+
+void AsyncETSITransceiver::handleCAM(const std::shared_ptr<const CAM>& msg, const BinaryETSIMessage& msg_bin)
+{
+  cams_.push({ msg, msg_bin });
+}
+
+void AsyncETSITransceiver::handleVAM(const std::shared_ptr<const VAM>& msg, const BinaryETSIMessage& msg_bin)
+{
+  vams_.push({ msg, msg_bin });
+}
+
+void AsyncETSITransceiver::handleCPM(const std::shared_ptr<const CollectivePerceptionMessage>& msg,
+                                     const BinaryETSIMessage& msg_bin)
+{
+  cpms_.push({ msg, msg_bin });
+  // collects the segments and calls handleCompleteCPM()
+  ETSIAMQPTransceiverBase::handleCPM(msg, msg_bin);
+}
+
+void AsyncETSITransceiver::handleCompleteCPM(StationId_t station_id,
+                                             std::map<uint8_t, std::shared_ptr<const CollectivePerceptionMessage>> msgs,
+                                             uint64_t time)
+{
+  complete_cpms_.push({ station_id, std::move(msgs), time });
+}
+
+void AsyncETSITransceiver::handleMCM(const std::shared_ptr<const MCM>& msg, const BinaryETSIMessage& msg_bin)
+{
+  mcms_.push({ msg, msg_bin });
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,436 @@
+#include "v2x_etsi_asn1_lib/cpm_covariance.h"
+#include "v2x_etsi_asn1_lib/units.h"
+#include <aduulm_logger/aduulm_logger.hpp>
+
+#include <LowerTriangularPositiveSemidefiniteMatrices.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr size_t dim = num_covariance_components;
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+constexpr double confidence95 = 1.96;
+constexpr double deg_to_rad = M_PI / 180.0;
+
+enum class ConfidenceKind : uint8_t
+{
+  Coordinate,
+  Speed,
+  Acceleration,
+  Angle,
+  AngularSpeed,
+  Dimension,
+};
+
+struct ConfidenceType
+{
+  // SI units (or degrees) per confidence unit, confidences are 95 % intervals
+  double unit;
+  bool angle;
+  long min;
+  // the unavailable value follows outOfRange for all confidence types
+  long out_of_range;
+};
+
+const ConfidenceType confidence_types[] = {
+  { CoordinateConfidenceUnit_m, false, 1, CoordinateConfidence_outOfRange },
+  { SpeedConfidenceUnit_m_s, false, 1, SpeedConfidence_outOfRange },
+  { AccelerationConfidenceUnit_m_s_2, false, 0, AccelerationConfidence_outOfRange },
+  { AngleConfidenceUnit_degrees, true, 1, AngleConfidence_outOfRange },
+  // in deg/s, AngularSpeedConfidence is converted with angular_speed_classes
+  { 1.0, true, AngularSpeedConfidence_degSec_01, AngularSpeedConfidence_outOfRange },
+  { ObjectDimensionConfidenceUnit_m, false, 1, ObjectDimensionConfidence_outOfRange },
+};
+
+// deg/s of the AngularSpeedConfidence values below outOfRange
+constexpr double angular_speed_classes[] = { 1.0, 2.0, 5.0, 10.0, 20.0, 50.0 };
+
+const ConfidenceType& confidenceType(ConfidenceKind kind)
+{
+  return confidence_types[static_cast<size_t>(kind)];
+}
+
+struct ConfidenceMember
+{
+  long* value = nullptr;
+  ConfidenceKind kind = ConfidenceKind::Coordinate;
+};
+
+// The confidence members of the components present in the object, in CovarianceComponent order
+std::array<ConfidenceMember, dim> confidenceMembers(PerceivedObject& obj)
+{
+  std::array<ConfidenceMember, dim> members{};
+  members[CovarianceComponent_xPosition] = { &obj.position.xCoordinate.confidence, ConfidenceKind::Coordinate };
+  members[CovarianceComponent_yPosition] = { &obj.position.yCoordinate.confidence, ConfidenceKind::Coordinate };
+  if (obj.position.zCoordinate != nullptr)
+  {
+    members[CovarianceComponent_zPosition] = { &obj.position.zCoordinate->confidence, ConfidenceKind::Coordinate };
+  }
+
+  VelocityComponent_t* z_velocity = nullptr;
+  if (obj.velocity != nullptr && obj.velocity->present == Velocity3dWithConfidence_PR_polarVelocity)
+  {
+    auto& polar = obj.velocity->choice.polarVelocity;
+    members[CovarianceComponent_xVelocityOrVelocityMagnitude] = { &polar.velocityMagnitude.speedConfidence,
+                                                                  ConfidenceKind::Speed };
+    members[CovarianceComponent_yVelocityOrVelocityDirection] = { &polar.velocityDirection.confidence,
+                                                                  ConfidenceKind::Angle };
+    z_velocity = polar.zVelocity;
+  }
+  else if (obj.velocity != nullptr && obj.velocity->present == Velocity3dWithConfidence_PR_cartesianVelocity)
+  {
+    auto& cartesian = obj.velocity->choice.cartesianVelocity;
+    members[CovarianceComponent_xVelocityOrVelocityMagnitude] = { &cartesian.xVelocity.confidence,
+                                                                  ConfidenceKind::Speed };
+    members[CovarianceComponent_yVelocityOrVelocityDirection] = { &cartesian.yVelocity.confidence,
+                                                                  ConfidenceKind::Speed };
+    z_velocity = cartesian.zVelocity;
+  }
+  if (z_velocity != nullptr)
+  {
+    members[CovarianceComponent_zSpeed] = { &z_velocity->confidence, ConfidenceKind::Speed };
+  }
+
+  AccelerationComponent_t* z_acceleration = nullptr;
+  if (obj.acceleration != nullptr && obj.acceleration->present == Acceleration3dWithConfidence_PR_polarAcceleration)
+  {
+    auto& polar = obj.acceleration->choice.polarAcceleration;
+    members[CovarianceComponent_xAccelOrAccelMagnitude] = { &polar.accelerationMagnitude.accelerationConfidence,
+                                                            ConfidenceKind::Acceleration };
+    members[CovarianceComponent_yAccelOrAccelDirection] = { &polar.accelerationDirection.confidence,
+                                                            ConfidenceKind::Angle };
+    z_acceleration = polar.zAcceleration;
+  }
+  else if (obj.acceleration != nullptr &&
+           obj.acceleration->present == Acceleration3dWithConfidence_PR_cartesianAcceleration)
+  {
+    auto& cartesian = obj.acceleration->choice.cartesianAcceleration;
+    members[CovarianceComponent_xAccelOrAccelMagnitude] = { &cartesian.xAcceleration.confidence,
+                                                            ConfidenceKind::Acceleration };
+    members[CovarianceComponent_yAccelOrAccelDirection] = { &cartesian.yAcceleration.confidence,
+                                                            ConfidenceKind::Acceleration };
+    z_acceleration = cartesian.zAcceleration;
+  }
+  if (z_acceleration != nullptr)
+  {
+    members[CovarianceComponent_zAcceleration] = { &z_acceleration->confidence, ConfidenceKind::Acceleration };
+  }
+
+  if (obj.angles != nullptr)
+  {
+    members[CovarianceComponent_zAngle] = { &obj.angles->zAngle.confidence, ConfidenceKind::Angle };
+    if (obj.angles->yAngle != nullptr)
+    {
+      members[CovarianceComponent_yAngle] = { &obj.angles->yAngle->confidence, ConfidenceKind::Angle };
+    }
+    if (obj.angles->xAngle != nullptr)
+    {
+      members[CovarianceComponent_xAngle] = { &obj.angles->xAngle->confidence, ConfidenceKind::Angle };
+    }
+  }
+  if (obj.zAngularVelocity != nullptr)
+  {
+    members[CovarianceComponent_zAngularVelocity] = { &obj.zAngularVelocity->confidence,
+                                                      ConfidenceKind::AngularSpeed };
+  }
+  if (obj.objectDimensionZ != nullptr)
+  {
+    members[CovarianceComponent_objectDimensionZ] = { &obj.objectDimensionZ->confidence, ConfidenceKind::Dimension };
+  }
+  if (obj.objectDimensionY != nullptr)
+  {
+    members[CovarianceComponent_objectDimensionY] = { &obj.objectDimensionY->confidence, ConfidenceKind::Dimension };
+  }
+  if (obj.objectDimensionX != nullptr)
+  {
+    members[CovarianceComponent_objectDimensionX] = { &obj.objectDimensionX->confidence, ConfidenceKind::Dimension };
+  }
+  return members;
+}
+
+// The perceived objects of all PerceivedObjectContainers of the CPM
+template <class C, class O>
+void collectObjects(C& cpm, std::vector<O*>& objects)
+{
+  for (int i = 0; i < cpm.payload.cpmContainers.list.count; i++)
+  {
+    auto* container = cpm.payload.cpmContainers.list.array[i];
+    if (container->containerData.present != WrappedCpmContainer__containerData_PR_PerceivedObjectContainer)
+    {
+      continue;
+    }
+    const auto& list = container->containerData.choice.PerceivedObjectContainer.perceivedObjects.list;
+    objects.insert(objects.end(), list.array, list.array + list.count);
+  }
+}
+
+// Writes the correlation coefficients of the object into both triangles of values
+void gatherCorrelations(const PerceivedObject& obj, double* values)
+{
+  if (obj.lowerTriangularCorrelationMatrices == nullptr)
+  {
+    return;
+  }
+  const auto& matrices = obj.lowerTriangularCorrelationMatrices->list;
+  for (int m = 0; m < matrices.count; m++)
+  {
+    const auto& bits = matrices.array[m]->componentsIncludedIntheMatrix;
+    uint8_t components[dim];
+    size_t n = 0;
+    for (size_t c = 0; c < dim && c / 8 < bits.size; c++)
+    {
+      if (bits.buf[c / 8] & (0x80 >> (c % 8)))
+      {
+        components[n++] = static_cast<uint8_t>(c);
+      }
+    }
+    // column i holds the correlations of component i with the components after it
+    const auto& columns = matrices.array[m]->matrix.list;
+    for (size_t i = 0; i + 1 < n && i < static_cast<size_t>(columns.count); i++)
+    {
+      const auto& cells = columns.array[i]->list;
+      for (size_t k = 0; k < static_cast<size_t>(cells.count) && i + 1 + k < n; k++)
+      {
+        const long value = *cells.array[k];
+        if (value == CorrelationCellValue_unavailable)
+        {
+          continue;
+        }
+        const size_t row = components[i + 1 + k];
+        const size_t col = components[i];
+        values[row * dim + col] = values[col * dim + row] = static_cast<double>(value) / 100.0;
+      }
+    }
+  }
+}
+
+long toConfidence(double stddev, ConfidenceKind kind)
+{
+  const auto& type = confidenceType(kind);
+  if (std::isnan(stddev))
+  {
+    return type.out_of_range + 1;
+  }
+  const double confidence = stddev / (type.angle ? deg_to_rad : 1.0) * confidence95 / type.unit;
+  if (kind == ConfidenceKind::AngularSpeed)
+  {
+    // smallest class containing the interval, with some slack so that decoded classes map to themselves
+    for (size_t i = 0; i < std::size(angular_speed_classes); i++)
+    {
+      if (confidence <= angular_speed_classes[i] * (1.0 + 1e-9))
+      {
+        return static_cast<long>(i);
+      }
+    }
+    return type.out_of_range;
+  }
+  return static_cast<long>(
+      std::clamp(std::round(confidence), static_cast<double>(type.min), static_cast<double>(type.out_of_range)));
+}
+
+template <class T>
+T* allocate(MessageArena* arena, size_t n = 1)
+{
+  if (arena != nullptr)
+  {
+    return arena->createArray<T>(n);
+  }
+  auto* ptr = static_cast<T*>(calloc(n, sizeof(T)));
+  assert(ptr && "calloc() failed");
+  return ptr;
+}
+
+// Replaces the correlation matrices of the object by one of the included components, from the dense matrix of
+// correlation cell values
+void setCorrelations(PerceivedObject& obj, uint16_t included, const int8_t* correlations, MessageArena* arena)
+{
+  if (obj.lowerTriangularCorrelationMatrices != nullptr)
+  {
+    if (arena == nullptr)
+    {
+      ASN_STRUCT_FREE(asn_DEF_LowerTriangularPositiveSemidefiniteMatrices, obj.lowerTriangularCorrelationMatrices);
+    }
+    obj.lowerTriangularCorrelationMatrices = nullptr;
+  }
+
+  uint8_t components[dim];
+  size_t n = 0;
+  for (size_t c = 0; c < dim; c++)
+  {
+    if (included & (1u << c))
+    {
+      components[n++] = static_cast<uint8_t>(c);
+    }
+  }
+  if (n < 2)
+  {
+    return;
+  }
+
+  auto* matrices = allocate<LowerTriangularPositiveSemidefiniteMatrices_t>(arena);
+  matrices->list.array = allocate<LowerTriangularPositiveSemidefiniteMatrix_t*>(arena);
+  matrices->list.count = matrices->list.size = 1;
+  auto* matrix = matrices->list.array[0] = allocate<LowerTriangularPositiveSemidefiniteMatrix_t>(arena);
+
+  auto& bits = matrix->componentsIncludedIntheMatrix;
+  bits.size = dim / 8;
+  bits.buf = allocate<uint8_t>(arena, bits.size);
+  for (size_t i = 0; i < n; i++)
+  {
+    bits.buf[components[i] / 8] |= static_cast<uint8_t>(0x80 >> (components[i] % 8));
+  }
+
+  auto& columns = matrix->matrix.list;
+  columns.array = allocate<CorrelationColumn_t*>(arena, n - 1);
+  columns.count = columns.size = static_cast<int>(n - 1);
+  for (size_t i = 0; i + 1 < n; i++)
+  {
+    auto* column = columns.array[i] = allocate<CorrelationColumn_t>(arena);
+    const size_t num_cells = n - 1 - i;
+    column->list.array = allocate<CorrelationCellValue_t*>(arena, num_cells);
+    column->list.count = column->list.size = static_cast<int>(num_cells);
+    for (size_t k = 0; k < num_cells; k++)
+    {
+      auto* cell = column->list.array[k] = allocate<CorrelationCellValue_t>(arena);
+      *cell = correlations[components[i + 1 + k] * dim + components[i]];
+    }
+  }
+  obj.lowerTriangularCorrelationMatrices = matrices;
+}
+}  // namespace
+
+void decodeCpmCovariances(const CollectivePerceptionMessage& cpm, std::vector<ObjectCovariance>& covariances)
+{
+  std::vector<const PerceivedObject*> objects;
+  collectObjects(cpm, objects);
+  covariances.resize(objects.size());
+
+  static const auto identity = [] {
+    std::array<double, dim * dim> values{};
+    for (size_t c = 0; c < dim; c++)
+    {
+      values[c * dim + c] = 1.0;
+    }
+    return values;
+  }();
+
+  // Confidences (NaN if unknown) and their units, which become the standard deviations
+  std::vector<double> stddevs(objects.size() * dim);
+  std::vector<double> units(objects.size() * dim);
+  std::vector<uint8_t> angles(objects.size() * dim);
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    // the members are only read
+    const auto members = confidenceMembers(const_cast<PerceivedObject&>(*objects[i]));
+    for (size_t c = 0; c < dim; c++)
+    {
+      double confidence = nan;
+      const auto& member = members[c];
+      const auto& type = confidenceType(member.kind);
+      if (member.value != nullptr && *member.value >= 0 && *member.value < type.out_of_range)
+      {
+        confidence = member.kind == ConfidenceKind::AngularSpeed ? angular_speed_classes[*member.value] :
+                                                                   static_cast<double>(*member.value);
+      }
+      stddevs[i * dim + c] = confidence;
+      units[i * dim + c] = type.unit;
+      angles[i * dim + c] = type.angle;
+    }
+    std::memcpy(covariances[i].values, identity.data(), sizeof(identity));
+    gatherCorrelations(*objects[i], covariances[i].values);
+  }
+
+  // same operations as decodeConfidence() and decodeConfidenceAngle() of utils.h
+  for (size_t k = 0; k < stddevs.size(); k++)
+  {
+    const double stddev = stddevs[k] * units[k] / confidence95;
+    stddevs[k] = angles[k] ? stddev * M_PI / 180. : stddev;
+  }
+
+  // Unknown standard deviations turn their row and column into NaN
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    const double* __restrict s = &stddevs[i * dim];
+    double* __restrict values = covariances[i].values;
+    for (size_t row = 0; row < dim; row++)
+    {
+      for (size_t col = 0; col < dim; col++)
+      {
+        values[row * dim + col] = values[row * dim + col] * s[row] * s[col];
+      }
+    }
+    uint16_t available = 0;
+    for (size_t c = 0; c < dim; c++)
+    {
+      available |= std::isnan(s[c]) ? 0 : static_cast<uint16_t>(1u << c);
+    }
+    covariances[i].available = available;
+  }
+}
+
+bool encodeCpmCovariances(CollectivePerceptionMessage& cpm,
+                          const std::vector<ObjectCovariance>& covariances,
+                          MessageArena* arena)
+{
+  std::vector<PerceivedObject*> objects;
+  collectObjects(cpm, objects);
+  if (objects.size() != covariances.size())
+  {
+    LOG_ERR("CPM has " << objects.size() << " perceived objects, but " << covariances.size()
+                       << " covariances were given");
+    return false;
+  }
+
+  // Standard deviations and correlation cell values of all objects
+  std::vector<double> stddevs(objects.size() * dim);
+  std::vector<int8_t> correlations(objects.size() * dim * dim);
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    const double* __restrict values = covariances[i].values;
+    double* __restrict s = &stddevs[i * dim];
+    for (size_t c = 0; c < dim; c++)
+    {
+      s[c] = std::sqrt(values[c * dim + c]);
+    }
+    int8_t* __restrict cells = &correlations[i * dim * dim];
+    for (size_t row = 0; row < dim; row++)
+    {
+      for (size_t col = 0; col < dim; col++)
+      {
+        // NaN for unknown or zero variances
+        const double correlation =
+            std::clamp(std::round(values[row * dim + col] / (s[row] * s[col]) * 100.0), -100.0, 100.0);
+        cells[row * dim + col] =
+            std::isnan(correlation) ? CorrelationCellValue_unavailable : static_cast<int8_t>(correlation);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    const auto members = confidenceMembers(*objects[i]);
+    uint16_t included = 0;
+    for (size_t c = 0; c < dim; c++)
+    {
+      if (members[c].value == nullptr)
+      {
+        continue;
+      }
+      const double stddev = stddevs[i * dim + c];
+      *members[c].value = toConfidence(stddev, members[c].kind);
+      included |= std::isnan(stddev) ? 0 : static_cast<uint16_t>(1u << c);
+    }
+    setCorrelations(*objects[i], included, &correlations[i * dim * dim], arena);
+  }
+  return true;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
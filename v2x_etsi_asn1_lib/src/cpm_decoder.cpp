@@ -0,0 +1,476 @@
+#include "v2x_etsi_asn1_lib/cpm_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+// Reads the unaligned PER bit stream, all reads are bounds-checked
+class BitReader
+{
+public:
+  BitReader(const uint8_t* data, size_t size) : data_(data), size_bits_(size * 8)
+  {
+  }
+
+  bool read(unsigned bits, uint64_t& value)
+  {
+    if (bits > size_bits_ - pos_)
+    {
+      return false;
+    }
+    value = 0;
+    while (bits > 0)
+    {
+      const unsigned avail = 8 - (pos_ & 7);
+      const unsigned n = std::min(avail, bits);
+      const uint8_t chunk = (data_[pos_ >> 3] >> (avail - n)) & ((1u << n) - 1);
+      value = (value << n) | chunk;
+      pos_ += n;
+      bits -= n;
+    }
+    return true;
+  }
+
+  // Reads a constrained whole number
+  bool read(unsigned bits, long lower_bound, long upper_bound, long& value)
+  {
+    uint64_t raw;
+    if (!read(bits, raw) || raw > static_cast<uint64_t>(upper_bound - lower_bound))
+    {
+      return false;
+    }
+    value = lower_bound + static_cast<long>(raw);
+    return true;
+  }
+
+  bool skip(size_t bits)
+  {
+    if (bits > size_bits_ - pos_)
+    {
+      return false;
+    }
+    pos_ += bits;
+    return true;
+  }
+
+  // Unconstrained length determinant, fragmented lengths (>= 16K) are not supported
+  bool readLength(size_t& length)
+  {
+    uint64_t prefix;
+    if (!read(1, prefix))
+    {
+      return false;
+    }
+    uint64_t value;
+    if (prefix == 0)
+    {
+      if (!read(7, value))
+      {
+        return false;
+      }
+    }
+    else if (!read(1, prefix) || prefix != 0 || !read(14, value))
+    {
+      return false;
+    }
+    length = value;
+    return true;
+  }
+
+  // Normally small length, used for the extension bitmap of SEQUENCEs
+  bool readSmallLength(size_t& length)
+  {
+    uint64_t prefix;
+    if (!read(1, prefix))
+    {
+      return false;
+    }
+    if (prefix == 1)
+    {
+      return readLength(length);
+    }
+    uint64_t value;
+    if (!read(6, value))
+    {
+      return false;
+    }
+    length = value + 1;
+    return true;
+  }
+
+  [[nodiscard]] size_t position() const
+  {
+    return pos_;
+  }
+
+private:
+  const uint8_t* data_;
+  const size_t size_bits_;
+  size_t pos_ = 0;
+};
+
+// Skips the extension additions of a SEQUENCE whose extension bit is set
+bool skipExtensions(BitReader& r)
+{
+  size_t num_additions;
+  if (!r.readSmallLength(num_additions))
+  {
+    return false;
+  }
+  size_t num_present = 0;
+  for (size_t i = 0; i < num_additions; i++)
+  {
+    uint64_t present;
+    if (!r.read(1, present))
+    {
+      return false;
+    }
+    num_present += present;
+  }
+  for (size_t i = 0; i < num_present; i++)
+  {
+    size_t length;
+    if (!r.readLength(length) || !r.skip(length * 8))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool readContainers(BitReader& r, std::vector<EncodedCpmContainer>& containers)
+{
+  uint64_t extended;
+  size_t count;
+  if (!r.read(1, extended))
+  {
+    return false;
+  }
+  if (extended == 0)
+  {
+    uint64_t value;
+    if (!r.read(3, value))
+    {
+      return false;
+    }
+    count = value + 1;
+  }
+  else if (!r.readLength(count))
+  {
+    return false;
+  }
+
+  containers.clear();
+  for (size_t i = 0; i < count; i++)
+  {
+    EncodedCpmContainer container;
+    if (!r.read(4, 1, 16, container.container_id) || !r.readLength(container.size))
+    {
+      return false;
+    }
+    container.bit_offset = r.position();
+    if (!r.skip(container.size * 8))
+    {
+      return false;
+    }
+    containers.push_back(container);
+  }
+  return true;
+}
+
+// Decodes the header and the management container into msg, see CPM-PDU-Descriptions.asn for the field sizes
+bool readEnvelope(BitReader& r, CollectivePerceptionMessage& msg)
+{
+  uint64_t value;
+  long lvalue;
+
+  if (!r.read(8, value))
+  {
+    return false;
+  }
+  msg.header.protocolVersion = static_cast<long>(value);
+  if (!r.read(8, value))
+  {
+    return false;
+  }
+  msg.header.messageId = static_cast<long>(value);
+  if (!r.read(32, value))
+  {
+    return false;
+  }
+  msg.header.stationId = static_cast<StationId_t>(value);
+
+  uint64_t payload_extended, management_extended, has_segmentation_info, has_message_rate_range;
+  if (!r.read(1, payload_extended) || !r.read(1, management_extended) || !r.read(1, has_segmentation_info) ||
+      !r.read(1, has_message_rate_range))
+  {
+    return false;
+  }
+
+  auto& mc = msg.payload.managementContainer;
+  if (!r.read(42, value) || asn_umax2INTEGER(&mc.referenceTime, value) != 0)
+  {
+    return false;
+  }
+  auto& pos = mc.referencePosition;
+  if (!r.read(31, -900000000, 900000001, lvalue))
+  {
+    return false;
+  }
+  pos.latitude = lvalue;
+  if (!r.read(32, -1800000000, 1800000001, lvalue))
+  {
+    return false;
+  }
+  pos.longitude = lvalue;
+  if (!r.read(12, 0, 4095, lvalue))
+  {
+    return false;
+  }
+  pos.positionConfidenceEllipse.semiMajorConfidence = lvalue;
+  if (!r.read(12, 0, 4095, lvalue))
+  {
+    return false;
+  }
+  pos.positionConfidenceEllipse.semiMinorConfidence = lvalue;
+  if (!r.read(12, 0, 3601, lvalue))
+  {
+    return false;
+  }
+  pos.positionConfidenceEllipse.semiMajorOrientation = lvalue;
+  if (!r.read(20, -100000, 800001, lvalue))
+  {
+    return false;
+  }
+  pos.altitude.altitudeValue = lvalue;
+  if (!r.read(4, 0, 15, lvalue))
+  {
+    return false;
+  }
+  pos.altitude.altitudeConfidence = lvalue;
+
+  if (has_segmentation_info)
+  {
+    mc.segmentationInfo = static_cast<decltype(mc.segmentationInfo)>(calloc(1, sizeof(*mc.segmentationInfo)));
+    if (!r.read(3, 1, 8, lvalue))
+    {
+      return false;
+    }
+    mc.segmentationInfo->totalMsgNo = lvalue;
+    if (!r.read(3, 1, 8, lvalue))
+    {
+      return false;
+    }
+    mc.segmentationInfo->thisMsgNo = lvalue;
+  }
+  if (has_message_rate_range)
+  {
+    mc.messageRateRange = static_cast<decltype(mc.messageRateRange)>(calloc(1, sizeof(*mc.messageRateRange)));
+    for (auto* rate : { &mc.messageRateRange->messageRateMin, &mc.messageRateRange->messageRateMax })
+    {
+      if (!r.read(7, 1, 100, lvalue))
+      {
+        return false;
+      }
+      rate->mantissa = lvalue;
+      if (!r.read(3, -5, 2, lvalue))
+      {
+        return false;
+      }
+      rate->exponent = lvalue;
+    }
+  }
+  if (management_extended && !skipExtensions(r))
+  {
+    return false;
+  }
+  // extensions of the payload follow the containers and are ignored
+  return true;
+}
+
+// Returns the member of the open type for the given container ID
+void* containerData(WrappedCpmContainer& container, const asn_TYPE_descriptor_t*& type)
+{
+  auto& data = container.containerData;
+  switch (container.containerId)
+  {
+    case 1:
+      type = &asn_DEF_OriginatingVehicleContainer;
+      data.present = WrappedCpmContainer__containerData_PR_OriginatingVehicleContainer;
+      return &data.choice.OriginatingVehicleContainer;
+    case 2:
+      type = &asn_DEF_OriginatingRsuContainer;
+      data.present = WrappedCpmContainer__containerData_PR_OriginatingRsuContainer;
+      return &data.choice.OriginatingRsuContainer;
+    case 3:
+      type = &asn_DEF_SensorInformationContainer;
+      data.present = WrappedCpmContainer__containerData_PR_SensorInformationContainer;
+      return &data.choice.SensorInformationContainer;
+    case 4:
+      type = &asn_DEF_PerceptionRegionContainer;
+      data.present = WrappedCpmContainer__containerData_PR_PerceptionRegionContainer;
+      return &data.choice.PerceptionRegionContainer;
+    case 5:
+      type = &asn_DEF_PerceivedObjectContainer;
+      data.present = WrappedCpmContainer__containerData_PR_PerceivedObjectContainer;
+      return &data.choice.PerceivedObjectContainer;
+    default:
+      return nullptr;
+  }
+}
+
+// Copies the (unaligned) content of the container to an octet-aligned buffer
+void copyContent(const uint8_t* data, const EncodedCpmContainer& encoded, std::vector<uint8_t>& buffer)
+{
+  buffer.resize(encoded.size);
+  const uint8_t* src = data + encoded.bit_offset / 8;
+  const unsigned shift = encoded.bit_offset % 8;
+  if (shift == 0)
+  {
+    std::memcpy(buffer.data(), src, encoded.size);
+    return;
+  }
+  for (size_t i = 0; i < encoded.size; i++)
+  {
+    buffer[i] = static_cast<uint8_t>((src[i] << shift) | (src[i + 1] >> (8 - shift)));
+  }
+}
+
+asn_dec_rval_t decodeContainer(WrappedCpmContainer& container,
+                               const uint8_t* data,
+                               const EncodedCpmContainer& encoded,
+                               std::vector<uint8_t>& buffer,
+                               const asn_codec_ctx_t* ctx)
+{
+  container.containerId = encoded.container_id;
+  const asn_TYPE_descriptor_t* type = nullptr;
+  void* member = containerData(container, type);
+  if (member == nullptr)
+  {
+    return { RC_FAIL, 0 };
+  }
+  copyContent(data, encoded, buffer);
+  return uper_decode_complete(ctx, type, &member, buffer.data(), buffer.size());
+}
+}  // namespace
+
+bool findCpmContainers(const uint8_t* data, size_t size, std::vector<EncodedCpmContainer>& containers)
+{
+  auto* msg = static_cast<CollectivePerceptionMessage*>(calloc(1, sizeof(CollectivePerceptionMessage)));
+  BitReader r(data, size);
+  const bool ret = readEnvelope(r, *msg) && readContainers(r, containers);
+  ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+  return ret;
+}
+
+bool countCpmPerceivedObjects(const uint8_t* data, size_t size, size_t& count)
+{
+  std::vector<EncodedCpmContainer> containers;
+  if (!findCpmContainers(data, size, containers))
+  {
+    return false;
+  }
+  count = 0;
+  std::vector<uint8_t> buffer;
+  for (const auto& encoded : containers)
+  {
+    if (encoded.container_id != 5)
+    {
+      continue;
+    }
+    // PerceivedObjectContainer: extension bit, numberOfPerceivedObjects, then the size of perceivedObjects
+    copyContent(data, encoded, buffer);
+    BitReader r(buffer.data(), buffer.size());
+    uint64_t extended;
+    size_t num_objects;
+    if (!r.skip(1 + 8) || !r.read(1, extended))
+    {
+      return false;
+    }
+    if (extended == 0)
+    {
+      uint64_t value;
+      if (!r.read(8, value))
+      {
+        return false;
+      }
+      num_objects = value;
+    }
+    else if (!r.readLength(num_objects))
+    {
+      return false;
+    }
+    count += num_objects;
+  }
+  return true;
+}
+
+asn_dec_rval_t decodeCPMSelective(CollectivePerceptionMessage** msg,
+                                  const uint8_t* data,
+                                  size_t size,
+                                  uint32_t container_mask,
+                                  std::vector<EncodedCpmContainer>* skipped,
+                                  const asn_codec_ctx_t* ctx)
+{
+  if (*msg == nullptr)
+  {
+    *msg = static_cast<CollectivePerceptionMessage*>(calloc(1, sizeof(CollectivePerceptionMessage)));
+  }
+  BitReader r(data, size);
+  std::vector<EncodedCpmContainer> containers;
+  if (!readEnvelope(r, **msg) || !readContainers(r, containers))
+  {
+    return { RC_FAIL, 0 };
+  }
+
+  if (skipped != nullptr)
+  {
+    skipped->clear();
+  }
+  std::vector<uint8_t> buffer;
+  for (const auto& encoded : containers)
+  {
+    if ((container_mask & (1u << encoded.container_id)) == 0 || encoded.container_id > 5)
+    {
+      if (skipped != nullptr)
+      {
+        skipped->push_back(encoded);
+      }
+      continue;
+    }
+    auto* container = static_cast<WrappedCpmContainer*>(calloc(1, sizeof(WrappedCpmContainer)));
+    const auto ret = decodeContainer(*container, data, encoded, buffer, ctx);
+    if (ASN_SEQUENCE_ADD(&(*msg)->payload.cpmContainers.list, container) != 0)
+    {
+      ASN_STRUCT_FREE(asn_DEF_WrappedCpmContainer, container);
+      return { RC_FAIL, 0 };
+    }
+    if (ret.code != RC_OK)
+    {
+      return { ret.code, 0 };
+    }
+  }
+  return { RC_OK, (r.position() + 7) / 8 };
+}
+
+asn_dec_rval_t decodeCpmContainer(WrappedCpmContainer** container,
+                                  const uint8_t* data,
+                                  size_t size,
+                                  const EncodedCpmContainer& encoded,
+                                  const asn_codec_ctx_t* ctx)
+{
+  if (encoded.bit_offset + encoded.size * 8 > size * 8)
+  {
+    return { RC_FAIL, 0 };
+  }
+  if (*container == nullptr)
+  {
+    *container = static_cast<WrappedCpmContainer*>(calloc(1, sizeof(WrappedCpmContainer)));
+  }
+  std::vector<uint8_t> buffer;
+  return decodeContainer(**container, data, encoded, buffer, ctx);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,129 @@
+#include "v2x_etsi_asn1_lib/cpm_object_selector.h"
+#include "v2x_etsi_asn1_lib/units.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+double angleDifference(double a, double b)
+{
+  const double diff = std::fmod(std::fabs(a - b), 360.0);
+  return diff > 180.0 ? 360.0 - diff : diff;
+}
+}  // namespace
+
+CpmObjectSelector::CpmObjectSelector(const CpmObjectRules& rules, std::shared_ptr<const StationTable> stations)
+  : rules_(rules), stations_(std::move(stations))
+{
+}
+
+std::vector<const PerceivedObject*> CpmObjectSelector::select(const std::vector<const PerceivedObject*>& objects,
+                                                              Clock::time_point now)
+{
+  cycle_++;
+  num_redundant_ = 0;
+  std::vector<const PerceivedObject*> selected;
+  for (const auto* obj : objects)
+  {
+    if (obj->objectAge != nullptr && *obj->objectAge < rules_.min_object_age.count())
+    {
+      continue;
+    }
+    if (isRedundant(*obj))
+    {
+      num_redundant_++;
+      continue;
+    }
+    if (obj->objectId == nullptr)
+    {
+      selected.push_back(obj);
+      continue;
+    }
+
+    const auto current = objectState(*obj, now, cycle_);
+    auto it = sent_objects_.find(*obj->objectId);
+    if (it == sent_objects_.end())
+    {
+      sent_objects_.emplace(*obj->objectId, current);
+      selected.push_back(obj);
+    }
+    else if (isDue(current, it->second))
+    {
+      it->second = current;
+      selected.push_back(obj);
+    }
+    else
+    {
+      it->second.cycle = cycle_;
+    }
+  }
+  // objects which are no longer tracked (or are now redundant) are sent as new objects when they reappear
+  std::erase_if(sent_objects_, [this](const auto& entry) { return entry.second.cycle != cycle_; });
+  return selected;
+}
+
+size_t CpmObjectSelector::numRedundant() const
+{
+  return num_redundant_;
+}
+
+bool CpmObjectSelector::isRedundant(const PerceivedObject& obj) const
+{
+  return stations_ != nullptr && obj.associatedStationID != nullptr &&
+         stations_->get(static_cast<uint32_t>(*obj.associatedStationID)).has_value();
+}
+
+bool CpmObjectSelector::isDue(const SentObject& current, const SentObject& sent) const
+{
+  // comparisons with unavailable (NaN) values are false, so these rules are skipped then. The direction of (almost)
+  // standing objects is noise and not checked.
+  return current.time - sent.time >= rules_.max_interval ||
+         std::hypot(current.x - sent.x, current.y - sent.y) > rules_.position_threshold ||
+         std::fabs(current.speed - sent.speed) > rules_.speed_threshold ||
+         (current.speed > rules_.speed_threshold &&
+          angleDifference(current.direction, sent.direction) > rules_.direction_threshold);
+}
+
+CpmObjectSelector::SentObject CpmObjectSelector::objectState(const PerceivedObject& obj,
+                                                             Clock::time_point now,
+                                                             uint64_t cycle)
+{
+  SentObject state{ now,
+                    obj.position.xCoordinate.value * CartesianCoordinateLargeUnit_m,
+                    obj.position.yCoordinate.value * CartesianCoordinateLargeUnit_m,
+                    nan,
+                    nan,
+                    cycle };
+  if (obj.velocity == nullptr)
+  {
+    return state;
+  }
+  if (obj.velocity->present == Velocity3dWithConfidence_PR_polarVelocity)
+  {
+    const auto& polar = obj.velocity->choice.polarVelocity;
+    if (polar.velocityMagnitude.speedValue != SpeedValue_unavailable)
+    {
+      state.speed = polar.velocityMagnitude.speedValue * SpeedValueUnit_m_s;
+    }
+    if (polar.velocityDirection.value != CartesianAngleValue_unavailable)
+    {
+      state.direction = polar.velocityDirection.value * CartesianAngleValueUnit_degrees;
+    }
+  }
+  else if (obj.velocity->present == Velocity3dWithConfidence_PR_cartesianVelocity)
+  {
+    const auto& cartesian = obj.velocity->choice.cartesianVelocity;
+    const double vx = cartesian.xVelocity.value * VelocityComponentValueUnit_m_s;
+    const double vy = cartesian.yVelocity.value * VelocityComponentValueUnit_m_s;
+    state.speed = std::hypot(vx, vy);
+    state.direction = std::atan2(vy, vx) * 180.0 / M_PI;
+  }
+  return state;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
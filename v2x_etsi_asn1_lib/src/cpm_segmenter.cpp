@@ -0,0 +1,223 @@
+#include "v2x_etsi_asn1_lib/cpm_segmenter.h"
+#include <aduulm_logger/aduulm_logger.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr long originating_vehicle_container_id = 1;
+constexpr long originating_rsu_container_id = 2;
+constexpr long perceived_object_container_id = 5;
+// SIZE(0..255,...) of perceivedObjects, larger lists would need the extension
+constexpr size_t max_objects_per_segment = 255;
+
+struct EncodeSink
+{
+  std::vector<uint8_t>* out;
+  size_t size;
+};
+
+int consumeBytes(const void* buffer, size_t size, void* key)
+{
+  auto* sink = static_cast<EncodeSink*>(key);
+  if (sink->out != nullptr)
+  {
+    const auto* bytes = static_cast<const uint8_t*>(buffer);
+    sink->out->insert(sink->out->end(), bytes, bytes + size);
+  }
+  sink->size += size;
+  return 0;
+}
+
+// Returns the size of the UPER encoding in bytes (appended to out if given) or -1 on failure
+ssize_t encodeUPER(const asn_TYPE_descriptor_t* type, const void* msg, std::vector<uint8_t>* out)
+{
+  EncodeSink sink{ out, 0 };
+  const auto ret = asn_encode(nullptr, ATS_UNALIGNED_BASIC_PER, type, msg, consumeBytes, &sink);
+  return ret.encoded < 0 ? -1 : static_cast<ssize_t>(sink.size);
+}
+
+// Lets an asn1c list reference the given elements. The encoders only read the list, so the elements are not copied.
+template <typename List, typename T>
+void borrow(List& list, const std::vector<T*>& elements)
+{
+  using Element = std::remove_const_t<T>;
+  list.array = const_cast<Element**>(elements.data());
+  list.count = static_cast<int>(elements.size());
+  list.size = static_cast<int>(elements.size());
+}
+
+// Shallow copy of the template CPM with a subset of the objects. Nothing in here is owned, so it must never be
+// passed to ASN_STRUCT_FREE.
+class SegmentBuilder
+{
+public:
+  explicit SegmentBuilder(const CollectivePerceptionMessage& msg) : msg_(msg)
+  {
+    objects_container_.containerId = perceived_object_container_id;
+    objects_container_.containerData.present = WrappedCpmContainer__containerData_PR_PerceivedObjectContainer;
+    const auto& list = msg.payload.cpmContainers.list;
+    for (int i = 0; i < list.count; i++)
+    {
+      const auto id = list.array[i]->containerId;
+      if (id == originating_vehicle_container_id || id == originating_rsu_container_id)
+      {
+        originating_containers_.push_back(list.array[i]);
+      }
+      else if (id != perceived_object_container_id)
+      {
+        other_containers_.push_back(list.array[i]);
+      }
+    }
+  }
+
+  ssize_t encode(size_t segment,
+                 size_t num_segments,
+                 const std::vector<const PerceivedObject*>& objects,
+                 size_t num_objects,
+                 std::vector<uint8_t>* out)
+  {
+    containers_ = originating_containers_;
+    if (segment == 0)
+    {
+      containers_.insert(containers_.end(), other_containers_.begin(), other_containers_.end());
+    }
+    containers_.push_back(&objects_container_);
+    borrow(msg_.payload.cpmContainers.list, containers_);
+
+    auto& object_container = objects_container_.containerData.choice.PerceivedObjectContainer;
+    object_container.numberOfPerceivedObjects = static_cast<long>(std::min<size_t>(num_objects, 255));
+    borrow(object_container.perceivedObjects.list, objects);
+
+    auto& management_container = msg_.payload.managementContainer;
+    management_container.segmentationInfo = nullptr;
+    if (num_segments > 1)
+    {
+      segmentation_info_.totalMsgNo = static_cast<long>(num_segments);
+      segmentation_info_.thisMsgNo = static_cast<long>(segment + 1);
+      management_container.segmentationInfo = &segmentation_info_;
+    }
+    return encodeUPER(&asn_DEF_CollectivePerceptionMessage, &msg_, out);
+  }
+
+private:
+  CollectivePerceptionMessage msg_;
+  WrappedCpmContainer objects_container_{};
+  MessageSegmentationInfo_t segmentation_info_{};
+  std::vector<WrappedCpmContainer*> originating_containers_;
+  std::vector<WrappedCpmContainer*> other_containers_;
+  std::vector<WrappedCpmContainer*> containers_;
+};
+
+struct Segment
+{
+  size_t capacity;
+  std::vector<size_t> objects;
+};
+}  // namespace
+
+ssize_t estimatePerceivedObjectSize(const PerceivedObject& obj)
+{
+  // The elements of a SEQUENCE OF are encoded back to back, so the stand-alone encoding (rounded up to full bytes)
+  // is an upper bound of the size within the container
+  return encodeUPER(&asn_DEF_PerceivedObject, &obj, nullptr);
+}
+
+bool encodeSegmentedCPM(const CollectivePerceptionMessage& msg,
+                        const std::vector<const PerceivedObject*>& objects,
+                        size_t max_size,
+                        SegmentedCPM& result,
+                        std::optional<size_t> num_perceived_objects)
+{
+  const size_t num_objects = num_perceived_objects.value_or(objects.size());
+  result.segments.clear();
+  result.omitted_objects.clear();
+  SegmentBuilder builder(msg);
+
+  // Size of the segments without objects. The segmentation info is included, so the estimate also holds if it is
+  // omitted for a single segment.
+  const std::vector<const PerceivedObject*> no_objects;
+  const ssize_t first_base_size = builder.encode(0, 2, no_objects, num_objects, nullptr);
+  const ssize_t other_base_size = builder.encode(1, 2, no_objects, num_objects, nullptr);
+  if (first_base_size < 0 || other_base_size < 0)
+  {
+    LOG_ERR("Could not encode CPM segment");
+    return false;
+  }
+  // one byte reserved for the growth of the length determinant of the PerceivedObjectContainer
+  if (static_cast<size_t>(first_base_size) + 1 > max_size)
+  {
+    LOG_ERR("CPM containers need " << first_base_size << " bytes, the maximum segment size is " << max_size);
+    return false;
+  }
+  const size_t first_capacity = max_size - first_base_size - 1;
+  const size_t other_capacity = max_size - std::min<size_t>(other_base_size + 1, max_size);
+
+  std::vector<ssize_t> sizes(objects.size());
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    sizes[i] = estimatePerceivedObjectSize(*objects[i]);
+  }
+  std::vector<size_t> order(objects.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  // first fit decreasing
+  std::vector<Segment> segments{ { first_capacity, {} } };
+  for (auto i : order)
+  {
+    if (sizes[i] < 0)
+    {
+      LOG_WARN("Omitting perceived object which cannot be encoded");
+      result.omitted_objects.push_back(objects[i]);
+      continue;
+    }
+    const auto size = static_cast<size_t>(sizes[i]);
+    auto it = std::find_if(segments.begin(), segments.end(), [&](const Segment& segment) {
+      return segment.capacity >= size && segment.objects.size() < max_objects_per_segment;
+    });
+    if (it == segments.end() && segments.size() < max_cpm_segments && size <= other_capacity)
+    {
+      it = segments.insert(segments.end(), Segment{ other_capacity, {} });
+    }
+    if (it == segments.end())
+    {
+      result.omitted_objects.push_back(objects[i]);
+      continue;
+    }
+    it->capacity -= size;
+    it->objects.push_back(i);
+  }
+  if (!result.omitted_objects.empty())
+  {
+    LOG_WARN("Omitting " << result.omitted_objects.size() << " of " << objects.size()
+                         << " perceived objects which do not fit into " << max_cpm_segments << " CPM segments");
+  }
+
+  result.segments.resize(segments.size());
+  std::vector<const PerceivedObject*> segment_objects;
+  for (size_t s = 0; s < segments.size(); s++)
+  {
+    // keep the order of the input within each segment
+    std::sort(segments[s].objects.begin(), segments[s].objects.end());
+    segment_objects.clear();
+    for (auto i : segments[s].objects)
+    {
+      segment_objects.push_back(objects[i]);
+    }
+    const auto size = builder.encode(s, segments.size(), segment_objects, num_objects, &result.segments[s]);
+    if (size < 0 || static_cast<size_t>(size) > max_size)
+    {
+      LOG_ERR("Could not encode CPM segment " << s + 1 << " of " << segments.size() << " within " << max_size
+                                              << " bytes");
+      result.segments.clear();
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
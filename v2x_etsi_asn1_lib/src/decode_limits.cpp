@@ -0,0 +1,154 @@
+#include "v2x_etsi_asn1_lib/decode_limits.h"
+#include "v2x_etsi_asn1_lib/cpm_decoder.h"
+#include "v2x_etsi_asn1_lib/encoding.h"
+
+// implemented in asn_alloc_budget.c, which is part of the asn1 library
+extern "C" {
+void asn_alloc_budget_begin(size_t max_bytes);
+int asn_alloc_budget_end(void);
+}
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+const char* toString(DecodeLimitResult result)
+{
+  switch (result)
+  {
+    case DecodeLimitResult::Ok:
+      return "ok";
+    case DecodeLimitResult::TooLarge:
+      return "message too large";
+    case DecodeLimitResult::TooManyElements:
+      return "too many elements";
+    case DecodeLimitResult::AllocationExceeded:
+      return "allocation limit exceeded";
+    case DecodeLimitResult::DecodingFailed:
+      return "decoding failed";
+  }
+  return "unknown";
+}
+
+DecodeLimits defaultDecodeLimits(ETSIMessageType message_type)
+{
+  DecodeLimits limits;
+  limits.max_size = 64 * 1024;
+  limits.max_allocation = 4 * 1024 * 1024;
+  limits.max_stack_size = 64 * 1024;
+  if (message_type == ETSIMessageType::CPM)
+  {
+    // SIZE(0..255) of perceivedObjects
+    limits.max_elements = 255;
+  }
+  else if (message_type == ETSIMessageType::MCM)
+  {
+    // SIZE(1..128) of TrajectoryPointContainer
+    limits.max_elements = 128;
+  }
+  return limits;
+}
+
+DecodeLimitResult decodeETSIMsgLimited(const asn_TYPE_descriptor_t* type,
+                                       WireEncoding encoding,
+                                       void** msg,
+                                       const void* buffer,
+                                       size_t size,
+                                       const DecodeLimits& limits,
+                                       std::optional<uint32_t> cpm_container_mask)
+{
+  if (limits.max_size != 0 && size > limits.max_size)
+  {
+    return DecodeLimitResult::TooLarge;
+  }
+  const bool is_cpm = type == &asn_DEF_CollectivePerceptionMessage;
+  size_t num_elements = 0;
+  if (limits.max_elements != 0 && is_cpm && encoding == WireEncoding::UPER &&
+      countCpmPerceivedObjects(static_cast<const uint8_t*>(buffer), size, num_elements) &&
+      num_elements > limits.max_elements)
+  {
+    return DecodeLimitResult::TooManyElements;
+  }
+
+  // asn1c measures the stack usage relative to the address of the context, so it has to live on this stack
+  asn_codec_ctx_t ctx{};
+  ctx.max_stack_size = limits.max_stack_size;
+  if (limits.max_allocation != 0)
+  {
+    beginAllocationBudget(limits.max_allocation);
+  }
+  asn_dec_rval_t ret;
+  if (cpm_container_mask && is_cpm && encoding == WireEncoding::UPER)
+  {
+    ret = decodeCPMSelective(reinterpret_cast<CollectivePerceptionMessage**>(msg),
+                             static_cast<const uint8_t*>(buffer),
+                             size,
+                             *cpm_container_mask,
+                             nullptr,
+                             &ctx);
+  }
+  else
+  {
+    ret = decodeETSIMsg(type, encoding, msg, buffer, size, &ctx);
+  }
+  if (limits.max_allocation != 0 && !endAllocationBudget())
+  {
+    return DecodeLimitResult::AllocationExceeded;
+  }
+  if (ret.code != RC_OK)
+  {
+    return DecodeLimitResult::DecodingFailed;
+  }
+
+  if (limits.max_elements != 0)
+  {
+    if (is_cpm)
+    {
+      num_elements = countElements(*static_cast<const CollectivePerceptionMessage*>(*msg));
+    }
+    else if (type == &asn_DEF_MCM)
+    {
+      num_elements = countElements(*static_cast<const MCM*>(*msg));
+    }
+    if (num_elements > limits.max_elements)
+    {
+      return DecodeLimitResult::TooManyElements;
+    }
+  }
+  return DecodeLimitResult::Ok;
+}
+
+size_t countElements(const CollectivePerceptionMessage& msg)
+{
+  size_t count = 0;
+  const auto& containers = msg.payload.cpmContainers.list;
+  for (int i = 0; i < containers.count; i++)
+  {
+    const auto& container = containers.array[i]->containerData;
+    if (container.present == WrappedCpmContainer__containerData_PR_PerceivedObjectContainer)
+    {
+      count += container.choice.PerceivedObjectContainer.perceivedObjects.list.count;
+    }
+  }
+  return count;
+}
+
+size_t countElements(const MCM& msg)
+{
+  const auto& maneuver_container = msg.mcm.mcmParameters.maneuverContainer;
+  if (maneuver_container.present != ManeuverContainer_PR_roadUserContainer)
+  {
+    return 0;
+  }
+  const auto* trajectory = maneuver_container.choice.roadUserContainer.plannedTrajectory;
+  return trajectory != nullptr ? trajectory->trajectoryPointContainer.list.count : 0;
+}
+
+void beginAllocationBudget(size_t max_bytes)
+{
+  asn_alloc_budget_begin(max_bytes);
+}
+
+bool endAllocationBudget()
+{
+  return asn_alloc_budget_end() == 0;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,127 @@
+#include "v2x_etsi_asn1_lib/duplicate_filter.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+static constexpr uint64_t hash_mul = 0x9E3779B97F4A7C15ULL;
+
+static inline uint64_t mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+DuplicateFilter::DuplicateFilter(std::chrono::milliseconds window, size_t bucket_capacity, size_t num_buckets)
+  : bucket_span_ns_(std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(window).count() / std::max<size_t>(num_buckets, 1), 1))
+  // the load factor is at most 50% so that probe sequences stay short
+  , mask_(std::bit_ceil(std::max<size_t>(bucket_capacity, 1) * 2) - 1)
+  , buckets_(std::max<size_t>(num_buckets, 1) + 1)
+{
+  for (auto& bucket : buckets_)
+  {
+    bucket.entries.resize(mask_ + 1, 0);
+  }
+}
+
+uint64_t DuplicateFilter::fingerprint(uint16_t mid, uint32_t station_id, const uint8_t* data, size_t size)
+{
+  uint64_t h = mix((static_cast<uint64_t>(mid) << 32) | station_id) ^ (size * hash_mul);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+  {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    h = std::rotl(h ^ (word * hash_mul), 29) * hash_mul;
+  }
+  uint64_t tail = 0;
+  if (i < size)
+  {
+    std::memcpy(&tail, data + i, size - i);
+  }
+  h = mix(h ^ tail);
+  // 0 marks an empty slot
+  return h != 0 ? h : 1;
+}
+
+bool DuplicateFilter::contains(const Bucket& bucket, uint64_t fp) const
+{
+  for (size_t i = fp & mask_;; i = (i + 1) & mask_)
+  {
+    if (bucket.entries[i] == fp)
+    {
+      return true;
+    }
+    if (bucket.entries[i] == 0)
+    {
+      return false;
+    }
+  }
+}
+
+bool DuplicateFilter::insert(Bucket& bucket, uint64_t fp) const
+{
+  if (2 * (bucket.size + 1) > mask_ + 1)
+  {
+    return false;
+  }
+  size_t i = fp & mask_;
+  while (bucket.entries[i] != 0)
+  {
+    i = (i + 1) & mask_;
+  }
+  bucket.entries[i] = fp;
+  bucket.size++;
+  return true;
+}
+
+bool DuplicateFilter::isDuplicate(uint16_t mid,
+                                  uint32_t station_id,
+                                  const uint8_t* data,
+                                  size_t size,
+                                  Clock::time_point now)
+{
+  const auto fp = fingerprint(mid, station_id, data, size);
+  const int64_t epoch =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() / bucket_span_ns_;
+  const auto num_slices = static_cast<int64_t>(buckets_.size());
+
+  // The current (partially filled) time slice plus the previous ones cover at least the time window
+  auto& current = buckets_[epoch % num_slices];
+  if (current.epoch != epoch)
+  {
+    std::fill(current.entries.begin(), current.entries.end(), 0);
+    current.size = 0;
+    current.epoch = epoch;
+  }
+  for (const auto& bucket : buckets_)
+  {
+    if (bucket.epoch > epoch - num_slices && bucket.epoch <= epoch && contains(bucket, fp))
+    {
+      num_duplicates_++;
+      return true;
+    }
+  }
+  if (!insert(current, fp))
+  {
+    num_overflows_++;
+  }
+  return false;
+}
+
+uint64_t DuplicateFilter::numDuplicates() const
+{
+  return num_duplicates_;
+}
+
+uint64_t DuplicateFilter::numOverflows() const
+{
+  return num_overflows_;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,66 @@
+#include "v2x_etsi_asn1_lib/encoding.h"
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+const char* toString(WireEncoding encoding)
+{
+  switch (encoding)
+  {
+    case WireEncoding::UPER:
+      return "uper";
+    case WireEncoding::APER:
+      return "aper";
+    case WireEncoding::OER:
+      return "oer";
+  }
+  return "unknown";
+}
+
+std::optional<WireEncoding> wireEncodingFromString(std::string_view name)
+{
+  for (auto encoding : { WireEncoding::UPER, WireEncoding::APER, WireEncoding::OER })
+  {
+    if (name == toString(encoding))
+    {
+      return encoding;
+    }
+  }
+  return {};
+}
+
+asn_transfer_syntax transferSyntax(WireEncoding encoding)
+{
+  switch (encoding)
+  {
+    case WireEncoding::APER:
+      return ATS_ALIGNED_BASIC_PER;
+    case WireEncoding::OER:
+      return ATS_BASIC_OER;
+    case WireEncoding::UPER:
+      break;
+  }
+  return ATS_UNALIGNED_BASIC_PER;
+}
+
+asn_dec_rval_t decodeETSIMsg(const asn_TYPE_descriptor_t* type,
+                             WireEncoding encoding,
+                             void** msg,
+                             const void* buffer,
+                             size_t size,
+                             const asn_codec_ctx_t* ctx)
+{
+  if (encoding == WireEncoding::UPER)
+  {
+    // also checks that the whole buffer has been consumed
+    return uper_decode_complete(ctx, type, msg, buffer, size);
+  }
+  return asn_decode(ctx, transferSyntax(encoding), type, msg, buffer, size);
+}
+
+asn_encode_to_new_buffer_result_t encodeETSIMsg(const asn_TYPE_descriptor_t* type,
+                                                WireEncoding encoding,
+                                                const void* msg)
+{
+  return asn_encode_to_new_buffer(nullptr, transferSyntax(encoding), type, msg);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,114 @@
+#include "v2x_etsi_asn1_lib/generation_manager.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr double earth_radius = 6371000.0;
+constexpr double deg_to_rad = M_PI / 180.0;
+
+// Equirectangular approximation, accurate enough for distances of a few metres
+double distance(const GenerationState& a, const GenerationState& b)
+{
+  const double x = (b.longitude - a.longitude) * deg_to_rad * std::cos((a.latitude + b.latitude) * 0.5 * deg_to_rad);
+  const double y = (b.latitude - a.latitude) * deg_to_rad;
+  return std::hypot(x, y) * earth_radius;
+}
+
+double angleDifference(double a, double b)
+{
+  const double diff = std::fmod(std::fabs(a - b), 360.0);
+  return diff > 180.0 ? 360.0 - diff : diff;
+}
+}  // namespace
+
+GenerationRules GenerationRules::cam()
+{
+  using namespace std::chrono_literals;
+  return { 100ms, 1000ms, 500ms };
+}
+
+GenerationRules GenerationRules::vam()
+{
+  using namespace std::chrono_literals;
+  // T_GenVam is not adapted to the dynamics, the timer always uses T_GenVamMax
+  GenerationRules rules{ 100ms, 5000ms, 2000ms };
+  rules.num_keep_interval = 0;
+  return rules;
+}
+
+GenerationManager::GenerationManager(const GenerationRules& rules) : rules_(rules), interval_(rules.max_interval)
+{
+}
+
+GenerationDecision GenerationManager::check(const GenerationState& state, Clock::time_point now)
+{
+  GenerationDecision decision;
+  if (!last_time_)
+  {
+    decision.send = true;
+  }
+  else
+  {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - *last_time_);
+    if (elapsed < rules_.min_interval)
+    {
+      return decision;
+    }
+    if (dynamicsChanged(state))
+    {
+      decision.send = true;
+      interval_ = rules_.num_keep_interval > 0 ? std::min(elapsed, rules_.max_interval) : rules_.max_interval;
+      num_timer_triggered_ = 0;
+    }
+    else if (elapsed >= interval_)
+    {
+      decision.send = true;
+      if (++num_timer_triggered_ >= rules_.num_keep_interval)
+      {
+        interval_ = rules_.max_interval;
+      }
+    }
+  }
+  if (!decision.send)
+  {
+    return decision;
+  }
+
+  last_time_ = now;
+  last_state_ = state;
+  if (!last_low_frequency_time_ || now - *last_low_frequency_time_ >= rules_.low_frequency_interval)
+  {
+    decision.include_low_frequency_container = true;
+    last_low_frequency_time_ = now;
+  }
+  return decision;
+}
+
+void GenerationManager::reset()
+{
+  last_time_.reset();
+  last_low_frequency_time_.reset();
+  interval_ = rules_.max_interval;
+  num_timer_triggered_ = 0;
+}
+
+std::chrono::milliseconds GenerationManager::interval() const
+{
+  return interval_;
+}
+
+bool GenerationManager::dynamicsChanged(const GenerationState& state) const
+{
+  if (!std::isnan(state.heading) && !std::isnan(last_state_.heading) &&
+      angleDifference(state.heading, last_state_.heading) > rules_.heading_threshold)
+  {
+    return true;
+  }
+  return distance(last_state_, state) > rules_.position_threshold ||
+         std::fabs(state.speed - last_state_.speed) > rules_.speed_threshold;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,97 @@
+#include "v2x_etsi_asn1_lib/geo_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr double earth_radius = 6371000.0;
+constexpr double deg_to_rad = M_PI / 180.0;
+constexpr double max_latitude = 85.05112878;
+
+struct Tile
+{
+  uint32_t x;
+  uint32_t y;
+};
+
+Tile toTile(double latitude, double longitude, unsigned zoom)
+{
+  latitude = std::clamp(latitude, -max_latitude, max_latitude);
+  // to [-180, 180], 180 ends up in the last tile by the clamping below
+  longitude = std::remainder(longitude, 360.0);
+  const double x = (longitude + 180.0) / 360.0;
+  const double sin_latitude = std::sin(latitude * deg_to_rad);
+  const double y = 0.5 - std::log((1.0 + sin_latitude) / (1.0 - sin_latitude)) / (4.0 * M_PI);
+  const double map_size = static_cast<double>(uint32_t{ 1 } << zoom);
+  return { static_cast<uint32_t>(std::clamp(std::floor(x * map_size), 0.0, map_size - 1.0)),
+           static_cast<uint32_t>(std::clamp(std::floor(y * map_size), 0.0, map_size - 1.0)) };
+}
+
+std::string toQuadkey(Tile tile, unsigned zoom)
+{
+  std::string key(zoom, '0');
+  for (unsigned i = 0; i < zoom; i++)
+  {
+    const uint32_t mask = uint32_t{ 1 } << (zoom - 1 - i);
+    key[i] = static_cast<char>('0' + ((tile.x & mask) ? 1 : 0) + ((tile.y & mask) ? 2 : 0));
+  }
+  return key;
+}
+}  // namespace
+
+std::string quadkeyProperty(unsigned zoom)
+{
+  return "qk" + std::to_string(zoom);
+}
+
+std::string quadkey(double latitude, double longitude, unsigned zoom)
+{
+  zoom = std::clamp(zoom, 1u, max_quadkey_zoom);
+  return toQuadkey(toTile(latitude, longitude, zoom), zoom);
+}
+
+std::vector<std::string> quadkeysInArea(double latitude, double longitude, double radius, unsigned zoom)
+{
+  zoom = std::clamp(zoom, 1u, max_quadkey_zoom);
+  const double delta_latitude = radius / earth_radius / deg_to_rad;
+  const double delta_longitude =
+      delta_latitude / std::max(std::cos(std::clamp(latitude, -max_latitude, max_latitude) * deg_to_rad), 1e-6);
+  // tile y grows towards the south
+  const auto min = toTile(latitude + delta_latitude, longitude - delta_longitude, zoom);
+  const auto max = toTile(latitude - delta_latitude, longitude + delta_longitude, zoom);
+
+  // min.x is east of max.x if the area crosses the antimeridian
+  const uint32_t map_size = uint32_t{ 1 } << zoom;
+  const uint32_t num_x = delta_longitude >= 180.0 ? map_size : (max.x + map_size - min.x) % map_size + 1;
+
+  std::vector<std::string> keys;
+  keys.reserve(static_cast<size_t>(num_x) * (max.y - min.y + 1));
+  for (uint32_t y = min.y; y <= max.y; y++)
+  {
+    for (uint32_t i = 0; i < num_x; i++)
+    {
+      keys.push_back(toQuadkey({ (min.x + i) % map_size, y }, zoom));
+    }
+  }
+  return keys;
+}
+
+std::string quadkeySelector(double latitude, double longitude, double radius, unsigned zoom)
+{
+  std::string selector = quadkeyProperty(std::clamp(zoom, 1u, max_quadkey_zoom)) + " IN (";
+  bool first = true;
+  for (const auto& key : quadkeysInArea(latitude, longitude, radius, zoom))
+  {
+    selector += first ? "'" : ", '";
+    selector += key;
+    selector += "'";
+    first = false;
+  }
+  selector += ")";
+  return selector;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
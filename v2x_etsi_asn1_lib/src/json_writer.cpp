@@ -0,0 +1,382 @@
+#include "v2x_etsi_asn1_lib/json_writer.h"
+#include "v2x_etsi_asn1_lib/units.h"
+
+#include <BIT_STRING.h>
+#include <BOOLEAN.h>
+#include <IA5String.h>
+#include <INTEGER.h>
+#include <NULL.h>
+#include <NativeEnumerated.h>
+#include <NativeInteger.h>
+#include <NativeReal.h>
+#include <NumericString.h>
+#include <OCTET_STRING.h>
+#include <OPEN_TYPE.h>
+#include <PrintableString.h>
+#include <UTF8String.h>
+#include <VisibleString.h>
+#include <asn_SEQUENCE_OF.h>
+#include <constr_CHOICE.h>
+#include <constr_SEQUENCE.h>
+#include <constr_SEQUENCE_OF.h>
+#include <constr_SET_OF.h>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr char hex_digits[] = "0123456789abcdef";
+
+bool isCharacterString(const asn_TYPE_operation_t* op)
+{
+  return op == &asn_OP_IA5String || op == &asn_OP_UTF8String || op == &asn_OP_VisibleString ||
+         op == &asn_OP_NumericString || op == &asn_OP_PrintableString;
+}
+
+bool isSpecialValue(const asn_INTEGER_enum_map_t& value)
+{
+  return std::strstr(value.enum_name, "unavailable") != nullptr ||
+         std::strstr(value.enum_name, "OutOfRange") != nullptr ||
+         std::strstr(value.enum_name, "outOfRange") != nullptr;
+}
+
+const asn_INTEGER_enum_map_t* findNamedValue(const asn_TYPE_descriptor_t* type, long value)
+{
+  const auto* specs = static_cast<const asn_INTEGER_specifics_t*>(type->specifics);
+  return specs != nullptr && specs->map_count > 0 ? INTEGER_map_value2enum(specs, value) : nullptr;
+}
+
+unsigned presentIndex(const void* ptr, const asn_CHOICE_specifics_t& specs)
+{
+  const auto* present = static_cast<const char*>(ptr) + specs.pres_offset;
+  switch (specs.pres_size)
+  {
+    case sizeof(int):
+    {
+      int value;
+      std::memcpy(&value, present, sizeof(value));
+      return static_cast<unsigned>(value);
+    }
+    case sizeof(short):
+    {
+      short value;
+      std::memcpy(&value, present, sizeof(value));
+      return static_cast<unsigned>(value);
+    }
+    case sizeof(char):
+      return static_cast<unsigned char>(*present);
+    default:
+      return 0;
+  }
+}
+
+// Returns the address of the member within the struct at ptr, nullptr for absent optional members
+const void* memberPointer(const void* ptr, const asn_TYPE_member_t& member)
+{
+  const void* member_ptr = static_cast<const char*>(ptr) + member.memb_offset;
+  if (member.flags & ATF_POINTER)
+  {
+    return *static_cast<const void* const*>(member_ptr);
+  }
+  return member_ptr;
+}
+}  // namespace
+
+JsonWriter::JsonWriter(bool si_units) : si_units_(si_units)
+{
+}
+
+bool JsonWriter::write(const asn_TYPE_descriptor_t& type, const void* msg)
+{
+  const bool ok = writeValue(&type, msg);
+  buffer_ += '\n';
+  return ok;
+}
+
+std::string_view JsonWriter::buffer() const
+{
+  return buffer_;
+}
+
+void JsonWriter::clear()
+{
+  buffer_.clear();
+}
+
+bool JsonWriter::writeValue(const asn_TYPE_descriptor_t* type, const void* ptr)
+{
+  const auto* op = type->op;
+  if (op == &asn_OP_SEQUENCE)
+  {
+    return writeSequence(type, ptr);
+  }
+  if (op == &asn_OP_CHOICE || op == &asn_OP_OPEN_TYPE)
+  {
+    return writeChoice(type, ptr);
+  }
+  if (op == &asn_OP_SEQUENCE_OF || op == &asn_OP_SET_OF)
+  {
+    return writeList(type, ptr);
+  }
+  if (op == &asn_OP_NativeInteger)
+  {
+    const auto* specs = static_cast<const asn_INTEGER_specifics_t*>(type->specifics);
+    const long value = *static_cast<const long*>(ptr);
+    writeInteger(type,
+                 specs != nullptr && specs->field_unsigned ? static_cast<intmax_t>(static_cast<unsigned long>(value)) :
+                                                              value);
+    return true;
+  }
+  if (op == &asn_OP_NativeEnumerated)
+  {
+    const long value = *static_cast<const long*>(ptr);
+    const auto* named = findNamedValue(type, value);
+    if (named != nullptr)
+    {
+      writeString(named->enum_name, named->enum_len);
+    }
+    else
+    {
+      writeNumber(value);
+    }
+    return true;
+  }
+  if (op == &asn_OP_INTEGER)
+  {
+    intmax_t value;
+    if (asn_INTEGER2imax(static_cast<const INTEGER_t*>(ptr), &value) != 0)
+    {
+      buffer_ += "null";
+      return false;
+    }
+    writeInteger(type, value);
+    return true;
+  }
+  if (op == &asn_OP_BOOLEAN)
+  {
+    buffer_ += *static_cast<const BOOLEAN_t*>(ptr) ? "true" : "false";
+    return true;
+  }
+  if (op == &asn_OP_NULL)
+  {
+    buffer_ += "null";
+    return true;
+  }
+  if (op == &asn_OP_NativeReal)
+  {
+    const auto* specs = static_cast<const asn_NativeReal_specifics_t*>(type->specifics);
+    if (specs != nullptr && specs->float_size == sizeof(float))
+    {
+      writeNumber(static_cast<double>(*static_cast<const float*>(ptr)));
+    }
+    else
+    {
+      writeNumber(*static_cast<const double*>(ptr));
+    }
+    return true;
+  }
+  if (op == &asn_OP_BIT_STRING)
+  {
+    const auto* bits = static_cast<const BIT_STRING_t*>(ptr);
+    const size_t num_bits = bits->size * 8 - (bits->size > 0 ? bits->bits_unused : 0);
+    buffer_ += '"';
+    for (size_t i = 0; i < num_bits; i++)
+    {
+      buffer_ += (bits->buf[i / 8] & (0x80 >> (i % 8))) ? '1' : '0';
+    }
+    buffer_ += '"';
+    return true;
+  }
+  if (isCharacterString(op))
+  {
+    const auto* str = static_cast<const OCTET_STRING_t*>(ptr);
+    writeString(reinterpret_cast<const char*>(str->buf), str->size);
+    return true;
+  }
+  if (op == &asn_OP_OCTET_STRING)
+  {
+    const auto* str = static_cast<const OCTET_STRING_t*>(ptr);
+    buffer_ += '"';
+    for (size_t i = 0; i < str->size; i++)
+    {
+      buffer_ += hex_digits[str->buf[i] >> 4];
+      buffer_ += hex_digits[str->buf[i] & 0xf];
+    }
+    buffer_ += '"';
+    return true;
+  }
+  buffer_ += "null";
+  return false;
+}
+
+bool JsonWriter::writeSequence(const asn_TYPE_descriptor_t* type, const void* ptr)
+{
+  bool ok = true;
+  bool first = true;
+  buffer_ += '{';
+  for (unsigned i = 0; i < type->elements_count; i++)
+  {
+    const auto& member = type->elements[i];
+    const void* member_ptr = memberPointer(ptr, member);
+    if (member_ptr == nullptr)
+    {
+      continue;
+    }
+    if (!first)
+    {
+      buffer_ += ',';
+    }
+    first = false;
+    writeKey(member.name);
+    ok = writeValue(member.type, member_ptr) && ok;
+  }
+  buffer_ += '}';
+  return ok;
+}
+
+bool JsonWriter::writeChoice(const asn_TYPE_descriptor_t* type, const void* ptr)
+{
+  const auto present = presentIndex(ptr, *static_cast<const asn_CHOICE_specifics_t*>(type->specifics));
+  if (present == 0 || present > type->elements_count)
+  {
+    buffer_ += "null";
+    return false;
+  }
+  const auto& member = type->elements[present - 1];
+  const void* member_ptr = memberPointer(ptr, member);
+  buffer_ += '{';
+  writeKey(member.name);
+  bool ok = true;
+  if (member_ptr != nullptr)
+  {
+    ok = writeValue(member.type, member_ptr);
+  }
+  else
+  {
+    buffer_ += "null";
+  }
+  buffer_ += '}';
+  return ok;
+}
+
+bool JsonWriter::writeList(const asn_TYPE_descriptor_t* type, const void* ptr)
+{
+  const auto* list = _A_CSEQUENCE_FROM_VOID(ptr);
+  const auto* element_type = type->elements[0].type;
+  bool ok = true;
+  buffer_ += '[';
+  for (int i = 0; i < list->count; i++)
+  {
+    if (i > 0)
+    {
+      buffer_ += ',';
+    }
+    if (list->array[i] != nullptr)
+    {
+      ok = writeValue(element_type, list->array[i]) && ok;
+    }
+    else
+    {
+      buffer_ += "null";
+    }
+  }
+  buffer_ += ']';
+  return ok;
+}
+
+void JsonWriter::writeInteger(const asn_TYPE_descriptor_t* type, intmax_t value)
+{
+  const Scale* scale = si_units_ ? findScale(type) : nullptr;
+  if (scale == nullptr)
+  {
+    writeNumber(value);
+    return;
+  }
+  const auto* named = findNamedValue(type, static_cast<long>(value));
+  if (named != nullptr && isSpecialValue(*named))
+  {
+    writeString(named->enum_name, named->enum_len);
+  }
+  else if (scale->divisor != 0.0)
+  {
+    writeNumber(static_cast<double>(value) / scale->divisor);
+  }
+  else
+  {
+    writeNumber(static_cast<double>(value) * scale->factor);
+  }
+}
+
+void JsonWriter::writeKey(const char* name)
+{
+  // ASN.1 identifiers do not need escaping
+  buffer_ += '"';
+  buffer_ += name;
+  buffer_ += "\":";
+}
+
+void JsonWriter::writeString(const char* data, size_t size)
+{
+  buffer_ += '"';
+  for (size_t i = 0; i < size; i++)
+  {
+    const auto c = static_cast<unsigned char>(data[i]);
+    if (c == '"' || c == '\\')
+    {
+      buffer_ += '\\';
+      buffer_ += static_cast<char>(c);
+    }
+    else if (c < 0x20)
+    {
+      buffer_ += "\\u00";
+      buffer_ += hex_digits[c >> 4];
+      buffer_ += hex_digits[c & 0xf];
+    }
+    else
+    {
+      buffer_ += static_cast<char>(c);
+    }
+  }
+  buffer_ += '"';
+}
+
+template <class T>
+void JsonWriter::writeNumber(T value)
+{
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    if (!std::isfinite(value))
+    {
+      buffer_ += "null";
+      return;
+    }
+  }
+  char chars[32];
+  const auto result = std::to_chars(chars, chars + sizeof(chars), value);
+  buffer_.append(chars, result.ptr);
+}
+
+const JsonWriter::Scale* JsonWriter::findScale(const asn_TYPE_descriptor_t* type)
+{
+  auto [it, inserted] = scales_.try_emplace(type);
+  if (inserted)
+  {
+    for (const auto& unit : unit_scales)
+    {
+      if (std::strcmp(unit.type_name, type->name) == 0)
+      {
+        const double divisor = std::round(1.0 / unit.scale);
+        const bool exact = unit.scale < 1.0 && std::fabs(divisor * unit.scale - 1.0) < 1e-12;
+        it->second = Scale{ unit.scale, exact ? divisor : 0.0 };
+        break;
+      }
+    }
+  }
+  return it->second ? &*it->second : nullptr;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
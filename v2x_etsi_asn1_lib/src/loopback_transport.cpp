@@ -0,0 +1,168 @@
+#include "v2x_etsi_asn1_lib/loopback_transport.h"
+
+#include <algorithm>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+std::shared_ptr<LoopbackBus> LoopbackBus::create()
+{
+  return std::shared_ptr<LoopbackBus>(new LoopbackBus());
+}
+
+std::shared_ptr<LoopbackTransport> LoopbackBus::attach(Filter filter)
+{
+  std::shared_ptr<LoopbackTransport> transport(new LoopbackTransport(shared_from_this(), std::move(filter)));
+  std::lock_guard<std::mutex> l(lock_);
+  transports_.push_back(transport.get());
+  return transport;
+}
+
+bool LoopbackBus::waitUntilIdle(std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> l(lock_);
+  return idle_.wait_for(l, timeout, [this]() { return num_pending_ == 0; });
+}
+
+uint64_t LoopbackBus::numSent() const
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return num_sent_;
+}
+
+void LoopbackBus::publish(const LoopbackTransport& sender, const proton::message& message)
+{
+  const auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> l(lock_);
+  num_sent_++;
+  for (auto* transport : transports_)
+  {
+    if (transport == &sender || (transport->filter_ && !transport->filter_(message)))
+    {
+      continue;
+    }
+    if (transport->push(message, now))
+    {
+      num_pending_++;
+    }
+  }
+}
+
+void LoopbackBus::detach(LoopbackTransport& transport)
+{
+  std::lock_guard<std::mutex> l(lock_);
+  transports_.erase(std::remove(transports_.begin(), transports_.end(), &transport), transports_.end());
+  std::lock_guard<std::mutex> lt(transport.lock_);
+  num_pending_ -= transport.queue_.size();
+  transport.queue_.clear();
+  if (num_pending_ == 0)
+  {
+    idle_.notify_all();
+  }
+}
+
+void LoopbackBus::handled(size_t num_messages)
+{
+  std::lock_guard<std::mutex> l(lock_);
+  num_pending_ -= num_messages;
+  if (num_pending_ == 0)
+  {
+    idle_.notify_all();
+  }
+}
+
+LoopbackTransport::LoopbackTransport(std::shared_ptr<LoopbackBus> bus, LoopbackBus::Filter filter)
+  : bus_(std::move(bus)), filter_(std::move(filter))
+{
+}
+
+LoopbackTransport::~LoopbackTransport()
+{
+  bus_->detach(*this);
+}
+
+bool LoopbackTransport::push(const proton::message& message, std::chrono::steady_clock::time_point now)
+{
+  const auto ttl = message.ttl().milliseconds();
+  const auto expiry_time =
+      ttl > 0 ? now + std::chrono::milliseconds(ttl) : std::chrono::steady_clock::time_point::max();
+  std::lock_guard<std::mutex> l(lock_);
+  if (closed_)
+  {
+    return false;
+  }
+  queue_.push_back({ message, expiry_time });
+  ready_.notify_one();
+  return true;
+}
+
+bool LoopbackTransport::send(const OutgoingETSIMessage& message)
+{
+  if (!is_sender_connected())
+  {
+    return false;
+  }
+  bus_->publish(*this, makeProtonMessage(message));
+  if (message.on_settled)
+  {
+    message.on_settled(true);
+  }
+  return true;
+}
+
+bool LoopbackTransport::receive(ETSIMessageSink& sink)
+{
+  Entry entry;
+  {
+    std::unique_lock<std::mutex> l(lock_);
+    ready_.wait(l, [this]() { return closed_ || !queue_.empty(); });
+    if (closed_)
+    {
+      return false;
+    }
+    entry = std::move(queue_.front());
+    queue_.pop_front();
+    if (std::chrono::steady_clock::now() > entry.expiry_time)
+    {
+      num_expired_++;
+      l.unlock();
+      bus_->handled(1);
+      return true;
+    }
+    num_received_++;
+  }
+  sink.deliver(entry.message);
+  bus_->handled(1);
+  return true;
+}
+
+bool LoopbackTransport::is_sender_connected()
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return !closed_;
+}
+
+void LoopbackTransport::close()
+{
+  size_t num_dropped;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    closed_ = true;
+    num_dropped = queue_.size();
+    queue_.clear();
+    ready_.notify_all();
+  }
+  bus_->handled(num_dropped);
+}
+
+uint64_t LoopbackTransport::numReceived() const
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return num_received_;
+}
+
+uint64_t LoopbackTransport::numExpired() const
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return num_expired_;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
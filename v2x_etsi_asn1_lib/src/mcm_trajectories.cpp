@@ -0,0 +1,411 @@
+#include "v2x_etsi_asn1_lib/mcm_trajectories.h"
+#include "v2x_etsi_asn1_lib/time_conversions.h"
+#include "v2x_etsi_asn1_lib/units.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+// TrajectoryStartDeltaTime and TrajectoryPointDeltaTime are given in oneMilliSec(1)
+constexpr double trajectory_delta_time_unit_s = 0.001;
+// RoadUserLength and RoadUserWidth are given in tenCentimeters(1)
+constexpr double road_user_dimension_unit_m = 0.1;
+// grid rows are padded to a multiple of this many floats
+constexpr size_t row_alignment = 16;
+// fraction of a step by which a point may miss a step time
+constexpr float step_tolerance = 1e-3f;
+
+float decodeDimension(long value)
+{
+  return value >= RoadUserLength_outOfRange ? nan : static_cast<float>(value * road_user_dimension_unit_m);
+}
+
+// Linear interpolation of headings in degrees along the shorter arc
+float interpolateHeading(float a, float b, float u)
+{
+  float diff = b - a;
+  diff -= 360.f * std::round(diff / 360.f);
+  const float heading = a + u * diff;
+  return heading < 0.f ? heading + 360.f : (heading >= 360.f ? heading - 360.f : heading);
+}
+}  // namespace
+
+McmTrajectorySet::McmTrajectorySet(double origin_latitude,
+                                   double origin_longitude,
+                                   std::chrono::milliseconds step,
+                                   size_t num_steps)
+  : projection_(origin_latitude, origin_longitude)
+  , step_(std::max(step, std::chrono::milliseconds(1)))
+  , num_steps_(std::max<size_t>(num_steps, 1))
+  , stride_((num_steps_ + row_alignment - 1) / row_alignment * row_alignment)
+{
+}
+
+void McmTrajectorySet::reset(uint64_t start_time)
+{
+  start_time_ = start_time;
+  station_ids_.clear();
+  radii_.clear();
+  ranges_.clear();
+  bounds_.clear();
+  x_.clear();
+  y_.clear();
+  speed_.clear();
+  heading_.clear();
+}
+
+std::optional<size_t> McmTrajectorySet::addMCM(const MCM& msg, uint64_t now_unix_time, float default_radius)
+{
+  const auto& container = msg.mcm.mcmParameters.maneuverContainer;
+  if (container.present != ManeuverContainer_PR_roadUserContainer ||
+      container.choice.roadUserContainer.plannedTrajectory == nullptr)
+  {
+    return {};
+  }
+  const auto& road_user = container.choice.roadUserContainer;
+  const auto& trajectory = *road_user.plannedTrajectory;
+  const auto& reference = msg.mcm.mcmParameters.basicContainer.referencePosition;
+  if (reference.latitude == Latitude_unavailable || reference.longitude == Longitude_unavailable)
+  {
+    return {};
+  }
+
+  // Gather the raw values of all points, then scale them in dense loops
+  const auto& points = trajectory.trajectoryPointContainer.list;
+  const auto num_points = static_cast<size_t>(points.count);
+  points_time_.resize(num_points);
+  points_x_.resize(num_points);
+  points_y_.resize(num_points);
+  points_speed_.resize(num_points);
+  points_heading_.resize(num_points);
+  for (size_t i = 0; i < num_points; i++)
+  {
+    const auto& point = *points.array[i];
+    points_x_[i] = static_cast<float>(point.waypoint.xDistance);
+    points_y_[i] = static_cast<float>(point.waypoint.yDistance);
+    points_speed_[i] = static_cast<float>(point.speed);
+    points_heading_[i] = static_cast<float>(point.heading);
+  }
+
+  const auto generation_time = GenerationDeltaTime2UnixTime(msg.mcm.generationDeltaTime, now_unix_time);
+  const auto first_time = static_cast<float>(
+      static_cast<double>(static_cast<int64_t>(generation_time - start_time_)) * 1e-9 +
+      static_cast<double>(trajectory.startDeltaTime) * trajectory_delta_time_unit_s);
+  const auto delta_time = static_cast<float>(static_cast<double>(trajectory.deltaTime) * trajectory_delta_time_unit_s);
+  const auto offset = projection_.toLocal(static_cast<double>(reference.latitude) * LatitudeUnit_degree,
+                                          static_cast<double>(reference.longitude) * LongitudeUnit_degree);
+  const auto offset_x = static_cast<float>(offset.x);
+  const auto offset_y = static_cast<float>(offset.y);
+  const auto coordinate_unit = static_cast<float>(CartesianCoordinateLargeUnit_m);
+  const auto speed_unit = static_cast<float>(SpeedValueUnit_m_s);
+  const auto heading_unit = static_cast<float>(HeadingValueUnit_degree);
+  const auto speed_unavailable = static_cast<float>(SpeedValue_unavailable);
+  const auto heading_unavailable = static_cast<float>(HeadingValue_unavailable);
+  for (size_t i = 0; i < num_points; i++)
+  {
+    points_time_[i] = first_time + static_cast<float>(i) * delta_time;
+    points_x_[i] = offset_x + points_x_[i] * coordinate_unit;
+    points_y_[i] = offset_y + points_y_[i] * coordinate_unit;
+    points_speed_[i] = points_speed_[i] == speed_unavailable ? nan : points_speed_[i] * speed_unit;
+    points_heading_[i] = points_heading_[i] == heading_unavailable ? nan : points_heading_[i] * heading_unit;
+  }
+
+  const auto& state = road_user.roadUserState;
+  const float radius = 0.5f * std::hypot(decodeDimension(state.length), decodeDimension(state.width));
+  return resamplePoints(static_cast<StationId_t>(msg.header.stationId),
+                        std::isnan(radius) ? default_radius : radius);
+}
+
+std::optional<size_t> McmTrajectorySet::addTrajectory(StationId_t station_id,
+                                                      float radius,
+                                                      const std::vector<TrajectorySample>& samples)
+{
+  if (samples.empty())
+  {
+    return {};
+  }
+  points_time_.resize(samples.size());
+  points_x_.resize(samples.size());
+  points_y_.resize(samples.size());
+  points_speed_.resize(samples.size());
+  points_heading_.resize(samples.size());
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    points_time_[i] =
+        static_cast<float>(static_cast<double>(static_cast<int64_t>(samples[i].time - start_time_)) * 1e-9);
+    points_x_[i] = static_cast<float>(samples[i].x);
+    points_y_[i] = static_cast<float>(samples[i].y);
+    points_speed_[i] = static_cast<float>(samples[i].speed);
+    points_heading_[i] = static_cast<float>(samples[i].heading);
+  }
+  return resamplePoints(station_id, radius);
+}
+
+std::optional<size_t> McmTrajectorySet::resamplePoints(StationId_t station_id, float radius)
+{
+  const size_t num_points = points_time_.size();
+  if (num_points == 0)
+  {
+    return {};
+  }
+  const size_t index = station_ids_.size();
+  station_ids_.push_back(station_id);
+  radii_.push_back(radius);
+  x_.resize(x_.size() + stride_, nan);
+  y_.resize(y_.size() + stride_, nan);
+  speed_.resize(speed_.size() + stride_, nan);
+  heading_.resize(heading_.size() + stride_, nan);
+  float* __restrict x = &x_[index * stride_];
+  float* __restrict y = &y_[index * stride_];
+  float* __restrict speed = &speed_[index * stride_];
+  float* __restrict heading = &heading_[index * stride_];
+
+  // Steps within the time span of the points, tolerating rounding errors of points at step times
+  const float step = std::chrono::duration<float>(step_).count();
+  const float first = std::ceil(points_time_.front() / step - step_tolerance);
+  const float last = std::floor(points_time_.back() / step + step_tolerance);
+  StepRange range;
+  if (last >= 0.f && first < static_cast<float>(num_steps_) && first <= last)
+  {
+    range.begin = static_cast<uint32_t>(std::max(first, 0.f));
+    range.end = static_cast<uint32_t>(std::min(last + 1.f, static_cast<float>(num_steps_)));
+  }
+  ranges_.push_back(range);
+
+  size_t k = 0;
+  for (uint32_t s = range.begin; s < range.end; s++)
+  {
+    const float t = static_cast<float>(s) * step;
+    while (k + 2 < num_points && points_time_[k + 1] < t)
+    {
+      k++;
+    }
+    const size_t next = std::min(k + 1, num_points - 1);
+    const float span = points_time_[next] - points_time_[k];
+    const float u = span > 0.f ? std::clamp((t - points_time_[k]) / span, 0.f, 1.f) : 0.f;
+    x[s] = points_x_[k] + u * (points_x_[next] - points_x_[k]);
+    y[s] = points_y_[k] + u * (points_y_[next] - points_y_[k]);
+    speed[s] = points_speed_[k] + u * (points_speed_[next] - points_speed_[k]);
+    heading[s] = interpolateHeading(points_heading_[k], points_heading_[next], u);
+  }
+
+  Bounds bounds{ std::numeric_limits<float>::max(),
+                 std::numeric_limits<float>::max(),
+                 std::numeric_limits<float>::lowest(),
+                 std::numeric_limits<float>::lowest() };
+  for (uint32_t s = range.begin; s < range.end; s++)
+  {
+    bounds.min_x = std::min(bounds.min_x, x[s]);
+    bounds.min_y = std::min(bounds.min_y, y[s]);
+    bounds.max_x = std::max(bounds.max_x, x[s]);
+    bounds.max_y = std::max(bounds.max_y, y[s]);
+  }
+  bounds_.push_back(bounds);
+
+  points_time_.clear();
+  points_x_.clear();
+  points_y_.clear();
+  points_speed_.clear();
+  points_heading_.clear();
+  return index;
+}
+
+bool McmTrajectorySet::mayConflict(size_t first, size_t second, float margin) const
+{
+  const auto& a = bounds_[first];
+  const auto& b = bounds_[second];
+  const float distance = radii_[first] + radii_[second] + margin;
+  return a.min_x - distance <= b.max_x && b.min_x - distance <= a.max_x && a.min_y - distance <= b.max_y &&
+         b.min_y - distance <= a.max_y;
+}
+
+std::optional<TrajectoryConflict> McmTrajectorySet::findConflict(size_t first, size_t second, float margin) const
+{
+  const uint32_t begin = std::max(ranges_[first].begin, ranges_[second].begin);
+  const uint32_t end = std::min(ranges_[first].end, ranges_[second].end);
+  if (begin >= end || !mayConflict(first, second, margin))
+  {
+    return {};
+  }
+  const float distance = radii_[first] + radii_[second] + margin;
+  const float distance2 = distance * distance;
+  const float* __restrict ax = x(first);
+  const float* __restrict ay = y(first);
+  const float* __restrict bx = x(second);
+  const float* __restrict by = y(second);
+
+  // Squared distance at the closest approach between step s and s + 1 (or at step s for the last one), and the
+  // fraction of the step at which it is reached. The relative position moves linearly within a step.
+  auto closestApproach = [&](uint32_t s, float& u) {
+    const uint32_t next = std::min(s + 1, end - 1);
+    const float dx = ax[s] - bx[s];
+    const float dy = ay[s] - by[s];
+    const float ex = (ax[next] - bx[next]) - dx;
+    const float ey = (ay[next] - by[next]) - dy;
+    const float e2 = ex * ex + ey * ey;
+    u = std::clamp(-(dx * ex + dy * ey) / std::max(e2, 1e-12f), 0.f, 1.f);
+    const float cx = dx + u * ex;
+    const float cy = dy + u * ey;
+    return cx * cx + cy * cy;
+  };
+
+  // Branchless pass over all steps, only the rare conflicts are searched for the earliest step and their closest
+  // approach
+  uint32_t hits = 0;
+  for (uint32_t s = begin; s < end; s++)
+  {
+    float u;
+    hits |= static_cast<uint32_t>(closestApproach(s, u) < distance2);
+  }
+  if (hits == 0)
+  {
+    return {};
+  }
+  uint32_t s = begin;
+  float u;
+  float d2 = closestApproach(s, u);
+  while (d2 >= distance2)
+  {
+    d2 = closestApproach(++s, u);
+  }
+
+  // The distance drops below the threshold at the smaller root of |d + v * e|^2 = distance^2 within step s, unless
+  // it is already below at the step
+  const float dx = ax[s] - bx[s];
+  const float dy = ay[s] - by[s];
+  const float c = dx * dx + dy * dy - distance2;
+  float entry = 0.f;
+  if (c >= 0.f)
+  {
+    const uint32_t next = std::min(s + 1, end - 1);
+    const float ex = (ax[next] - bx[next]) - dx;
+    const float ey = (ay[next] - by[next]) - dy;
+    const float e2 = ex * ex + ey * ey;
+    const float b = dx * ex + dy * ey;
+    entry = std::clamp((-b - std::sqrt(std::max(b * b - e2 * c, 0.f))) / std::max(e2, 1e-12f), 0.f, u);
+  }
+
+  // Closest approach until the distance exceeds the threshold again
+  uint32_t closest_step = s;
+  float closest_u = u;
+  float closest_d2 = d2;
+  for (uint32_t i = s + 1; i < end; i++)
+  {
+    float v;
+    const float next_d2 = closestApproach(i, v);
+    if (next_d2 >= distance2)
+    {
+      break;
+    }
+    if (next_d2 < closest_d2)
+    {
+      closest_step = i;
+      closest_u = v;
+      closest_d2 = next_d2;
+    }
+  }
+
+  const auto step_ns = static_cast<double>(std::chrono::nanoseconds(step_).count());
+  TrajectoryConflict conflict;
+  conflict.first = first;
+  conflict.second = second;
+  conflict.time = start_time_ + static_cast<uint64_t>((static_cast<double>(s) + entry) * step_ns);
+  conflict.closest_time =
+      start_time_ + static_cast<uint64_t>((static_cast<double>(closest_step) + closest_u) * step_ns);
+  conflict.distance = std::sqrt(closest_d2);
+  return conflict;
+}
+
+std::vector<TrajectoryConflict> McmTrajectorySet::findConflicts(size_t index, float margin) const
+{
+  std::vector<TrajectoryConflict> conflicts;
+  for (size_t other = 0; other < size(); other++)
+  {
+    if (other == index)
+    {
+      continue;
+    }
+    if (auto conflict = findConflict(index, other, margin))
+    {
+      conflicts.push_back(*conflict);
+    }
+  }
+  return conflicts;
+}
+
+std::vector<TrajectoryConflict> McmTrajectorySet::findConflicts(float margin) const
+{
+  std::vector<TrajectoryConflict> conflicts;
+  for (size_t first = 0; first < size(); first++)
+  {
+    for (size_t second = first + 1; second < size(); second++)
+    {
+      if (auto conflict = findConflict(first, second, margin))
+      {
+        conflicts.push_back(*conflict);
+      }
+    }
+  }
+  return conflicts;
+}
+
+size_t McmTrajectorySet::size() const
+{
+  return station_ids_.size();
+}
+
+uint64_t McmTrajectorySet::startTime() const
+{
+  return start_time_;
+}
+
+std::chrono::milliseconds McmTrajectorySet::step() const
+{
+  return step_;
+}
+
+size_t McmTrajectorySet::numSteps() const
+{
+  return num_steps_;
+}
+
+size_t McmTrajectorySet::stride() const
+{
+  return stride_;
+}
+
+StationId_t McmTrajectorySet::stationId(size_t index) const
+{
+  return station_ids_[index];
+}
+
+float McmTrajectorySet::radius(size_t index) const
+{
+  return radii_[index];
+}
+
+const float* McmTrajectorySet::x(size_t index) const
+{
+  return &x_[index * stride_];
+}
+
+const float* McmTrajectorySet::y(size_t index) const
+{
+  return &y_[index * stride_];
+}
+
+const float* McmTrajectorySet::speed(size_t index) const
+{
+  return &speed_[index * stride_];
+}
+
+const float* McmTrajectorySet::heading(size_t index) const
+{
+  return &heading_[index * stride_];
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
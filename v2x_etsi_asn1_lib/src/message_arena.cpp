@@ -0,0 +1,57 @@
+#include "v2x_etsi_asn1_lib/message_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+MessageArena::MessageArena(size_t block_size) : block_size_(block_size)
+{
+}
+
+void* MessageArena::allocate(size_t size, size_t alignment)
+{
+  for (; current_ < blocks_.size(); current_++, offset_ = 0)
+  {
+    auto& block = blocks_[current_];
+    const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+    const size_t offset = ((base + offset_ + alignment - 1) & ~(alignment - 1)) - base;
+    if (offset + size <= block.size)
+    {
+      used_ += offset + size - offset_;
+      offset_ = offset + size;
+      auto* ptr = block.data.get() + offset;
+      std::memset(ptr, 0, size);
+      return ptr;
+    }
+  }
+
+  // the padding guarantees that the allocation fits after aligning
+  const size_t new_size = std::max(block_size_, size + alignment);
+  blocks_.push_back({ std::make_unique_for_overwrite<std::byte[]>(new_size), new_size });
+  return allocate(size, alignment);
+}
+
+void MessageArena::reset()
+{
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+size_t MessageArena::used() const
+{
+  return used_;
+}
+
+size_t MessageArena::capacity() const
+{
+  size_t capacity = 0;
+  for (const auto& block : blocks_)
+  {
+    capacity += block.size;
+  }
+  return capacity;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
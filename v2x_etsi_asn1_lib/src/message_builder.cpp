@@ -0,0 +1,106 @@
+#include "v2x_etsi_asn1_lib/message_builder.h"
+#include "v2x_etsi_asn1_lib/units.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr double confidence95 = 1.96;
+
+long scaled(double value, double unit, long min, long max, long unavailable)
+{
+  if (std::isnan(value))
+  {
+    return unavailable;
+  }
+  return static_cast<long>(std::clamp(std::round(value / unit), static_cast<double>(min), static_cast<double>(max)));
+}
+
+// Confidences are the 95 % interval, their smallest valid value is 1
+long confidence(double stddev, double unit, long out_of_range, long unavailable)
+{
+  return scaled(stddev * confidence95, unit, 1, out_of_range, unavailable);
+}
+
+// ReferencePosition and ReferencePositionWithConfidence only differ in the confidence ellipse
+template <class P>
+void setPosition(P& position, double latitude, double longitude, double altitude)
+{
+  position.latitude = scaled(latitude, LatitudeUnit_degree, -900000000, 900000000, Latitude_unavailable);
+  position.longitude = scaled(longitude, LongitudeUnit_degree, -1799999999, 1800000000, Longitude_unavailable);
+  position.altitude.altitudeValue = scaled(altitude,
+                                           AltitudeValueUnit_metre,
+                                           AltitudeValue_negativeOutOfRange,
+                                           AltitudeValue_postiveOutOfRange,
+                                           AltitudeValue_unavailable);
+  position.altitude.altitudeConfidence = AltitudeConfidence_unavailable;
+}
+}  // namespace
+
+void setReferencePosition(ReferencePosition_t& position, double latitude, double longitude, double altitude)
+{
+  setPosition(position, latitude, longitude, altitude);
+  position.positionConfidenceEllipse.semiMajorConfidence = SemiAxisLength_unavailable;
+  position.positionConfidenceEllipse.semiMinorConfidence = SemiAxisLength_unavailable;
+  position.positionConfidenceEllipse.semiMajorOrientation = HeadingValue_unavailable;
+}
+
+void setReferencePosition(ReferencePositionWithConfidence_t& position,
+                          double latitude,
+                          double longitude,
+                          double altitude)
+{
+  setPosition(position, latitude, longitude, altitude);
+  position.positionConfidenceEllipse.semiMajorAxisLength = SemiAxisLength_unavailable;
+  position.positionConfidenceEllipse.semiMinorAxisLength = SemiAxisLength_unavailable;
+  position.positionConfidenceEllipse.semiMajorAxisOrientation = Wgs84AngleValue_unavailable;
+}
+
+void setSpeed(Speed_t& speed, double value, double stddev)
+{
+  speed.speedValue = scaled(value, SpeedValueUnit_m_s, 0, SpeedValue_outOfRange, SpeedValue_unavailable);
+  speed.speedConfidence =
+      confidence(stddev, SpeedConfidenceUnit_m_s, SpeedConfidence_outOfRange, SpeedConfidence_unavailable);
+}
+
+void setHeading(Heading_t& heading, double value, double stddev)
+{
+  if (std::isnan(value))
+  {
+    heading.headingValue = HeadingValue_unavailable;
+  }
+  else
+  {
+    const auto full_circle = std::lround(360.0 / HeadingValueUnit_degree);
+    heading.headingValue = ((std::lround(value / HeadingValueUnit_degree) % full_circle) + full_circle) % full_circle;
+  }
+  heading.headingConfidence =
+      confidence(stddev, HeadingConfidenceUnit_degree, HeadingConfidence_outOfRange, HeadingConfidence_unavailable);
+}
+
+void setCartesianCoordinate(CartesianCoordinateWithConfidence_t& coordinate, double value, double stddev)
+{
+  // there is no unavailable value
+  coordinate.value = scaled(value,
+                            CartesianCoordinateLargeUnit_m,
+                            CartesianCoordinateLarge_negativeOutOfRange,
+                            CartesianCoordinateLarge_positiveOutOfRange,
+                            0);
+  coordinate.confidence =
+      confidence(stddev, CoordinateConfidenceUnit_m, CoordinateConfidence_outOfRange, CoordinateConfidence_unavailable);
+}
+
+void setVelocityComponent(VelocityComponent_t& velocity, double value, double stddev)
+{
+  velocity.value = scaled(value,
+                          VelocityComponentValueUnit_m_s,
+                          VelocityComponentValue_negativeOutOfRange,
+                          VelocityComponentValue_positiveOutOfRange,
+                          VelocityComponentValue_unavailable);
+  velocity.confidence =
+      confidence(stddev, SpeedConfidenceUnit_m_s, SpeedConfidence_outOfRange, SpeedConfidence_unavailable);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,137 @@
+#include "v2x_etsi_asn1_lib/message_hub.h"
+
+#include <algorithm>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+bool HubFilter::matches(const BinaryETSIMessage& msg_bin) const
+{
+  if (!message_types.empty() &&
+      std::find(message_types.begin(), message_types.end(), msg_bin.message_type) == message_types.end())
+  {
+    return false;
+  }
+  if (!station_ids.empty() &&
+      std::find(station_ids.begin(), station_ids.end(), msg_bin.station_id) == station_ids.end())
+  {
+    return false;
+  }
+  return !destination_station_id || !msg_bin.destination_station_id ||
+         *msg_bin.destination_station_id == *destination_station_id;
+}
+
+HubSubscription::HubSubscription(HubFilter filter, size_t capacity)
+  : filter_(std::move(filter)), capacity_(std::max<size_t>(1, capacity))
+{
+}
+
+bool HubSubscription::pop(HubMessage& message, std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> l(lock_);
+  if (!ready_.wait_for(l, timeout, [this]() { return closed_ || !queue_.empty(); }) || closed_)
+  {
+    return false;
+  }
+  message = std::move(queue_.front());
+  queue_.pop_front();
+  return true;
+}
+
+bool HubSubscription::tryPop(HubMessage& message)
+{
+  std::lock_guard<std::mutex> l(lock_);
+  if (closed_ || queue_.empty())
+  {
+    return false;
+  }
+  message = std::move(queue_.front());
+  queue_.pop_front();
+  return true;
+}
+
+void HubSubscription::close()
+{
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    closed_ = true;
+    queue_.clear();
+  }
+  ready_.notify_all();
+}
+
+const HubFilter& HubSubscription::filter() const
+{
+  return filter_;
+}
+
+uint64_t HubSubscription::numDropped() const
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return num_dropped_;
+}
+
+void HubSubscription::push(const HubMessage& message)
+{
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    if (closed_)
+    {
+      return;
+    }
+    if (queue_.size() >= capacity_)
+    {
+      queue_.pop_front();
+      num_dropped_++;
+    }
+    queue_.push_back(message);
+  }
+  ready_.notify_one();
+}
+
+MessageHub::MessageHub() : subscriptions_(std::make_shared<const Subscriptions>())
+{
+}
+
+std::shared_ptr<HubSubscription> MessageHub::subscribe(HubFilter filter, size_t capacity)
+{
+  auto subscription = std::make_shared<HubSubscription>(std::move(filter), capacity);
+  std::lock_guard<std::mutex> l(lock_);
+  auto subscriptions = std::make_shared<Subscriptions>(*subscriptions_);
+  subscriptions->push_back(subscription);
+  subscriptions_ = std::move(subscriptions);
+  return subscription;
+}
+
+void MessageHub::unsubscribe(const std::shared_ptr<HubSubscription>& subscription)
+{
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    auto subscriptions = std::make_shared<Subscriptions>(*subscriptions_);
+    std::erase(*subscriptions, subscription);
+    subscriptions_ = std::move(subscriptions);
+  }
+  subscription->close();
+}
+
+void MessageHub::publish(const HubMessage& message) const
+{
+  std::shared_ptr<const Subscriptions> subscriptions;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    subscriptions = subscriptions_;
+  }
+  for (const auto& subscription : *subscriptions)
+  {
+    if (subscription->filter().matches(*message.msg_bin))
+    {
+      subscription->push(message);
+    }
+  }
+}
+
+bool MessageHub::hasSubscribers() const
+{
+  std::lock_guard<std::mutex> l(lock_);
+  return !subscriptions_->empty();
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
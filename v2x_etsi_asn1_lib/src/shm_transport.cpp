@@ -0,0 +1,357 @@
+#include "v2x_etsi_asn1_lib/shm_transport.h"
+#include <aduulm_logger/aduulm_logger.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics in shared memory have to be lock-free");
+
+static constexpr uint64_t shm_magic = 0x56325852494e4703;  // "V2XRING" + layout version
+static constexpr size_t cache_line_size = 64;
+// how often a sender retries to claim a slot which a sender of the previous lap is still writing
+static constexpr int max_claim_attempts = 1000;
+
+struct ShmRingHeader
+{
+  std::atomic<uint64_t> magic;
+  uint64_t num_slots;
+  uint64_t slot_size;
+  uint64_t max_message_size;
+  // Number of messages ever claimed by senders
+  alignas(cache_line_size) std::atomic<uint64_t> write_seq;
+};
+
+// Followed by max_message_size bytes of payload.
+// seq is 2 * (n + 1) once message n has been written completely and 2 * n + 1 while a sender is writing it, so
+// receivers can detect messages that were overwritten while they were reading them. Senders claim a slot by
+// changing seq from even to odd, so that only one of them writes the slot at a time.
+struct ShmSlot
+{
+  std::atomic<uint64_t> seq;
+  uint64_t writer_id;
+  int64_t time;
+  // 0 if the message does not expire
+  int64_t expiry_time;
+  uint32_t message_type;
+  uint32_t station_id;
+  uint32_t destination_station_id;
+  uint32_t has_destination_station_id;
+  uint32_t encoding;
+  uint32_t size;
+};
+
+static constexpr size_t roundUp(size_t size)
+{
+  return (size + cache_line_size - 1) / cache_line_size * cache_line_size;
+}
+
+static constexpr size_t header_size = roundUp(sizeof(ShmRingHeader));
+
+static inline int64_t toNs(std::chrono::system_clock::time_point time)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+static inline std::string shmName(std::string name)
+{
+  return name.starts_with('/') ? name : "/" + name;
+}
+
+static uint64_t newWriterId()
+{
+  static std::atomic<uint32_t> counter = 0;
+  return (static_cast<uint64_t>(getpid()) << 32) | counter++;
+}
+
+std::shared_ptr<ShmTransport> ShmTransport::open(std::string name, size_t num_slots, size_t max_message_size)
+{
+  name = shmName(std::move(name));
+  const size_t slot_size = roundUp(sizeof(ShmSlot) + max_message_size);
+  const size_t size = header_size + num_slots * slot_size;
+  if (num_slots == 0)
+  {
+    LOG_ERR("Shared memory ring " << name << " needs at least one slot");
+    return nullptr;
+  }
+
+  bool created = true;
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+  if (fd < 0 && errno == EEXIST)
+  {
+    created = false;
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+  }
+  if (fd < 0)
+  {
+    LOG_ERR("Could not open shared memory ring " << name << ": " << strerror(errno));
+    return nullptr;
+  }
+
+  if (created)
+  {
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+      LOG_ERR("Could not resize shared memory ring " << name << ": " << strerror(errno));
+      ::close(fd);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+  }
+  else
+  {
+    // the creator might not have resized it yet
+    struct stat st
+    {
+    };
+    for (int i = 0; i < 1000 && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < size; i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (static_cast<size_t>(st.st_size) != size)
+    {
+      LOG_ERR("Shared memory ring " << name << " has a different size (" << st.st_size << " bytes instead of "
+                                    << size << "), check num_slots and max_message_size");
+      ::close(fd);
+      return nullptr;
+    }
+  }
+
+  void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED)
+  {
+    LOG_ERR("Could not map shared memory ring " << name << ": " << strerror(errno));
+    return nullptr;
+  }
+
+  auto* header = static_cast<ShmRingHeader*>(memory);
+  if (created)
+  {
+    // the memory is zero-initialized, the slots are thus valid and empty
+    new (memory) ShmRingHeader{};
+    header->num_slots = num_slots;
+    header->slot_size = slot_size;
+    header->max_message_size = max_message_size;
+    header->magic.store(shm_magic, std::memory_order_release);
+  }
+  else
+  {
+    for (int i = 0; i < 1000 && header->magic.load(std::memory_order_acquire) != shm_magic; i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header->magic.load(std::memory_order_acquire) != shm_magic || header->num_slots != num_slots ||
+        header->max_message_size != max_message_size)
+    {
+      LOG_ERR("Shared memory ring " << name << " has an incompatible layout");
+      munmap(memory, size);
+      return nullptr;
+    }
+  }
+  return std::shared_ptr<ShmTransport>(new ShmTransport(memory, size));
+}
+
+bool ShmTransport::remove(std::string name)
+{
+  return shm_unlink(shmName(std::move(name)).c_str()) == 0;
+}
+
+ShmTransport::ShmTransport(void* memory, size_t mapped_size)
+  : memory_(memory)
+  , mapped_size_(mapped_size)
+  , header_(static_cast<ShmRingHeader*>(memory))
+  , writer_id_(newWriterId())
+  , read_seq_(header_->write_seq.load(std::memory_order_acquire))
+{
+}
+
+ShmTransport::~ShmTransport()
+{
+  munmap(memory_, mapped_size_);
+}
+
+ShmSlot& ShmTransport::slot(uint64_t seq) const
+{
+  auto* base = static_cast<uint8_t*>(memory_) + header_size;
+  return *reinterpret_cast<ShmSlot*>(base + (seq % header_->num_slots) * header_->slot_size);
+}
+
+bool ShmTransport::send(const OutgoingETSIMessage& message)
+{
+  if (message.size > header_->max_message_size)
+  {
+    LOG_WARN_THROTTLE(5.0,
+                      "Message of " << message.size << " bytes does not fit into a shared memory slot of "
+                                    << header_->max_message_size << " bytes");
+    return false;
+  }
+  const uint64_t seq = header_->write_seq.fetch_add(1, std::memory_order_relaxed);
+  auto& s = slot(seq);
+  if (!claim(s, seq))
+  {
+    LOG_WARN_THROTTLE(5.0, "Dropped message, its shared memory slot is taken by another sender");
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  s.writer_id = writer_id_;
+  s.time = toNs(message.time);
+  s.expiry_time = message.ttl.count() > 0 ? s.time + std::chrono::nanoseconds(message.ttl).count() : 0;
+  s.message_type = message.message_type;
+  s.station_id = static_cast<uint32_t>(message.station_id);
+  s.has_destination_station_id = message.destination_station_id.has_value();
+  s.destination_station_id = static_cast<uint32_t>(message.destination_station_id.value_or(0));
+  s.encoding = static_cast<uint32_t>(message.encoding);
+  s.size = static_cast<uint32_t>(message.size);
+  std::memcpy(reinterpret_cast<uint8_t*>(&s) + sizeof(ShmSlot), message.data, message.size);
+
+  s.seq.store(2 * seq + 2, std::memory_order_release);
+  if (message.on_settled)
+  {
+    message.on_settled(true);
+  }
+  return true;
+}
+
+bool ShmTransport::claim(ShmSlot& s, uint64_t seq)
+{
+  const uint64_t claimed = 2 * seq + 1;
+  uint64_t current = s.seq.load(std::memory_order_relaxed);
+  for (int i = 0; i < max_claim_attempts; i++)
+  {
+    if (current >= claimed)
+    {
+      // a sender of a later lap has already taken the slot
+      return false;
+    }
+    if (current % 2 == 0)
+    {
+      if (s.seq.compare_exchange_weak(current, claimed, std::memory_order_relaxed))
+      {
+        return true;
+      }
+      continue;
+    }
+    // a sender of an earlier lap has not finished writing yet
+    std::this_thread::yield();
+    current = s.seq.load(std::memory_order_relaxed);
+  }
+  return false;
+}
+
+bool ShmTransport::skipOverwritten()
+{
+  const uint64_t write_seq = header_->write_seq.load(std::memory_order_acquire);
+  if (write_seq <= read_seq_ + header_->num_slots)
+  {
+    return false;
+  }
+  const uint64_t oldest = write_seq - header_->num_slots;
+  num_lost_ += oldest - read_seq_;
+  read_seq_ = oldest;
+  return true;
+}
+
+bool ShmTransport::tryReceive(BinaryETSIMessage& message)
+{
+  while (true)
+  {
+    auto& s = slot(read_seq_);
+    const uint64_t expected = 2 * read_seq_ + 2;
+    const uint64_t seq_before = s.seq.load(std::memory_order_acquire);
+    if (seq_before < expected)
+    {
+      // not written yet; if a sender stalls, continue once the others have lapped it
+      if (!skipOverwritten())
+      {
+        return false;
+      }
+      continue;
+    }
+    if (seq_before == expected)
+    {
+      const uint64_t writer_id = s.writer_id;
+      const int64_t expiry_time = s.expiry_time;
+      message.message_type = static_cast<ETSIMessageType>(s.message_type);
+      message.station_id = s.station_id;
+      message.destination_station_id.reset();
+      if (s.has_destination_station_id)
+      {
+        message.destination_station_id = s.destination_station_id;
+      }
+      message.encoding = static_cast<WireEncoding>(s.encoding);
+      message.time = std::chrono::system_clock::time_point{ std::chrono::duration_cast<
+          std::chrono::system_clock::duration>(std::chrono::nanoseconds(s.time)) };
+      const size_t size = std::min<size_t>(s.size, header_->max_message_size);
+      const auto* data = reinterpret_cast<const uint8_t*>(&s) + sizeof(ShmSlot);
+      message.data.assign(data, data + size);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) == seq_before)
+      {
+        read_seq_++;
+        if (writer_id == writer_id_ ||
+            (expiry_time != 0 && toNs(std::chrono::system_clock::now()) > expiry_time))
+        {
+          continue;
+        }
+        return true;
+      }
+    }
+    // overwritten before or while reading it
+    if (!skipOverwritten())
+    {
+      read_seq_++;
+      num_lost_++;
+    }
+  }
+}
+
+bool ShmTransport::receive(ETSIMessageSink& sink)
+{
+  BinaryETSIMessage message;
+  for (int i = 0; !closed_; i++)
+  {
+    if (tryReceive(message))
+    {
+      sink.deliver(message);
+      return true;
+    }
+    // keep the latency low while messages are coming in, without burning a core when idle
+    if (i < 100)
+    {
+      std::this_thread::yield();
+    }
+    else
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  return false;
+}
+
+bool ShmTransport::is_sender_connected()
+{
+  return !closed_;
+}
+
+void ShmTransport::close()
+{
+  closed_ = true;
+}
+
+uint64_t ShmTransport::numLost() const
+{
+  return num_lost_;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,265 @@
+#include "v2x_etsi_asn1_lib/spatial_index.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+static constexpr double earth_radius = 6'371'000.0;
+
+LocalProjection::LocalProjection(double origin_latitude, double origin_longitude)
+  : origin_latitude_(origin_latitude)
+  , origin_longitude_(origin_longitude)
+  , meters_per_deg_lat_(earth_radius * M_PI / 180.)
+  , meters_per_deg_lon_(earth_radius * M_PI / 180. * std::cos(origin_latitude * M_PI / 180.))
+{
+}
+
+LocalPoint LocalProjection::toLocal(double latitude, double longitude) const
+{
+  return { (longitude - origin_longitude_) * meters_per_deg_lon_, (latitude - origin_latitude_) * meters_per_deg_lat_ };
+}
+
+SpatialIndex::SpatialIndex(double origin_latitude,
+                           double origin_longitude,
+                           double cell_size,
+                           std::chrono::nanoseconds max_age)
+  : projection_(origin_latitude, origin_longitude)
+  , cell_size_(cell_size)
+  , max_age_(std::chrono::duration_cast<Clock::duration>(max_age))
+{
+}
+
+LocalPoint SpatialIndex::toLocal(double latitude, double longitude) const
+{
+  return projection_.toLocal(latitude, longitude);
+}
+
+uint64_t SpatialIndex::entityKey(SpatialEntity::Kind kind, uint32_t station_id, uint16_t object_id)
+{
+  return (static_cast<uint64_t>(kind) << 48) | (static_cast<uint64_t>(object_id) << 32) | station_id;
+}
+
+int64_t SpatialIndex::cellCoord(double v) const
+{
+  return static_cast<int64_t>(std::floor(v / cell_size_));
+}
+
+int64_t SpatialIndex::cellKey(int64_t cx, int64_t cy) const
+{
+  return static_cast<int64_t>((static_cast<uint64_t>(cx) << 32) | (static_cast<uint64_t>(cy) & 0xFFFFFFFFULL));
+}
+
+void SpatialIndex::removeFromCell(int64_t cell, uint32_t idx)
+{
+  auto it = cells_.find(cell);
+  if (it == cells_.end())
+  {
+    return;
+  }
+  auto& members = it->second;
+  auto pos = std::find(members.begin(), members.end(), idx);
+  if (pos != members.end())
+  {
+    *pos = members.back();
+    members.pop_back();
+  }
+  if (members.empty())
+  {
+    cells_.erase(it);
+  }
+}
+
+void SpatialIndex::updateLocked(const SpatialEntity& entity)
+{
+  const auto key = entityKey(entity.kind, entity.station_id, entity.object_id);
+  const auto cell = cellKey(cellCoord(entity.position.x), cellCoord(entity.position.y));
+  auto it = entry_index_.find(key);
+  if (it != entry_index_.end())
+  {
+    auto& entry = entries_[it->second];
+    if (entry.cell != cell)
+    {
+      removeFromCell(entry.cell, it->second);
+      cells_[cell].push_back(it->second);
+      entry.cell = cell;
+    }
+    entry.entity = entity;
+    return;
+  }
+
+  uint32_t idx;
+  if (!free_entries_.empty())
+  {
+    idx = free_entries_.back();
+    free_entries_.pop_back();
+  }
+  else
+  {
+    idx = static_cast<uint32_t>(entries_.size());
+    entries_.emplace_back();
+  }
+  entries_[idx] = { entity, cell, true };
+  entry_index_[key] = idx;
+  cells_[cell].push_back(idx);
+}
+
+void SpatialIndex::expireLocked(Clock::time_point now)
+{
+  // expiring is amortized: queries filter out stale entries anyway
+  if (now - last_expiry_ < max_age_ / 4)
+  {
+    return;
+  }
+  last_expiry_ = now;
+  for (uint32_t idx = 0; idx < entries_.size(); idx++)
+  {
+    auto& entry = entries_[idx];
+    if (entry.used && now - entry.entity.update_time > max_age_)
+    {
+      removeFromCell(entry.cell, idx);
+      entry_index_.erase(entityKey(entry.entity.kind, entry.entity.station_id, entry.entity.object_id));
+      entry.used = false;
+      free_entries_.push_back(idx);
+    }
+  }
+}
+
+void SpatialIndex::updateStation(uint32_t station_id, LocalPoint position, Clock::time_point now)
+{
+  std::unique_lock<std::shared_mutex> l(lock_);
+  updateLocked({ SpatialEntity::Kind::Station, station_id, 0, position, now });
+  expireLocked(now);
+}
+
+void SpatialIndex::updateObject(uint32_t station_id, uint16_t object_id, LocalPoint position, Clock::time_point now)
+{
+  std::unique_lock<std::shared_mutex> l(lock_);
+  updateLocked({ SpatialEntity::Kind::PerceivedObject, station_id, object_id, position, now });
+  expireLocked(now);
+}
+
+void SpatialIndex::update(const std::vector<SpatialEntity>& entities)
+{
+  if (entities.empty())
+  {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> l(lock_);
+  for (const auto& entity : entities)
+  {
+    updateLocked(entity);
+  }
+  expireLocked(entities.back().update_time);
+}
+
+void SpatialIndex::expire(Clock::time_point now)
+{
+  std::unique_lock<std::shared_mutex> l(lock_);
+  last_expiry_ = {};
+  expireLocked(now);
+}
+
+size_t SpatialIndex::size() const
+{
+  std::shared_lock<std::shared_mutex> l(lock_);
+  return entry_index_.size();
+}
+
+template <class Predicate>
+std::vector<SpatialEntity> SpatialIndex::queryBox(LocalPoint min,
+                                                  LocalPoint max,
+                                                  Clock::time_point now,
+                                                  Predicate pred) const
+{
+  std::vector<SpatialEntity> result;
+  const auto cx_min = cellCoord(min.x);
+  const auto cx_max = cellCoord(max.x);
+  const auto cy_min = cellCoord(min.y);
+  const auto cy_max = cellCoord(max.y);
+
+  std::shared_lock<std::shared_mutex> l(lock_);
+  auto visit = [&](const std::vector<uint32_t>& members) {
+    for (auto idx : members)
+    {
+      const auto& entity = entries_[idx].entity;
+      if (now - entity.update_time <= max_age_ && pred(entity.position))
+      {
+        result.push_back(entity);
+      }
+    }
+  };
+  const auto num_box_cells = static_cast<double>(cx_max - cx_min + 1) * static_cast<double>(cy_max - cy_min + 1);
+  if (num_box_cells <= static_cast<double>(cells_.size()))
+  {
+    for (auto cx = cx_min; cx <= cx_max; cx++)
+    {
+      for (auto cy = cy_min; cy <= cy_max; cy++)
+      {
+        auto it = cells_.find(cellKey(cx, cy));
+        if (it != cells_.end())
+        {
+          visit(it->second);
+        }
+      }
+    }
+  }
+  else
+  {
+    // large query area: visiting the occupied cells is cheaper
+    for (const auto& [cell, members] : cells_)
+    {
+      const auto cx = cell >> 32;
+      const auto cy = static_cast<int64_t>(static_cast<int32_t>(cell & 0xFFFFFFFFLL));
+      if (cx >= cx_min && cx <= cx_max && cy >= cy_min && cy <= cy_max)
+      {
+        visit(members);
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<SpatialEntity> SpatialIndex::queryRadius(LocalPoint center, double radius, Clock::time_point now) const
+{
+  const double r2 = radius * radius;
+  return queryBox({ center.x - radius, center.y - radius },
+                  { center.x + radius, center.y + radius },
+                  now,
+                  [&](const LocalPoint& p) {
+                    const double dx = p.x - center.x;
+                    const double dy = p.y - center.y;
+                    return dx * dx + dy * dy <= r2;
+                  });
+}
+
+std::vector<SpatialEntity> SpatialIndex::queryPolygon(const std::vector<LocalPoint>& polygon,
+                                                      Clock::time_point now) const
+{
+  if (polygon.size() < 3)
+  {
+    return {};
+  }
+  LocalPoint min = polygon.front();
+  LocalPoint max = polygon.front();
+  for (const auto& p : polygon)
+  {
+    min = { std::min(min.x, p.x), std::min(min.y, p.y) };
+    max = { std::max(max.x, p.x), std::max(max.y, p.y) };
+  }
+  return queryBox(min, max, now, [&](const LocalPoint& p) {
+    // even-odd rule
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+    {
+      const auto& a = polygon[i];
+      const auto& b = polygon[j];
+      if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+      {
+        inside = !inside;
+      }
+    }
+    return inside;
+  });
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
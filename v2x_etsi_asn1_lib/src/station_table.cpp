@@ -0,0 +1,252 @@
+#include "v2x_etsi_asn1_lib/station_table.h"
+#include "v2x_etsi_asn1_lib/time_conversions.h"
+#include "v2x_etsi_asn1_lib/units.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+static_assert(std::is_trivially_copyable_v<StationState>);
+
+static constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+static inline double decodeOptional(long value, long unavailable, double unit)
+{
+  return value == unavailable ? nan : static_cast<double>(value) * unit;
+}
+
+template <class Position>
+static inline void decodeReferencePosition(const Position& pos, StationState& state)
+{
+  state.latitude = decodeOptional(pos.latitude, Latitude_unavailable, LatitudeUnit_degree);
+  state.longitude = decodeOptional(pos.longitude, Longitude_unavailable, LongitudeUnit_degree);
+  state.altitude = decodeOptional(pos.altitude.altitudeValue, AltitudeValue_unavailable, AltitudeValueUnit_metre);
+}
+
+StationState stationStateFromCAM(const CAM& msg, uint64_t now_unix_time)
+{
+  StationState state;
+  state.station_id = msg.header.stationId;
+  state.message_type = ETSIMessageType::CAM;
+  state.time = GenerationDeltaTime2UnixTime(msg.cam.generationDeltaTime, now_unix_time);
+  const auto& basic = msg.cam.camParameters.basicContainer;
+  state.station_type = static_cast<int32_t>(basic.stationType);
+  decodeReferencePosition(basic.referencePosition, state);
+  const auto& hf_container = msg.cam.camParameters.highFrequencyContainer;
+  if (hf_container.present == HighFrequencyContainer_PR_basicVehicleContainerHighFrequency)
+  {
+    const auto& hf = hf_container.choice.basicVehicleContainerHighFrequency;
+    state.heading = decodeOptional(hf.heading.headingValue, HeadingValue_unavailable, HeadingValueUnit_degree);
+    state.speed = decodeOptional(hf.speed.speedValue, SpeedValue_unavailable, SpeedValueUnit_m_s);
+    state.yaw_rate =
+        decodeOptional(hf.yawRate.yawRateValue, YawRateValue_unavailable, YawRateValueUnit_degree_per_second_);
+    state.longitudinal_acceleration = decodeOptional(
+        hf.longitudinalAcceleration.value, AccelerationValue_unavailable, AccelerationValueUnit_m_s_2);
+    state.length = decodeOptional(
+        hf.vehicleLength.vehicleLengthValue, VehicleLengthValue_unavailable, VehicleLengthValueUnit_metre);
+    state.width = decodeOptional(hf.vehicleWidth, VehicleWidth_unavailable, VehicleWidthUnit_metre);
+  }
+  else
+  {
+    state.heading = state.speed = state.yaw_rate = state.longitudinal_acceleration = nan;
+    state.length = state.width = nan;
+  }
+  return state;
+}
+
+StationState stationStateFromVAM(const VAM& msg, uint64_t now_unix_time)
+{
+  StationState state;
+  state.station_id = msg.header.stationId;
+  state.message_type = ETSIMessageType::VAM;
+  state.time = GenerationDeltaTime2UnixTime(msg.vam.generationDeltaTime, now_unix_time);
+  const auto& basic = msg.vam.vamParameters.basicContainer;
+  state.station_type = static_cast<int32_t>(basic.stationType);
+  decodeReferencePosition(basic.referencePosition, state);
+  const auto& hf = msg.vam.vamParameters.vruHighFrequencyContainer;
+  state.heading = decodeOptional(hf.heading.value, Wgs84AngleValue_unavailable, Wgs84AngleValueUnit_degrees);
+  state.speed = decodeOptional(hf.speed.speedValue, SpeedValue_unavailable, SpeedValueUnit_m_s);
+  state.yaw_rate = hf.yawRate != nullptr ? decodeOptional(hf.yawRate->yawRateValue,
+                                                          YawRateValue_unavailable,
+                                                          YawRateValueUnit_degree_per_second_) :
+                                           nan;
+  state.longitudinal_acceleration = decodeOptional(hf.longitudinalAcceleration.longitudinalAccelerationValue,
+                                                   LongitudinalAccelerationValue_unavailable,
+                                                   LongitudinalAccelerationValueUnit_m_s_2);
+  state.length = state.width = nan;
+  return state;
+}
+
+StationState stationStateFromMCM(const MCM& msg, uint64_t now_unix_time)
+{
+  StationState state;
+  state.station_id = msg.header.stationId;
+  state.message_type = ETSIMessageType::MCM;
+  state.time = GenerationDeltaTime2UnixTime(msg.mcm.generationDeltaTime, now_unix_time);
+  const auto& basic = msg.mcm.mcmParameters.basicContainer;
+  state.station_type = static_cast<int32_t>(basic.stationType);
+  decodeReferencePosition(basic.referencePosition, state);
+  const auto& container = msg.mcm.mcmParameters.maneuverContainer;
+  if (container.present == ManeuverContainer_PR_roadUserContainer)
+  {
+    const auto& road_user = container.choice.roadUserContainer.roadUserState;
+    state.heading = decodeOptional(road_user.heading, HeadingValue_unavailable, HeadingValueUnit_degree);
+    state.speed = decodeOptional(road_user.speed, SpeedValue_unavailable, SpeedValueUnit_m_s);
+    // length and width are given in units of 10 cm
+    state.length = decodeOptional(road_user.length, RoadUserLength_unavailable, 0.1);
+    state.width = decodeOptional(road_user.width, RoadUserWidth_unavailable, 0.1);
+  }
+  else
+  {
+    state.heading = state.speed = state.length = state.width = nan;
+  }
+  state.yaw_rate = state.longitudinal_acceleration = nan;
+  return state;
+}
+
+StationTable::StationTable(size_t num_stations, std::chrono::nanoseconds max_age)
+  : mask_(std::bit_ceil(std::max<size_t>(num_stations, 1) * 2) - 1)
+  , max_age_ns_(max_age.count())
+  , slots_(std::make_unique<Slot[]>(mask_ + 1))
+{
+}
+
+size_t StationTable::capacity() const
+{
+  return mask_ + 1;
+}
+
+static inline size_t hashStationId(uint64_t key)
+{
+  key *= 0x9E3779B97F4A7C15ULL;
+  return key ^ (key >> 32);
+}
+
+bool StationTable::isExpired(const Slot& slot, Clock::time_point now) const
+{
+  const auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  return now_ns - slot.update_time.load(std::memory_order_relaxed) > max_age_ns_;
+}
+
+void StationTable::write(Slot& slot, uint64_t key, const StationState& state, Clock::time_point now)
+{
+  std::array<uint64_t, num_words> words{};
+  std::memcpy(words.data(), &state, sizeof(state));
+
+  const auto seq = slot.seq.load(std::memory_order_relaxed);
+  slot.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.key.store(key, std::memory_order_relaxed);
+  slot.update_time.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count(),
+                         std::memory_order_relaxed);
+  for (size_t i = 0; i < num_words; i++)
+  {
+    slot.data[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+bool StationTable::read(const Slot& slot, uint64_t key, StationState& state) const
+{
+  std::array<uint64_t, num_words> words{};
+  while (true)
+  {
+    const auto seq = slot.seq.load(std::memory_order_acquire);
+    if ((seq & 1U) != 0)
+    {
+      continue;
+    }
+    if (slot.key.load(std::memory_order_relaxed) != key)
+    {
+      return false;
+    }
+    for (size_t i = 0; i < num_words; i++)
+    {
+      words[i] = slot.data[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == seq)
+    {
+      break;
+    }
+  }
+  std::memcpy(static_cast<void*>(&state), words.data(), sizeof(state));
+  return true;
+}
+
+bool StationTable::update(const StationState& state, Clock::time_point now)
+{
+  const uint64_t key = static_cast<uint64_t>(state.station_id) + 1;
+  Slot* reusable = nullptr;
+  size_t idx = hashStationId(key) & mask_;
+  for (size_t probes = 0; probes <= mask_; probes++, idx = (idx + 1) & mask_)
+  {
+    auto& slot = slots_[idx];
+    const auto slot_key = slot.key.load(std::memory_order_relaxed);
+    if (slot_key == key)
+    {
+      write(slot, key, state, now);
+      return true;
+    }
+    if (slot_key == 0)
+    {
+      write(reusable != nullptr ? *reusable : slot, key, state, now);
+      return true;
+    }
+    if (reusable == nullptr && isExpired(slot, now))
+    {
+      reusable = &slot;
+    }
+  }
+  if (reusable != nullptr)
+  {
+    write(*reusable, key, state, now);
+    return true;
+  }
+  return false;
+}
+
+std::optional<StationState> StationTable::get(uint32_t station_id, Clock::time_point now) const
+{
+  const uint64_t key = static_cast<uint64_t>(station_id) + 1;
+  size_t idx = hashStationId(key) & mask_;
+  for (size_t probes = 0; probes <= mask_; probes++, idx = (idx + 1) & mask_)
+  {
+    const auto& slot = slots_[idx];
+    const auto slot_key = slot.key.load(std::memory_order_acquire);
+    if (slot_key == 0)
+    {
+      return {};
+    }
+    StationState state;
+    if (slot_key == key && read(slot, key, state))
+    {
+      if (isExpired(slot, now))
+      {
+        return {};
+      }
+      return state;
+    }
+  }
+  return {};
+}
+
+std::vector<StationState> StationTable::snapshot(Clock::time_point now) const
+{
+  std::vector<StationState> states;
+  for (size_t idx = 0; idx <= mask_; idx++)
+  {
+    const auto& slot = slots_[idx];
+    const auto key = slot.key.load(std::memory_order_acquire);
+    StationState state;
+    if (key != 0 && !isExpired(slot, now) && read(slot, key, state))
+    {
+      states.push_back(state);
+    }
+  }
+  return states;
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,118 @@
+#include "v2x_etsi_asn1_lib/transport.h"
+#include "v2x_etsi_asn1_lib/encoding.h"
+
+#include <string>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+proton::message makeProtonMessage(const OutgoingETSIMessage& message)
+{
+  proton::message ret;
+  ret.body() = proton::binary(std::string(reinterpret_cast<const char*>(message.data), message.size));
+  ret.ttl(proton::duration(message.ttl.count()));
+  ret.subject(std::string(message.subject));
+
+  const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(message.time.time_since_epoch()).count();
+  ret.creation_time(proton::timestamp(now));
+
+  ret.properties().put("mid", (uint16_t)message.message_type);
+  ret.properties().put("station_id", static_cast<uint32_t>(message.station_id));
+  if (message.destination_station_id)
+  {
+    ret.properties().put("destination_station_id", static_cast<uint32_t>(*message.destination_station_id));
+  }
+  // UPER is assumed if missing, so that older receivers understand the message
+  if (message.encoding != WireEncoding::UPER)
+  {
+    ret.properties().put("enc", std::string(toString(message.encoding)));
+  }
+  for (const auto& [key, value] : message.properties)
+  {
+    ret.properties().put(key, value);
+  }
+  return ret;
+}
+
+AMQPTransport::AMQPTransport(std::unique_ptr<mrm::v2x_amqp_connector_lib::AMQPClient> client,
+                             mrm::v2x_amqp_connector_lib::LaneScheduling scheduling,
+                             std::vector<uint32_t> weights)
+  : client_(std::move(client))
+{
+  client_->set_send_lanes(num_send_priorities, scheduling, std::move(weights));
+}
+
+bool AMQPTransport::send(const OutgoingETSIMessage& message)
+{
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  if (message.ttl.count() > 0)
+  {
+    deadline = std::chrono::steady_clock::now() + message.ttl;
+  }
+  return is_sender_connected() &&
+         client_->send(
+             makeProtonMessage(message), static_cast<size_t>(message.priority), deadline, message.on_settled);
+}
+
+size_t AMQPTransport::sendBatch(const std::vector<OutgoingETSIMessage>& messages)
+{
+  if (!is_sender_connected())
+  {
+    return 0;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<mrm::v2x_amqp_connector_lib::AMQPClient::OutgoingMessage> msgs;
+  msgs.reserve(messages.size());
+  for (const auto& message : messages)
+  {
+    auto& msg = msgs.emplace_back();
+    msg.msg = makeProtonMessage(message);
+    msg.lane = static_cast<size_t>(message.priority);
+    if (message.ttl.count() > 0)
+    {
+      msg.deadline = now + message.ttl;
+    }
+    msg.on_settled = message.on_settled;
+  }
+  return client_->send(std::move(msgs));
+}
+
+bool AMQPTransport::receive(ETSIMessageSink& sink)
+{
+  auto msg = client_->receive();
+  if (!msg)
+  {
+    if (client_->is_closing())
+    {
+      return false;
+    }
+    // wait for reconnection
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(200ms);
+    return true;
+  }
+  sink.deliver(*msg);
+  return true;
+}
+
+bool AMQPTransport::is_sender_connected()
+{
+  return client_->is_sender_connected();
+}
+
+void AMQPTransport::close()
+{
+  client_->close();
+}
+
+bool AMQPTransport::setFilter(const std::string& filter_query)
+{
+  client_->set_filter_query(filter_query);
+  return true;
+}
+
+std::vector<mrm::v2x_amqp_connector_lib::SendLaneStats> AMQPTransport::sendLaneStats()
+{
+  return client_->send_lane_stats();
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
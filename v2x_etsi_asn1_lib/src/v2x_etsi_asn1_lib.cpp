@@ -1,12 +1,102 @@
 #include "v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h"
 #include <v2x_amqp_connector_lib/v2x_amqp_connector_lib.h>
+#include "v2x_etsi_asn1_lib/encoding.h"
 #include "v2x_etsi_asn1_lib/time_conversions.h"
+#include "v2x_etsi_asn1_lib/units.h"
+#include <algorithm>
 #include <chrono>
+#include <utility>
 #include <vector>
 
 namespace mrm::v2x_etsi_asn1_lib
 {
 
+static inline uint64_t unixNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+template <class Position>
+static inline bool positionAvailable(const Position& pos)
+{
+  return pos.latitude != Latitude_unavailable && pos.longitude != Longitude_unavailable;
+}
+
+template <class Position>
+static inline LocalPoint toLocal(const SpatialIndex& index, const Position& pos)
+{
+  return index.toLocal(static_cast<double>(pos.latitude) * LatitudeUnit_degree,
+                       static_cast<double>(pos.longitude) * LongitudeUnit_degree);
+}
+
+template <class Position>
+static inline std::optional<GeoPosition> toGeoPosition(const Position& pos)
+{
+  if (!positionAvailable(pos))
+  {
+    return {};
+  }
+  return GeoPosition{ static_cast<double>(pos.latitude) * LatitudeUnit_degree,
+                      static_cast<double>(pos.longitude) * LongitudeUnit_degree };
+}
+
+static std::optional<GeoPosition> referencePosition(ETSIMessageType message_type, const void* msg)
+{
+  switch (message_type)
+  {
+    case ETSIMessageType::CAM:
+      return toGeoPosition(static_cast<const CAM*>(msg)->cam.camParameters.basicContainer.referencePosition);
+    case ETSIMessageType::VAM:
+      return toGeoPosition(static_cast<const VAM*>(msg)->vam.vamParameters.basicContainer.referencePosition);
+    case ETSIMessageType::CPM:
+      return toGeoPosition(
+          static_cast<const CollectivePerceptionMessage*>(msg)->payload.managementContainer.referencePosition);
+    default:
+      return {};
+  }
+}
+
+static void updateSpatialIndex(SpatialIndex& index, const CollectivePerceptionMessage& msg)
+{
+  const auto& ref_pos = msg.payload.managementContainer.referencePosition;
+  if (!positionAvailable(ref_pos))
+  {
+    return;
+  }
+  // object positions are given relative to the reference position (x pointing east, y pointing north)
+  const auto ref = toLocal(index, ref_pos);
+  const auto now = SpatialIndex::Clock::now();
+  std::vector<SpatialEntity> entities;
+  const auto& containers = msg.payload.cpmContainers.list;
+  for (int i = 0; i < containers.count; i++)
+  {
+    const auto& container = containers.array[i]->containerData;
+    if (container.present != WrappedCpmContainer__containerData_PR_PerceivedObjectContainer)
+    {
+      continue;
+    }
+    const auto& objects = container.choice.PerceivedObjectContainer.perceivedObjects.list;
+    for (int j = 0; j < objects.count; j++)
+    {
+      const auto& obj = *objects.array[j];
+      if (obj.objectId == nullptr)
+      {
+        continue;
+      }
+      // CartesianCoordinateWithConfidence holds a CartesianCoordinateLarge
+      const double x = ref.x + static_cast<double>(obj.position.xCoordinate.value) * CartesianCoordinateLargeUnit_m;
+      const double y = ref.y + static_cast<double>(obj.position.yCoordinate.value) * CartesianCoordinateLargeUnit_m;
+      entities.push_back({ SpatialEntity::Kind::PerceivedObject,
+                           static_cast<uint32_t>(msg.header.stationId),
+                           static_cast<uint16_t>(*obj.objectId),
+                           { x, y },
+                           now });
+    }
+  }
+  index.update(entities);
+}
+
 const std::map<ETSIMessageType, std::string> ETSIAMQPTransceiverBase::type2str = {
   { ETSIMessageType::DENM, "denm" }, { ETSIMessageType::CPM, "cpm" }, { ETSIMessageType::CAM, "cam" },
   { ETSIMessageType::VAM, "vam" },   { ETSIMessageType::MCM, "mcm" },
@@ -14,28 +104,107 @@ const std::map<ETSIMessageType, std::string> ETSIAMQPTransceiverBase::type2str =
 
 ETSIAMQPTransceiverBase::ETSIAMQPTransceiverBase()
 {
-  etsi_msg_handlers_ = {
-    { ETSIMessageType::CAM,
-      { &asn_DEF_CAM,
-        [this](auto& msg, const BinaryETSIMessage& msg_bin) {
-          handleCAM(std::static_pointer_cast<CAM>(msg), msg_bin);
-        } } },
-    { ETSIMessageType::VAM,
-      { &asn_DEF_VAM,
-        [this](auto& msg, const BinaryETSIMessage& msg_bin) {
-          handleVAM(std::static_pointer_cast<VAM>(msg), msg_bin);
-        } } },
-    { ETSIMessageType::CPM,
-      { &asn_DEF_CollectivePerceptionMessage,
-        [this](auto& msg, const BinaryETSIMessage& msg_bin) {
-          handleCPM(std::static_pointer_cast<CollectivePerceptionMessage>(msg), msg_bin);
-        } } },
-    { ETSIMessageType::MCM,
-      { &asn_DEF_MCM,
-        [this](auto& msg, const BinaryETSIMessage& msg_bin) {
-          handleMCM(std::static_pointer_cast<MCM>(msg), msg_bin);
-        } } },
-  };
+  for (const auto& [message_type, subject] : type2str)
+  {
+    etsi_msg_handlers_[message_type - ETSIMessageType::DENM].subject = subject;
+    etsi_msg_handlers_[message_type - ETSIMessageType::DENM].limits = defaultDecodeLimits(message_type);
+  }
+  etsi_msg_handlers_[ETSIMessageType::DENM - ETSIMessageType::DENM].priority = SendPriority::High;
+  etsi_msg_handlers_[ETSIMessageType::CPM - ETSIMessageType::DENM].priority = SendPriority::Low;
+  registerHandler<CAM>(
+      asn_DEF_CAM,
+      ETSIMessageType::CAM,
+      [this](const std::shared_ptr<const CAM>& cam, const BinaryETSIMessage& msg_bin) {
+        if (station_table_)
+        {
+          station_table_->update(stationStateFromCAM(*cam, unixNow()));
+        }
+        const auto& pos = cam->cam.camParameters.basicContainer.referencePosition;
+        if (spatial_index_ && positionAvailable(pos))
+        {
+          spatial_index_->updateStation(cam->header.stationId, toLocal(*spatial_index_, pos));
+        }
+        handleCAM(cam, msg_bin);
+      });
+  registerHandler<VAM>(
+      asn_DEF_VAM,
+      ETSIMessageType::VAM,
+      [this](const std::shared_ptr<const VAM>& vam, const BinaryETSIMessage& msg_bin) {
+        if (station_table_)
+        {
+          station_table_->update(stationStateFromVAM(*vam, unixNow()));
+        }
+        const auto& pos = vam->vam.vamParameters.basicContainer.referencePosition;
+        if (spatial_index_ && positionAvailable(pos))
+        {
+          spatial_index_->updateStation(vam->header.stationId, toLocal(*spatial_index_, pos));
+        }
+        handleVAM(vam, msg_bin);
+      });
+  registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage,
+      ETSIMessageType::CPM,
+      [this](const std::shared_ptr<const CollectivePerceptionMessage>& cpm, const BinaryETSIMessage& msg_bin) {
+        if (spatial_index_)
+        {
+          updateSpatialIndex(*spatial_index_, *cpm);
+        }
+        handleCPM(cpm, msg_bin);
+      });
+  registerHandler<MCM>(
+      asn_DEF_MCM,
+      ETSIMessageType::MCM,
+      [this](const std::shared_ptr<const MCM>& mcm, const BinaryETSIMessage& msg_bin) {
+        if (station_table_)
+        {
+          station_table_->update(stationStateFromMCM(*mcm, unixNow()));
+        }
+        handleMCM(mcm, msg_bin);
+      });
+}
+
+const ETSIMessageHandler* ETSIAMQPTransceiverBase::findHandler(ETSIMessageType message_type) const
+{
+  const auto idx = static_cast<uint32_t>(message_type) - static_cast<uint32_t>(ETSIMessageType::DENM);
+  if (idx < num_dense_handlers)
+  {
+    return &etsi_msg_handlers_[idx];
+  }
+  auto it = sparse_msg_handlers_.find(message_type);
+  return it != sparse_msg_handlers_.end() ? &it->second : nullptr;
+}
+
+ETSIMessageHandler* ETSIAMQPTransceiverBase::findHandler(ETSIMessageType message_type)
+{
+  return const_cast<ETSIMessageHandler*>(std::as_const(*this).findHandler(message_type));
+}
+
+bool ETSIAMQPTransceiverBase::setHandler(ETSIMessageType message_type, ETSIMessageHandler handler)
+{
+  assert(transport_ == nullptr);
+  const auto* existing = findHandler(message_type);
+  if (handler.subject.empty())
+  {
+    if (existing == nullptr || existing->subject.empty())
+    {
+      LOG_ERR("Cannot register a handler for message type " << static_cast<uint32_t>(message_type)
+                                                            << " without a subject");
+      return false;
+    }
+    handler.subject = existing->subject;
+  }
+  handler.limits = existing != nullptr ? existing->limits : defaultDecodeLimits(message_type);
+  handler.priority = existing != nullptr ? existing->priority : SendPriority::Normal;
+  const auto idx = static_cast<uint32_t>(message_type) - static_cast<uint32_t>(ETSIMessageType::DENM);
+  if (idx < num_dense_handlers)
+  {
+    etsi_msg_handlers_[idx] = std::move(handler);
+  }
+  else
+  {
+    sparse_msg_handlers_[message_type] = std::move(handler);
+  }
+  return true;
 }
 
 ETSIAMQPTransceiverBase::~ETSIAMQPTransceiverBase()
@@ -49,40 +218,175 @@ void ETSIAMQPTransceiverBase::connect(StationId_t station_id,
                                       std::string address_tx,
                                       std::string user,
                                       std::string pw,
-                                      std::string filter_query)
+                                      std::string filter_query,
+                                      uint32_t credit_window,
+                                      bool adaptive_credit)
+{
+  assert(transport_ == nullptr);
+  connect(station_id,
+          std::make_shared<AMQPTransport>(
+              std::make_unique<mrm::v2x_amqp_connector_lib::AMQPClient>(
+                  url, address_rx, address_tx, user, pw, filter_query, credit_window, adaptive_credit),
+              send_scheduling_,
+              send_weights_));
+}
+
+void ETSIAMQPTransceiverBase::connect(StationId_t station_id, std::shared_ptr<ETSITransport> transport)
 {
-  assert(client_ == nullptr);
+  assert(transport_ == nullptr);
   station_id_ = station_id;
-  client_ =
-      std::make_shared<mrm::v2x_amqp_connector_lib::AMQPClient>(url, address_rx, address_tx, user, pw, filter_query);
-  receiver_thread_ = std::make_shared<std::thread>([&]() -> void {
-    while (true)
+  transport_ = std::move(transport);
+  receiver_thread_ = std::make_shared<std::thread>([this]() -> void {
+    while (transport_->receive(*this))
     {
-      auto msg = client_->receive();
-      if (!msg)
-      {
-        if (client_->is_closing())
-        {
-          break;
-        }
-        // wait for reconnection
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(200ms);
-        continue;
-      }
-      handleMessage(*msg);
     }
   });
 }
 
 void ETSIAMQPTransceiverBase::disconnect()
 {
-  if (client_)
+  if (transport_)
   {
-    client_.reset();
+    transport_->close();
     receiver_thread_->join();
     receiver_thread_.reset();
+    transport_.reset();
+  }
+}
+
+void ETSIAMQPTransceiverBase::deliver(const proton::message& message)
+{
+  handleMessage(message);
+}
+
+void ETSIAMQPTransceiverBase::deliver(const BinaryETSIMessage& message)
+{
+  handleBinaryMessage(message);
+}
+
+void ETSIAMQPTransceiverBase::enableDuplicateSuppression(std::chrono::milliseconds window, size_t capacity)
+{
+  assert(transport_ == nullptr);
+  duplicate_filter_ = std::make_unique<DuplicateFilter>(window, capacity);
+}
+
+uint64_t ETSIAMQPTransceiverBase::numSuppressedDuplicates() const
+{
+  return duplicate_filter_ ? duplicate_filter_->numDuplicates() : 0;
+}
+
+void ETSIAMQPTransceiverBase::enableStationTable(size_t num_stations, std::chrono::milliseconds max_age)
+{
+  assert(transport_ == nullptr);
+  station_table_ = std::make_shared<StationTable>(num_stations, max_age);
+}
+
+std::shared_ptr<const StationTable> ETSIAMQPTransceiverBase::stationTable() const
+{
+  return station_table_;
+}
+
+std::shared_ptr<MessageHub> ETSIAMQPTransceiverBase::enableMessageHub()
+{
+  assert(transport_ == nullptr);
+  if (!message_hub_)
+  {
+    message_hub_ = std::make_shared<MessageHub>();
+  }
+  return message_hub_;
+}
+
+void ETSIAMQPTransceiverBase::enableSpatialIndex(double origin_latitude,
+                                                 double origin_longitude,
+                                                 double cell_size,
+                                                 std::chrono::milliseconds max_age)
+{
+  assert(transport_ == nullptr);
+  spatial_index_ = std::make_shared<SpatialIndex>(origin_latitude, origin_longitude, cell_size, max_age);
+}
+
+std::shared_ptr<const SpatialIndex> ETSIAMQPTransceiverBase::spatialIndex() const
+{
+  return spatial_index_;
+}
+
+void ETSIAMQPTransceiverBase::enableSelectiveCPMDecoding(uint32_t container_mask)
+{
+  assert(transport_ == nullptr);
+  cpm_container_mask_ = container_mask;
+}
+
+bool ETSIAMQPTransceiverBase::setDecodeLimits(ETSIMessageType message_type, const DecodeLimits& limits)
+{
+  assert(transport_ == nullptr);
+  auto* handler = findHandler(message_type);
+  if (handler == nullptr || handler->subject.empty())
+  {
+    LOG_ERR("Cannot set decode limits of unknown message type " << static_cast<uint32_t>(message_type));
+    return false;
+  }
+  handler->limits = limits;
+  return true;
+}
+
+uint64_t ETSIAMQPTransceiverBase::numRejectedMessages() const
+{
+  return num_rejected_messages_;
+}
+
+void ETSIAMQPTransceiverBase::setWireEncoding(WireEncoding encoding)
+{
+  encoding_ = encoding;
+}
+
+WireEncoding ETSIAMQPTransceiverBase::wireEncoding() const
+{
+  return encoding_;
+}
+
+void ETSIAMQPTransceiverBase::enableGeoTileProperties(std::vector<unsigned> zoom_levels)
+{
+  assert(transport_ == nullptr);
+  for (auto& zoom : zoom_levels)
+  {
+    zoom = std::clamp(zoom, 1u, max_quadkey_zoom);
+  }
+  tile_zoom_levels_ = std::move(zoom_levels);
+}
+
+bool ETSIAMQPTransceiverBase::setReceiveFilter(const std::string& filter_query)
+{
+  return transport_ != nullptr && transport_->setFilter(filter_query);
+}
+
+bool ETSIAMQPTransceiverBase::setSendPriority(ETSIMessageType message_type, SendPriority priority)
+{
+  assert(transport_ == nullptr);
+  auto* handler = findHandler(message_type);
+  if (handler == nullptr || handler->subject.empty())
+  {
+    LOG_ERR("Cannot set send priority of unknown message type " << static_cast<uint32_t>(message_type));
+    return false;
+  }
+  handler->priority = priority;
+  return true;
+}
+
+void ETSIAMQPTransceiverBase::setSendScheduling(mrm::v2x_amqp_connector_lib::LaneScheduling scheduling,
+                                                std::vector<uint32_t> weights)
+{
+  assert(transport_ == nullptr);
+  send_scheduling_ = scheduling;
+  send_weights_ = std::move(weights);
+}
+
+std::vector<mrm::v2x_amqp_connector_lib::SendLaneStats> ETSIAMQPTransceiverBase::sendLaneStats() const
+{
+  if (transport_ == nullptr)
+  {
+    return {};
   }
+  return transport_->sendLaneStats();
 }
 
 void ETSIAMQPTransceiverBase::handleMessage(const proton::message& message)
@@ -99,16 +403,16 @@ void ETSIAMQPTransceiverBase::handleMessage(const proton::message& message)
   }
   auto mid = proton::get<uint16_t>(message.properties().get("mid"));
   bin_msg.message_type = static_cast<ETSIMessageType>(mid);
-  auto msg_type_str = type2str.find(bin_msg.message_type);
-  if (msg_type_str == type2str.end())
+  const auto* handler = findHandler(bin_msg.message_type);
+  if (handler == nullptr || handler->subject.empty())
   {
     LOG_WARN_THROTTLE(5.0, "Message type unknown: " << mid);
     return;
   }
-  if (message.subject() != msg_type_str->second)
+  if (message.subject() != handler->subject)
   {
     LOG_WARN_THROTTLE(5.0,
-                      "Message subject does not match mid: " << message.subject() << " vs. " << msg_type_str->second
+                      "Message subject does not match mid: " << message.subject() << " vs. " << handler->subject
                                                              << " (from mid)");
     return;
   }
@@ -129,6 +433,18 @@ void ETSIAMQPTransceiverBase::handleMessage(const proton::message& message)
     bin_msg.destination_station_id = destination;
   }
 
+  if (message.properties().exists("enc"))
+  {
+    const auto enc = proton::get<std::string>(message.properties().get("enc"));
+    const auto encoding = wireEncodingFromString(enc);
+    if (!encoding)
+    {
+      LOG_WARN_THROTTLE(5.0, "Message encoding unknown: " << enc);
+      return;
+    }
+    bin_msg.encoding = *encoding;
+  }
+
   auto ct = message.creation_time();
   LOG_DEB("creation_time was: " << ct);
   bin_msg.time = std::chrono::system_clock::time_point{ std::chrono::milliseconds{ ct.milliseconds() } };
@@ -162,81 +478,226 @@ void ETSIAMQPTransceiverBase::handleMessage(const proton::message& message)
 void ETSIAMQPTransceiverBase::handleBinaryMessage(const BinaryETSIMessage& msg)
 {
   LOG_DEB("Got binary ETSI message: " << msg.message_type);
-  auto handler = etsi_msg_handlers_.find(msg.message_type);
-  if (handler == etsi_msg_handlers_.end())
+  if (duplicate_filter_ &&
+      duplicate_filter_->isDuplicate(
+          msg.message_type, msg.station_id, msg.data.data(), msg.data.size(), DuplicateFilter::Clock::now()))
+  {
+    LOG_DEB("Dropping duplicate " << msg.message_type << " from station " << msg.station_id);
+    return;
+  }
+  const auto* handler = findHandler(msg.message_type);
+  if (handler == nullptr || handler->dispatch == nullptr)
   {
     LOG_WARN("No handler registered for this ETSI message type: " << static_cast<int>(msg.message_type));
     return;
   }
 
-  const auto* type = std::get<0>(handler->second);
-  auto handler_f = std::get<1>(handler->second);
   void* pMsg = nullptr;
-
-  auto ret = uper_decode_complete(nullptr, type, &pMsg, msg.data.data(), msg.data.size());
-  auto msg_ptr = std::shared_ptr<void>(pMsg, [type](void* data) { ASN_STRUCT_FREE(*type, data); });
-
-  if (ret.code != RC_OK)
+  const auto cpm_container_mask =
+      msg.message_type == ETSIMessageType::CPM ? cpm_container_mask_ : std::optional<uint32_t>();
+  const auto result = decodeETSIMsgLimited(
+      handler->type, msg.encoding, &pMsg, msg.data.data(), msg.data.size(), handler->limits, cpm_container_mask);
+  if (result != DecodeLimitResult::Ok)
   {
-    LOG_ERR_THROTTLE(5.0, "Decoding of " << msg.message_type << " failed!");
+    ASN_STRUCT_FREE(*handler->type, pMsg);
+    if (result == DecodeLimitResult::DecodingFailed)
+    {
+      LOG_ERR_THROTTLE(5.0, "Decoding of " << msg.message_type << " (" << toString(msg.encoding) << ") failed!");
+    }
+    else
+    {
+      num_rejected_messages_++;
+      LOG_WARN_THROTTLE(5.0,
+                        "Rejected " << msg.message_type << " from station " << msg.station_id << " ("
+                                    << msg.data.size() << " bytes): " << toString(result));
+    }
     return;
   }
 
-  handler_f(msg_ptr, msg);
+  const std::shared_ptr<const void> decoded(pMsg, ASNStructDeleter<void>{ handler->type });
+  if (message_hub_ && message_hub_->hasSubscribers())
+  {
+    message_hub_->publish({ handler->type, decoded, std::make_shared<const BinaryETSIMessage>(msg) });
+  }
+  handler->dispatch(*handler, decoded, msg);
 }
 
 bool ETSIAMQPTransceiverBase::sendETSIMsg(const asn_TYPE_descriptor_t* type,
                                           const ETSIMessageType message_type,
                                           void* pMsg,
                                           std::optional<StationId_t> destination_station_id)
+{
+  return sendETSIMsgAs(station_id_, type, message_type, pMsg, destination_station_id);
+}
+
+bool ETSIAMQPTransceiverBase::sendEncodedETSIMsg(const char* buffer,
+                                                 size_t size,
+                                                 const ETSIMessageType message_type,
+                                                 std::optional<StationId_t> destination_station_id,
+                                                 WireEncoding encoding,
+                                                 std::optional<GeoPosition> reference_position)
+{
+  return sendEncodedETSIMsgAs(
+      station_id_, buffer, size, message_type, destination_station_id, encoding, reference_position);
+}
+
+bool ETSIAMQPTransceiverBase::sendETSIMsgAs(StationId_t station_id,
+                                            const asn_TYPE_descriptor_t* type,
+                                            const ETSIMessageType message_type,
+                                            void* pMsg,
+                                            std::optional<StationId_t> destination_station_id,
+                                            SettleCallback on_settled)
 {
   if (!is_sender_connected())
   {
     return false;
   }
   LOG_DEB("sendETSIMsg: " << message_type);
-  auto res = asn_encode_to_new_buffer(nullptr, ATS_UNALIGNED_BASIC_PER, type, pMsg);
+  const auto encoding = encoding_.load();
+  auto res = encodeETSIMsg(type, encoding, pMsg);
   if (res.buffer == nullptr || res.result.encoded < 0)
   {
-    LOG_WARN_THROTTLE(5.0, "UPER encoding of message failed!");
+    LOG_WARN_THROTTLE(5.0, toString(encoding) << " encoding of message failed!");
     return false;
   }
 
-  bool ret = sendEncodedETSIMsg(
-      static_cast<const char*>(res.buffer), res.result.encoded, message_type, destination_station_id);
+  const auto position = tile_zoom_levels_.empty() ? std::nullopt : referencePosition(message_type, pMsg);
+  bool ret = sendEncodedETSIMsgAs(station_id,
+                                  static_cast<const char*>(res.buffer),
+                                  res.result.encoded,
+                                  message_type,
+                                  destination_station_id,
+                                  encoding,
+                                  position,
+                                  std::move(on_settled));
   free(res.buffer);
   return ret;
 }
 
-bool ETSIAMQPTransceiverBase::sendEncodedETSIMsg(const char* buffer,
-                                                 size_t size,
-                                                 const ETSIMessageType message_type,
-                                                 std::optional<StationId_t> destination_station_id)
+bool ETSIAMQPTransceiverBase::sendEncodedETSIMsgAs(StationId_t station_id,
+                                                   const char* buffer,
+                                                   size_t size,
+                                                   const ETSIMessageType message_type,
+                                                   std::optional<StationId_t> destination_station_id,
+                                                   WireEncoding encoding,
+                                                   std::optional<GeoPosition> reference_position,
+                                                   SettleCallback on_settled)
 {
-  proton::message message;
-  message.body() = proton::binary(std::string(const_cast<char*>(buffer), size));
-  message.ttl(message_type != ETSIMessageType::CPM ? proton::duration::SECOND : proton::duration(100));  // 100 ms
-  message.subject(type2str.at(message_type));
+  OutgoingETSIMessage message;
+  if (!makeOutgoingMessage(station_id,
+                           buffer,
+                           size,
+                           message_type,
+                           destination_station_id,
+                           encoding,
+                           reference_position,
+                           std::chrono::system_clock::now(),
+                           message))
+  {
+    return false;
+  }
+  message.on_settled = std::move(on_settled);
 
-  proton::timestamp timestamp;
-  const auto now =
-      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-  timestamp = now / 1'000'000;
-  message.creation_time(timestamp);
+  if (!is_sender_connected() || !transport_->send(message))
+  {
+    LOG_ERR_THROTTLE(5.0, "Error sending " << message.subject << " message...");
+    return false;
+  }
+  LOG_DEB("Sending " << message_type << " message with station_id " << station_id);
+  return true;
+}
 
-  message.properties().put("mid", (uint16_t)message_type);
-  message.properties().put("station_id", static_cast<uint32_t>(station_id_));
-  if (destination_station_id)
+size_t ETSIAMQPTransceiverBase::sendETSIMsgBatch(const std::vector<StationETSIMessage>& messages)
+{
+  if (!is_sender_connected())
   {
-    message.properties().put("destination_station_id", static_cast<uint32_t>(*destination_station_id));
+    return 0;
+  }
+  const auto encoding = encoding_.load();
+  const auto now = std::chrono::system_clock::now();
+  std::vector<OutgoingETSIMessage> outgoing;
+  outgoing.reserve(messages.size());
+  // the outgoing messages reference the encoded buffers until they are sent
+  std::vector<void*> buffers;
+  buffers.reserve(messages.size());
+  for (const auto& msg : messages)
+  {
+    auto res = encodeETSIMsg(msg.type, encoding, msg.msg);
+    if (res.buffer == nullptr || res.result.encoded < 0)
+    {
+      LOG_WARN_THROTTLE(5.0, toString(encoding) << " encoding of message failed!");
+      free(res.buffer);
+      continue;
+    }
+    buffers.push_back(res.buffer);
+
+    const auto position = tile_zoom_levels_.empty() ? std::nullopt : referencePosition(msg.message_type, msg.msg);
+    OutgoingETSIMessage message;
+    if (makeOutgoingMessage(msg.station_id,
+                            static_cast<const char*>(res.buffer),
+                            res.result.encoded,
+                            msg.message_type,
+                            msg.destination_station_id,
+                            encoding,
+                            position,
+                            now,
+                            message))
+    {
+      outgoing.push_back(std::move(message));
+    }
   }
 
-  if (!is_sender_connected() || !client_->send(message))
+  const size_t num_sent = outgoing.empty() || !is_sender_connected() ? 0 : transport_->sendBatch(outgoing);
+  for (auto* buffer : buffers)
   {
-    LOG_ERR_THROTTLE(5.0, "Error sending " << type2str.at(message_type) << " message...");
+    free(buffer);
+  }
+  if (num_sent < outgoing.size())
+  {
+    LOG_ERR_THROTTLE(5.0,
+                     "Error sending " << outgoing.size() - num_sent << " of " << outgoing.size() << " messages...");
+  }
+  LOG_DEB("Sent batch of " << num_sent << " messages");
+  return num_sent;
+}
+
+bool ETSIAMQPTransceiverBase::makeOutgoingMessage(StationId_t station_id,
+                                                  const char* buffer,
+                                                  size_t size,
+                                                  const ETSIMessageType message_type,
+                                                  std::optional<StationId_t> destination_station_id,
+                                                  WireEncoding encoding,
+                                                  const std::optional<GeoPosition>& reference_position,
+                                                  std::chrono::system_clock::time_point time,
+                                                  OutgoingETSIMessage& message) const
+{
+  const auto* handler = findHandler(message_type);
+  if (handler == nullptr || handler->subject.empty())
+  {
+    LOG_ERR("No subject known for message type " << message_type << ", not sending");
     return false;
   }
-  LOG_DEB("Sending " << message_type << " message with station_id " << station_id_);
+
+  message.message_type = message_type;
+  message.subject = handler->subject;
+  message.station_id = station_id;
+  message.destination_station_id = destination_station_id;
+  message.time = time;
+  message.ttl = message_type != ETSIMessageType::CPM ? std::chrono::milliseconds(1000) : std::chrono::milliseconds(100);
+  message.priority = handler->priority;
+  message.data = reinterpret_cast<const uint8_t*>(buffer);
+  message.size = size;
+  message.encoding = encoding;
+  if (reference_position && !tile_zoom_levels_.empty())
+  {
+    // the quadkeys of lower zoom levels are prefixes of the one of the highest level
+    const auto max_zoom = *std::max_element(tile_zoom_levels_.begin(), tile_zoom_levels_.end());
+    const auto key = quadkey(reference_position->latitude, reference_position->longitude, max_zoom);
+    for (const auto zoom : tile_zoom_levels_)
+    {
+      message.properties.emplace_back(quadkeyProperty(zoom), key.substr(0, zoom));
+    }
+  }
   return true;
 }
 
@@ -332,7 +793,7 @@ void ETSIAMQPTransceiverBase::handleMCM(const std::shared_ptr<const MCM>& msg, c
 
 bool ETSIAMQPTransceiverBase::is_sender_connected()
 {
-  return client_->is_sender_connected();
+  return transport_ && transport_->is_sender_connected();
 }
 
 }  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,261 @@
+#include <v2x_etsi_asn1_lib/async_transceiver.h>
+#include <v2x_etsi_asn1_lib/loopback_transport.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <gtest/gtest.h>
+#include "test_messages.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+using mrm::v2x_amqp_connector_lib::LocalBroker;
+using mrm::v2x_amqp_connector_lib::LocalBrokerOptions;
+
+namespace
+{
+// Runs the resumed coroutines on the thread calling run()
+class QueueExecutor
+{
+public:
+  Executor executor()
+  {
+    return [this](std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> l(lock_);
+      handles_.push_back(handle);
+    };
+  }
+
+  // Resumes the queued coroutines, returns the number of resumed ones
+  size_t run()
+  {
+    size_t num_resumed = 0;
+    std::unique_lock<std::mutex> l(lock_);
+    while (!handles_.empty())
+    {
+      auto handle = handles_.front();
+      handles_.pop_front();
+      l.unlock();
+      handle.resume();
+      num_resumed++;
+      l.lock();
+    }
+    return num_resumed;
+  }
+
+  // Resumes queued coroutines until the condition holds, for coroutines resumed from another thread
+  bool runUntil(const std::function<bool()>& condition, std::chrono::milliseconds timeout)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition())
+    {
+      if (std::chrono::steady_clock::now() > deadline)
+      {
+        return false;
+      }
+      if (run() == 0)
+      {
+        std::this_thread::sleep_for(1ms);
+      }
+    }
+    return true;
+  }
+
+private:
+  std::mutex lock_;
+  std::deque<std::coroutine_handle<>> handles_;
+};
+
+// Calls the handlers directly instead of receiving messages
+struct TestTransceiver : AsyncETSITransceiver
+{
+  using AsyncETSITransceiver::AsyncETSITransceiver;
+  using AsyncETSITransceiver::handleCAM;
+  using AsyncETSITransceiver::handleVAM;
+};
+
+bool waitFor(const std::function<bool()>& condition)
+{
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (!condition())
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+BinaryETSIMessage makeBinaryMessage(ETSIMessageType message_type, StationId_t station_id)
+{
+  BinaryETSIMessage msg_bin;
+  msg_bin.message_type = message_type;
+  msg_bin.station_id = station_id;
+  return msg_bin;
+}
+
+DetachedTask collectCAMs(AsyncETSITransceiver& transceiver, std::vector<StationId_t>& station_ids, bool& done)
+{
+  while (auto cam = co_await transceiver.next<CAM>())
+  {
+    station_ids.push_back(cam->msg_bin.station_id);
+  }
+  done = true;
+}
+
+DetachedTask sendMessage(AsyncETSITransceiver& transceiver, void* msg, std::optional<bool>& accepted)
+{
+  accepted = co_await transceiver.send(&asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, msg);
+}
+
+DetachedTask receiveSegment(AsyncETSITransceiver& transceiver, std::optional<StationId_t>& station_id)
+{
+  auto segment = co_await transceiver.next<CollectivePerceptionMessage>();
+  station_id = segment->msg_bin.station_id;
+}
+
+DetachedTask receiveCompleteCPM(AsyncETSITransceiver& transceiver, std::optional<CompleteCPM>& complete_cpm)
+{
+  complete_cpm = co_await transceiver.nextCompleteCPM();
+}
+}  // namespace
+
+TEST(AsyncTransceiverTests, resumesWaitingCoroutines)
+{
+  QueueExecutor executor;
+  TestTransceiver transceiver(executor.executor());
+  const auto cam = allocateETSIMsg<CAM>(asn_DEF_CAM);
+
+  std::vector<StationId_t> station_ids;
+  bool done = false;
+  collectCAMs(transceiver, station_ids, done);
+  ASSERT_TRUE(station_ids.empty());
+
+  transceiver.handleCAM(cam, makeBinaryMessage(ETSIMessageType::CAM, 1));
+  transceiver.handleCAM(cam, makeBinaryMessage(ETSIMessageType::CAM, 2));
+  // the waiting coroutine is resumed through the executor only, then takes the queued CAM without suspending
+  ASSERT_TRUE(station_ids.empty());
+  ASSERT_EQ(executor.run(), 1);
+  ASSERT_EQ(station_ids, std::vector<StationId_t>({ 1, 2 }));
+
+  // nobody waits for VAMs, so they are not queued
+  transceiver.handleVAM(allocateETSIMsg<VAM>(asn_DEF_VAM), makeBinaryMessage(ETSIMessageType::VAM, 3));
+  ASSERT_EQ(transceiver.numDropped(), 0);
+
+  transceiver.close();
+  ASSERT_FALSE(done);
+  ASSERT_EQ(executor.run(), 1);
+  ASSERT_TRUE(done);
+}
+
+TEST(AsyncTransceiverTests, dropsOldestMessages)
+{
+  QueueExecutor executor;
+  TestTransceiver transceiver(executor.executor(), 2);
+  const auto cam = allocateETSIMsg<CAM>(asn_DEF_CAM);
+
+  std::vector<StationId_t> station_ids;
+  bool done = false;
+  collectCAMs(transceiver, station_ids, done);
+  for (StationId_t station_id = 1; station_id <= 5; station_id++)
+  {
+    transceiver.handleCAM(cam, makeBinaryMessage(ETSIMessageType::CAM, station_id));
+  }
+  // the first one is handed to the waiting coroutine, two of the others fit into the queue
+  ASSERT_EQ(transceiver.numDropped(), 2);
+  executor.run();
+  ASSERT_EQ(station_ids, std::vector<StationId_t>({ 1, 4, 5 }));
+  transceiver.close();
+  executor.run();
+  ASSERT_TRUE(done);
+}
+
+TEST(AsyncTransceiverTests, sendsAndReceivesCPMs)
+{
+  QueueExecutor executor;
+  auto bus = LoopbackBus::create();
+  AsyncETSITransceiver sender(executor.executor());
+  AsyncETSITransceiver receiver(executor.executor());
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  test::buildCPM(builder, 1);
+  test::appendPerceivedObject(builder, 1, 10.0, -5.0);
+
+  std::optional<StationId_t> segment_station_id;
+  std::optional<CompleteCPM> complete_cpm;
+  receiveSegment(receiver, segment_station_id);
+  receiveCompleteCPM(receiver, complete_cpm);
+
+  std::optional<bool> accepted;
+  sendMessage(sender, builder.get(), accepted);
+  // the loopback transport delivers messages right away, so the sender does not need to suspend
+  ASSERT_EQ(accepted, true);
+
+  ASSERT_TRUE(executor.runUntil([&]() { return segment_station_id && complete_cpm; }, 1s));
+  ASSERT_EQ(segment_station_id, 1);
+  ASSERT_EQ(complete_cpm->station_id, 1);
+  ASSERT_EQ(complete_cpm->segments.size(), 1);
+
+  // not connected, the coroutine continues right away
+  sender.disconnect();
+  accepted.reset();
+  sendMessage(sender, builder.get(), accepted);
+  ASSERT_EQ(accepted, false);
+}
+
+TEST(AsyncTransceiverTests, resumesSenderWhenBrokerSettles)
+{
+  LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  QueueExecutor executor;
+  AsyncETSITransceiver sender(executor.executor());
+  sender.connect(1, "127.0.0.1:" + std::to_string(broker.port()), "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return sender.is_sender_connected(); }));
+
+  test::TestCPM cpm;
+  std::optional<bool> accepted;
+  sendMessage(sender, cpm.msg, accepted);
+  // the broker settles the message on the container thread, which only hands the coroutine to the executor
+  ASSERT_FALSE(accepted);
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().received == 1; }));
+  std::this_thread::sleep_for(50ms);
+  ASSERT_FALSE(accepted);
+  ASSERT_TRUE(executor.runUntil([&]() { return accepted.has_value(); }, 5s));
+  ASSERT_EQ(accepted, true);
+}
+
+TEST(AsyncTransceiverTests, resumesSenderWithFailureOnDisconnect)
+{
+  // a broker granting no credit, so that the message stays queued in the sender
+  LocalBrokerOptions options;
+  options.credit_window = 0;
+  LocalBroker broker(options);
+  ASSERT_TRUE(broker.start());
+  QueueExecutor executor;
+  AsyncETSITransceiver sender(executor.executor());
+  sender.connect(1, "127.0.0.1:" + std::to_string(broker.port()), "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return sender.is_sender_connected(); }));
+
+  test::TestCPM cpm;
+  std::optional<bool> accepted;
+  sendMessage(sender, cpm.msg, accepted);
+  ASSERT_TRUE(waitFor([&]() {
+    const auto stats = sender.sendLaneStats();
+    return std::any_of(stats.begin(), stats.end(), [](const auto& lane) { return lane.queue_depth == 1; });
+  }));
+  std::this_thread::sleep_for(50ms);
+  ASSERT_EQ(executor.run(), 0);
+  ASSERT_FALSE(accepted);
+
+  broker.stop();
+  ASSERT_TRUE(executor.runUntil([&]() { return accepted.has_value(); }, 5s));
+  ASSERT_EQ(accepted, false);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
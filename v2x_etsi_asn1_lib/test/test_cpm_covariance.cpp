@@ -0,0 +1,435 @@
+#include <v2x_etsi_asn1_lib/cpm_covariance.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <random>
+
+#include <v2x_etsi_asn1_lib/utils.h>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+constexpr size_t dim = num_covariance_components;
+
+// Per-object, per-element decoding with the utils.h helpers, which the batched decoding is checked against
+ObjectCovariance referenceCovariance(const PerceivedObject& obj)
+{
+  double variances[dim];
+  std::fill(std::begin(variances), std::end(variances), NAN);
+  auto set = [&](size_t component, long confidence, long out_of_range, double variance) {
+    if (confidence < out_of_range)
+    {
+      variances[component] = variance;
+    }
+  };
+  auto set_coordinate = [&](size_t component, long confidence) {
+    set(component,
+        confidence,
+        CoordinateConfidence_outOfRange,
+        decodeConfidence(confidence, CoordinateConfidenceUnit_m));
+  };
+  auto set_speed = [&](size_t component, long confidence) {
+    set(component, confidence, SpeedConfidence_outOfRange, decodeConfidence(confidence, SpeedConfidenceUnit_m_s));
+  };
+  auto set_acceleration = [&](size_t component, long confidence) {
+    set(component,
+        confidence,
+        AccelerationConfidence_outOfRange,
+        decodeConfidence(confidence, AccelerationConfidenceUnit_m_s_2));
+  };
+  auto set_angle = [&](size_t component, long confidence) {
+    set(component,
+        confidence,
+        AngleConfidence_outOfRange,
+        decodeConfidenceAngle(confidence, AngleConfidenceUnit_degrees));
+  };
+  auto set_dimension = [&](size_t component, const ObjectDimension_t* dimension) {
+    if (dimension != nullptr)
+    {
+      set(component,
+          dimension->confidence,
+          ObjectDimensionConfidence_outOfRange,
+          decodeConfidence(dimension->confidence, ObjectDimensionConfidenceUnit_m));
+    }
+  };
+
+  set_coordinate(CovarianceComponent_xPosition, obj.position.xCoordinate.confidence);
+  set_coordinate(CovarianceComponent_yPosition, obj.position.yCoordinate.confidence);
+  if (obj.position.zCoordinate != nullptr)
+  {
+    set_coordinate(CovarianceComponent_zPosition, obj.position.zCoordinate->confidence);
+  }
+  if (obj.velocity != nullptr && obj.velocity->present == Velocity3dWithConfidence_PR_polarVelocity)
+  {
+    const auto& polar = obj.velocity->choice.polarVelocity;
+    set_speed(CovarianceComponent_xVelocityOrVelocityMagnitude, polar.velocityMagnitude.speedConfidence);
+    set_angle(CovarianceComponent_yVelocityOrVelocityDirection, polar.velocityDirection.confidence);
+    if (polar.zVelocity != nullptr)
+    {
+      set_speed(CovarianceComponent_zSpeed, polar.zVelocity->confidence);
+    }
+  }
+  if (obj.velocity != nullptr && obj.velocity->present == Velocity3dWithConfidence_PR_cartesianVelocity)
+  {
+    const auto& cartesian = obj.velocity->choice.cartesianVelocity;
+    set_speed(CovarianceComponent_xVelocityOrVelocityMagnitude, cartesian.xVelocity.confidence);
+    set_speed(CovarianceComponent_yVelocityOrVelocityDirection, cartesian.yVelocity.confidence);
+    if (cartesian.zVelocity != nullptr)
+    {
+      set_speed(CovarianceComponent_zSpeed, cartesian.zVelocity->confidence);
+    }
+  }
+  if (obj.acceleration != nullptr && obj.acceleration->present == Acceleration3dWithConfidence_PR_polarAcceleration)
+  {
+    const auto& polar = obj.acceleration->choice.polarAcceleration;
+    set_acceleration(CovarianceComponent_xAccelOrAccelMagnitude, polar.accelerationMagnitude.accelerationConfidence);
+    set_angle(CovarianceComponent_yAccelOrAccelDirection, polar.accelerationDirection.confidence);
+    if (polar.zAcceleration != nullptr)
+    {
+      set_acceleration(CovarianceComponent_zAcceleration, polar.zAcceleration->confidence);
+    }
+  }
+  if (obj.acceleration != nullptr &&
+      obj.acceleration->present == Acceleration3dWithConfidence_PR_cartesianAcceleration)
+  {
+    const auto& cartesian = obj.acceleration->choice.cartesianAcceleration;
+    set_acceleration(CovarianceComponent_xAccelOrAccelMagnitude, cartesian.xAcceleration.confidence);
+    set_acceleration(CovarianceComponent_yAccelOrAccelDirection, cartesian.yAcceleration.confidence);
+    if (cartesian.zAcceleration != nullptr)
+    {
+      set_acceleration(CovarianceComponent_zAcceleration, cartesian.zAcceleration->confidence);
+    }
+  }
+  if (obj.angles != nullptr)
+  {
+    set_angle(CovarianceComponent_zAngle, obj.angles->zAngle.confidence);
+    if (obj.angles->yAngle != nullptr)
+    {
+      set_angle(CovarianceComponent_yAngle, obj.angles->yAngle->confidence);
+    }
+    if (obj.angles->xAngle != nullptr)
+    {
+      set_angle(CovarianceComponent_xAngle, obj.angles->xAngle->confidence);
+    }
+  }
+  if (obj.zAngularVelocity != nullptr && obj.zAngularVelocity->confidence < AngularSpeedConfidence_outOfRange)
+  {
+    const auto deg_s = angular_speed_conf_2_deg_conf.at(obj.zAngularVelocity->confidence);
+    variances[CovarianceComponent_zAngularVelocity] = decodeConfidenceAngle(deg_s, 1.0);
+  }
+  set_dimension(CovarianceComponent_objectDimensionZ, obj.objectDimensionZ);
+  set_dimension(CovarianceComponent_objectDimensionY, obj.objectDimensionY);
+  set_dimension(CovarianceComponent_objectDimensionX, obj.objectDimensionX);
+
+  ObjectCovariance covariance{};
+  for (size_t row = 0; row < dim; row++)
+  {
+    for (size_t col = 0; col < dim; col++)
+    {
+      // unknown variances make the whole row and column NaN
+      covariance(row, col) = row == col ? variances[row] : 0.0 * variances[row] * variances[col];
+    }
+    if (!std::isnan(variances[row]))
+    {
+      covariance.available |= 1u << row;
+    }
+  }
+  if (obj.lowerTriangularCorrelationMatrices == nullptr)
+  {
+    return covariance;
+  }
+  for (int m = 0; m < obj.lowerTriangularCorrelationMatrices->list.count; m++)
+  {
+    const auto& matrix = *obj.lowerTriangularCorrelationMatrices->list.array[m];
+    std::vector<size_t> components;
+    for (size_t c = 0; c < dim; c++)
+    {
+      if (matrix.componentsIncludedIntheMatrix.buf[c / 8] & (0x80 >> (c % 8)))
+      {
+        components.push_back(c);
+      }
+    }
+    for (size_t i = 0; i + 1 < components.size(); i++)
+    {
+      for (size_t k = 0; i + 1 + k < components.size(); k++)
+      {
+        const long value = *matrix.matrix.list.array[i]->list.array[k];
+        if (value == CorrelationCellValue_unavailable)
+        {
+          continue;
+        }
+        const size_t a = components[i];
+        const size_t b = components[i + 1 + k];
+        covariance(a, b) = covariance(b, a) =
+            static_cast<double>(value) / 100.0 * std::sqrt(variances[a]) * std::sqrt(variances[b]);
+      }
+    }
+  }
+  return covariance;
+}
+
+void expectSameCovariance(const ObjectCovariance& a, const ObjectCovariance& b)
+{
+  EXPECT_EQ(a.available, b.available);
+  for (size_t row = 0; row < dim; row++)
+  {
+    for (size_t col = 0; col < dim; col++)
+    {
+      if (std::isnan(b(row, col)))
+      {
+        EXPECT_TRUE(std::isnan(a(row, col))) << row << ", " << col;
+      }
+      else
+      {
+        EXPECT_DOUBLE_EQ(a(row, col), b(row, col)) << row << ", " << col;
+      }
+    }
+  }
+}
+
+using Builder = MessageBuilder<CollectivePerceptionMessage>;
+
+PerceivedObjectContainer_t& addObjectContainer(Builder& builder)
+{
+  auto& container = builder.append(builder.get()->payload.cpmContainers.list);
+  container.containerId = 5;
+  container.containerData.present = WrappedCpmContainer__containerData_PR_PerceivedObjectContainer;
+  return container.containerData.choice.PerceivedObjectContainer;
+}
+
+void addCorrelations(Builder& builder, PerceivedObject& obj, uint16_t components, const std::vector<long>& cells)
+{
+  if (obj.lowerTriangularCorrelationMatrices == nullptr)
+  {
+    builder.create(obj.lowerTriangularCorrelationMatrices);
+  }
+  auto& matrix = builder.append(obj.lowerTriangularCorrelationMatrices->list);
+  // bit 0 of the BIT STRING is the most significant one
+  uint8_t bits[2] = {};
+  for (size_t c = 0; c < dim; c++)
+  {
+    if (components & (1u << c))
+    {
+      bits[c / 8] |= static_cast<uint8_t>(0x80 >> (c % 8));
+    }
+  }
+  builder.setBits(matrix.componentsIncludedIntheMatrix, bits, dim);
+  const size_t n = static_cast<size_t>(__builtin_popcount(components));
+  size_t next = 0;
+  for (size_t i = 0; i + 1 < n; i++)
+  {
+    auto& column = builder.append(matrix.matrix.list);
+    for (size_t k = 0; i + 1 + k < n; k++)
+    {
+      builder.append(column.list) = cells.at(next++);
+    }
+  }
+}
+
+// An object with random confidences (including outOfRange and unavailable ones), optional members and correlations
+void addRandomObject(Builder& builder, PerceivedObjectContainer_t& container, std::mt19937& rng)
+{
+  auto chance = [&](double p) { return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < p; };
+  auto confidence = [&](long min, long out_of_range) {
+    return std::uniform_int_distribution<long>(min, out_of_range + 1)(rng);
+  };
+
+  auto& obj = builder.append(container.perceivedObjects.list);
+  obj.position.xCoordinate.confidence = confidence(1, CoordinateConfidence_outOfRange);
+  obj.position.yCoordinate.confidence = confidence(1, CoordinateConfidence_outOfRange);
+  if (chance(0.5))
+  {
+    builder.create(obj.position.zCoordinate).confidence = confidence(1, CoordinateConfidence_outOfRange);
+  }
+  if (chance(0.8))
+  {
+    auto& velocity = builder.create(obj.velocity);
+    if (chance(0.5))
+    {
+      velocity.present = Velocity3dWithConfidence_PR_polarVelocity;
+      auto& polar = velocity.choice.polarVelocity;
+      polar.velocityMagnitude.speedConfidence = confidence(1, SpeedConfidence_outOfRange);
+      polar.velocityDirection.confidence = confidence(1, AngleConfidence_outOfRange);
+      if (chance(0.5))
+      {
+        builder.create(polar.zVelocity).confidence = confidence(1, SpeedConfidence_outOfRange);
+      }
+    }
+    else
+    {
+      velocity.present = Velocity3dWithConfidence_PR_cartesianVelocity;
+      auto& cartesian = velocity.choice.cartesianVelocity;
+      cartesian.xVelocity.confidence = confidence(1, SpeedConfidence_outOfRange);
+      cartesian.yVelocity.confidence = confidence(1, SpeedConfidence_outOfRange);
+    }
+  }
+  if (chance(0.5))
+  {
+    auto& acceleration = builder.create(obj.acceleration);
+    if (chance(0.5))
+    {
+      acceleration.present = Acceleration3dWithConfidence_PR_polarAcceleration;
+      auto& polar = acceleration.choice.polarAcceleration;
+      polar.accelerationMagnitude.accelerationConfidence = confidence(0, AccelerationConfidence_outOfRange);
+      polar.accelerationDirection.confidence = confidence(1, AngleConfidence_outOfRange);
+    }
+    else
+    {
+      acceleration.present = Acceleration3dWithConfidence_PR_cartesianAcceleration;
+      auto& cartesian = acceleration.choice.cartesianAcceleration;
+      cartesian.xAcceleration.confidence = confidence(0, AccelerationConfidence_outOfRange);
+      cartesian.yAcceleration.confidence = confidence(0, AccelerationConfidence_outOfRange);
+      if (chance(0.5))
+      {
+        builder.create(cartesian.zAcceleration).confidence = confidence(0, AccelerationConfidence_outOfRange);
+      }
+    }
+  }
+  if (chance(0.7))
+  {
+    auto& angles = builder.create(obj.angles);
+    angles.zAngle.confidence = confidence(1, AngleConfidence_outOfRange);
+    if (chance(0.3))
+    {
+      builder.create(angles.yAngle).confidence = confidence(1, AngleConfidence_outOfRange);
+      builder.create(angles.xAngle).confidence = confidence(1, AngleConfidence_outOfRange);
+    }
+  }
+  if (chance(0.5))
+  {
+    builder.create(obj.zAngularVelocity).confidence = confidence(0, AngularSpeedConfidence_outOfRange);
+  }
+  for (auto* dimension : { &obj.objectDimensionZ, &obj.objectDimensionY, &obj.objectDimensionX })
+  {
+    if (chance(0.7))
+    {
+      builder.create(*dimension).confidence = confidence(1, ObjectDimensionConfidence_outOfRange);
+    }
+  }
+
+  // up to 4 matrices, which may include absent components
+  const int num_matrices = std::uniform_int_distribution<int>(0, 4)(rng);
+  for (int m = 0; m < num_matrices; m++)
+  {
+    const auto components = static_cast<uint16_t>(std::uniform_int_distribution<int>(0, 0xffff)(rng));
+    if (__builtin_popcount(components) < 2)
+    {
+      continue;
+    }
+    std::vector<long> cells(dim * dim);
+    for (auto& cell : cells)
+    {
+      cell = std::uniform_int_distribution<long>(-100, CorrelationCellValue_unavailable)(rng);
+    }
+    addCorrelations(builder, obj, components, cells);
+  }
+}
+}  // namespace
+
+TEST(CpmCovarianceTests, decodesCovariance)
+{
+  Builder builder;
+  builder.reset();
+  auto& container = addObjectContainer(builder);
+  auto& obj = builder.append(container.perceivedObjects.list);
+  // standard deviations of 1 m, 2 m and 0.5 m/s
+  obj.position.xCoordinate.confidence = 196;
+  obj.position.yCoordinate.confidence = 392;
+  auto& velocity = builder.create(obj.velocity);
+  velocity.present = Velocity3dWithConfidence_PR_cartesianVelocity;
+  velocity.choice.cartesianVelocity.xVelocity.confidence = 98;
+  velocity.choice.cartesianVelocity.yVelocity.confidence = SpeedConfidence_unavailable;
+  // x, y and x velocity: correlations of x with y and x velocity, then of y with x velocity
+  addCorrelations(builder, obj, 0b1011, { 50, -100, CorrelationCellValue_unavailable });
+
+  std::vector<ObjectCovariance> covariances;
+  decodeCpmCovariances(*builder.get(), covariances);
+  ASSERT_EQ(covariances.size(), 1);
+  const auto& covariance = covariances[0];
+  EXPECT_EQ(covariance.available, 0b1011);
+  EXPECT_DOUBLE_EQ(covariance(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(covariance(1, 1), 4.0);
+  EXPECT_DOUBLE_EQ(covariance(3, 3), 0.25);
+  EXPECT_DOUBLE_EQ(covariance(1, 0), 1.0);
+  EXPECT_DOUBLE_EQ(covariance(0, 1), 1.0);
+  EXPECT_DOUBLE_EQ(covariance(3, 0), -0.5);
+  EXPECT_DOUBLE_EQ(covariance(3, 1), 0.0);
+  EXPECT_TRUE(std::isnan(covariance(2, 2)));
+  EXPECT_TRUE(std::isnan(covariance(4, 0)));
+  EXPECT_TRUE(std::isnan(covariance(0, 15)));
+}
+
+TEST(CpmCovarianceTests, matchesReference)
+{
+  std::mt19937 rng(42);
+  Builder builder;
+  builder.reset();
+  for (int c = 0; c < 2; c++)
+  {
+    auto& container = addObjectContainer(builder);
+    for (int i = 0; i < 200; i++)
+    {
+      addRandomObject(builder, container, rng);
+    }
+  }
+
+  std::vector<ObjectCovariance> covariances;
+  decodeCpmCovariances(*builder.get(), covariances);
+  ASSERT_EQ(covariances.size(), 400);
+  for (size_t i = 0; i < covariances.size(); i++)
+  {
+    const auto& container = builder.get()->payload.cpmContainers.list.array[i / 200]->containerData.choice;
+    const auto& obj = *container.PerceivedObjectContainer.perceivedObjects.list.array[i % 200];
+    SCOPED_TRACE(i);
+    expectSameCovariance(covariances[i], referenceCovariance(obj));
+  }
+}
+
+TEST(CpmCovarianceTests, encodesDecodedCovariances)
+{
+  std::mt19937 rng(7);
+  Builder builder;
+  builder.reset();
+  auto& container = addObjectContainer(builder);
+  for (int i = 0; i < 200; i++)
+  {
+    addRandomObject(builder, container, rng);
+  }
+  std::vector<ObjectCovariance> covariances;
+  decodeCpmCovariances(*builder.get(), covariances);
+  const auto x_confidence = container.perceivedObjects.list.array[0]->position.xCoordinate.confidence;
+
+  ASSERT_TRUE(encodeCpmCovariances(*builder.get(), covariances, &builder.arena()));
+  const auto& obj = *container.perceivedObjects.list.array[0];
+  EXPECT_EQ(obj.position.xCoordinate.confidence,
+            x_confidence < CoordinateConfidence_outOfRange ? x_confidence : CoordinateConfidence_unavailable);
+
+  // confidences and correlations are reproduced, one matrix holds all known components
+  std::vector<ObjectCovariance> encoded;
+  decodeCpmCovariances(*builder.get(), encoded);
+  ASSERT_EQ(encoded.size(), covariances.size());
+  for (size_t i = 0; i < encoded.size(); i++)
+  {
+    SCOPED_TRACE(i);
+    expectSameCovariance(encoded[i], covariances[i]);
+    const auto* matrices = container.perceivedObjects.list.array[i]->lowerTriangularCorrelationMatrices;
+    if (__builtin_popcount(covariances[i].available) >= 2)
+    {
+      ASSERT_NE(matrices, nullptr);
+      EXPECT_EQ(matrices->list.count, 1);
+      EXPECT_EQ(matrices->list.array[0]->matrix.list.count, __builtin_popcount(covariances[i].available) - 1);
+    }
+    else
+    {
+      EXPECT_EQ(matrices, nullptr);
+    }
+  }
+
+  covariances.pop_back();
+  EXPECT_FALSE(encodeCpmCovariances(*builder.get(), covariances, &builder.arena()));
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
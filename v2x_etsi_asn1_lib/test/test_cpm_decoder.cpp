@@ -0,0 +1,363 @@
+#include <v2x_etsi_asn1_lib/cpm_decoder.h>
+#include <v2x_etsi_asn1_lib/decode_limits.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <gtest/gtest.h>
+
+#include <ManagementContainer.h>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+class BitWriter
+{
+public:
+  void write(unsigned bits, uint64_t value)
+  {
+    for (int i = static_cast<int>(bits) - 1; i >= 0; i--)
+    {
+      if (pos_ % 8 == 0)
+      {
+        data.push_back(0);
+      }
+      data.back() |= ((value >> i) & 1) << (7 - pos_ % 8);
+      pos_++;
+    }
+  }
+  [[nodiscard]] size_t position() const
+  {
+    return pos_;
+  }
+
+  std::vector<uint8_t> data;
+
+private:
+  size_t pos_ = 0;
+};
+
+std::vector<uint8_t> readBytes(const std::vector<uint8_t>& data, size_t bit_offset, size_t size)
+{
+  std::vector<uint8_t> ret;
+  for (size_t i = 0; i < size; i++)
+  {
+    uint8_t byte = 0;
+    for (size_t j = 0; j < 8; j++)
+    {
+      const size_t bit = bit_offset + i * 8 + j;
+      byte = (byte << 1) | ((data[bit / 8] >> (7 - bit % 8)) & 1);
+    }
+    ret.push_back(byte);
+  }
+  return ret;
+}
+
+// UPER encoding of a CPM with a segmentation info and two containers with dummy content
+struct TestCPM
+{
+  explicit TestCPM(std::vector<uint8_t> object_container_content = { 0xab, 0xcd, 0xef })
+    : object_container(std::move(object_container_content))
+  {
+    // header
+    w.write(8, 2);
+    w.write(8, 14);
+    w.write(32, 1234);
+    // payload and management container: extension bits, segmentationInfo present, messageRateRange absent
+    w.write(1, 0);
+    w.write(1, 0);
+    w.write(1, 1);
+    w.write(1, 0);
+    w.write(42, 123456789);
+    // reference position
+    w.write(31, 485000000 + 900000000);
+    w.write(32, 99000000 + 1800000000);
+    w.write(12, 100);
+    w.write(12, 50);
+    w.write(12, 3601);
+    w.write(20, 800001 + 100000);
+    w.write(4, 15);
+    // segment 2 of 3
+    w.write(3, 2);
+    w.write(3, 1);
+    // two containers
+    w.write(1, 0);
+    w.write(3, 1);
+    w.write(4, 5 - 1);
+    w.write(8, object_container.size());
+    object_container_offset = w.position();
+    for (auto byte : object_container)
+    {
+      w.write(8, byte);
+    }
+    w.write(4, 3 - 1);
+    w.write(8, sensor_container.size());
+    sensor_container_offset = w.position();
+    for (auto byte : sensor_container)
+    {
+      w.write(8, byte);
+    }
+  }
+
+  BitWriter w;
+  std::vector<uint8_t> object_container;
+  std::vector<uint8_t> sensor_container = { 0x12 };
+  size_t object_container_offset;
+  size_t sensor_container_offset;
+};
+
+// UPER encoding by asn1c, to check the reader against an independent encoder
+std::vector<uint8_t> encodeUper(const asn_TYPE_descriptor_t& type, const void* msg)
+{
+  std::vector<uint8_t> buffer(64 * 1024);
+  const auto ret = uper_encode_to_buffer(&type, nullptr, msg, buffer.data(), buffer.size());
+  EXPECT_GT(ret.encoded, 0) << type.name;
+  // asn1c returns the number of bits
+  buffer.resize(ret.encoded > 0 ? (ret.encoded + 7) / 8 : 0);
+  return buffer;
+}
+
+CollectivePerceptionMessage* decodeFull(const std::vector<uint8_t>& data)
+{
+  CollectivePerceptionMessage* msg = nullptr;
+  const auto ret = uper_decode_complete(
+      nullptr, &asn_DEF_CollectivePerceptionMessage, reinterpret_cast<void**>(&msg), data.data(), data.size());
+  EXPECT_EQ(ret.code, RC_OK);
+  return msg;
+}
+
+// CPM with both optional members of the management container and one container per given ID (1, 3 or 5). The first
+// perceived object of each PerceivedObjectContainer has an extension addition.
+CollectivePerceptionMessage& buildCPM(MessageBuilder<CollectivePerceptionMessage>& builder,
+                                      std::initializer_list<long> container_ids,
+                                      size_t num_objects = 3)
+{
+  auto& cpm = builder.reset();
+  cpm.header.protocolVersion = 2;
+  cpm.header.messageId = MessageId_cpm;
+  cpm.header.stationId = 1234;
+  auto& management = cpm.payload.managementContainer;
+  builder.setInteger(management.referenceTime, 600000000000);
+  setReferencePosition(management.referencePosition, 48.4, 10.0, 500.0);
+  auto& segmentation = builder.create(management.segmentationInfo);
+  segmentation.totalMsgNo = 3;
+  segmentation.thisMsgNo = 2;
+  auto& rate_range = builder.create(management.messageRateRange);
+  rate_range.messageRateMin.mantissa = 1;
+  rate_range.messageRateMax.mantissa = 10;
+  for (auto container_id : container_ids)
+  {
+    auto& container = builder.append(cpm.payload.cpmContainers.list);
+    container.containerId = container_id;
+    auto& data = container.containerData;
+    if (container_id == 1)
+    {
+      data.present = WrappedCpmContainer__containerData_PR_OriginatingVehicleContainer;
+      auto& vehicle = data.choice.OriginatingVehicleContainer;
+      vehicle.orientationAngle.value = 900;
+      vehicle.orientationAngle.confidence = Wgs84AngleConfidence_unavailable;
+      auto& pitch = builder.create(vehicle.pitchAngle);
+      pitch.value = 10;
+      pitch.confidence = AngleConfidence_unavailable;
+    }
+    else if (container_id == 3)
+    {
+      data.present = WrappedCpmContainer__containerData_PR_SensorInformationContainer;
+      auto& sensor = builder.append(data.choice.SensorInformationContainer.list);
+      sensor.sensorId = 1;
+      sensor.sensorType = SensorType_lidar;
+      sensor.shadowingApplies = 1;
+    }
+    else if (container_id == 5)
+    {
+      data.present = WrappedCpmContainer__containerData_PR_PerceivedObjectContainer;
+      auto& objects = data.choice.PerceivedObjectContainer;
+      objects.numberOfPerceivedObjects = static_cast<long>(std::min<size_t>(num_objects, 255));
+      for (size_t i = 0; i < num_objects; i++)
+      {
+        auto& obj = builder.append(objects.perceivedObjects.list);
+        builder.create(obj.objectId) = static_cast<long>(i);
+        obj.position.xCoordinate.value = static_cast<long>(i) * 100;
+        obj.position.xCoordinate.confidence = CoordinateConfidence_unavailable;
+        obj.position.yCoordinate.confidence = CoordinateConfidence_unavailable;
+        if (i == 0)
+        {
+          builder.create(obj.associatedStationID) = 42;
+        }
+      }
+    }
+  }
+  return cpm;
+}
+}  // namespace
+
+TEST(CpmDecoderTests, findsContainers)
+{
+  TestCPM cpm;
+  std::vector<EncodedCpmContainer> containers;
+  ASSERT_TRUE(findCpmContainers(cpm.w.data.data(), cpm.w.data.size(), containers));
+  ASSERT_EQ(containers.size(), 2);
+
+  ASSERT_EQ(containers[0].container_id, 5);
+  ASSERT_EQ(containers[0].bit_offset, cpm.object_container_offset);
+  ASSERT_EQ(readBytes(cpm.w.data, containers[0].bit_offset, containers[0].size), cpm.object_container);
+
+  ASSERT_EQ(containers[1].container_id, 3);
+  ASSERT_EQ(containers[1].bit_offset, cpm.sensor_container_offset);
+  ASSERT_EQ(readBytes(cpm.w.data, containers[1].bit_offset, containers[1].size), cpm.sensor_container);
+}
+
+TEST(CpmDecoderTests, rejectsTruncatedMessages)
+{
+  TestCPM cpm;
+  std::vector<EncodedCpmContainer> containers;
+  for (size_t size = 0; size < cpm.w.data.size(); size++)
+  {
+    ASSERT_FALSE(findCpmContainers(cpm.w.data.data(), size, containers));
+  }
+}
+
+TEST(CpmDecoderTests, countsPerceivedObjects)
+{
+  // PerceivedObjectContainer: no extensions, numberOfPerceivedObjects = 3, 7 objects in the list (dummy content)
+  BitWriter content;
+  content.write(1, 0);
+  content.write(8, 3);
+  content.write(1, 0);
+  content.write(8, 7);
+  content.write(16, 0xffff);
+  TestCPM cpm(content.data);
+  size_t count = 0;
+  ASSERT_TRUE(countCpmPerceivedObjects(cpm.w.data.data(), cpm.w.data.size(), count));
+  ASSERT_EQ(count, 7);
+  ASSERT_FALSE(countCpmPerceivedObjects(cpm.w.data.data(), cpm.w.data.size() - 1, count));
+}
+
+TEST(CpmDecoderTests, decodesManagementContainerOnly)
+{
+  TestCPM cpm;
+  CollectivePerceptionMessage* msg = nullptr;
+  std::vector<EncodedCpmContainer> skipped;
+  auto ret = decodeCPMSelective(&msg, cpm.w.data.data(), cpm.w.data.size(), 0, &skipped);
+  ASSERT_EQ(ret.code, RC_OK);
+  ASSERT_EQ(ret.consumed, cpm.w.data.size());
+
+  ASSERT_EQ(msg->header.protocolVersion, 2);
+  ASSERT_EQ(msg->header.messageId, 14);
+  ASSERT_EQ(msg->header.stationId, 1234);
+  const auto& mc = msg->payload.managementContainer;
+  uint64_t reference_time = 0;
+  ASSERT_EQ(asn_INTEGER2umax(&mc.referenceTime, &reference_time), 0);
+  ASSERT_EQ(reference_time, 123456789);
+  ASSERT_EQ(mc.referencePosition.latitude, 485000000);
+  ASSERT_EQ(mc.referencePosition.longitude, 99000000);
+  ASSERT_EQ(mc.referencePosition.positionConfidenceEllipse.semiMajorConfidence, 100);
+  ASSERT_EQ(mc.referencePosition.positionConfidenceEllipse.semiMinorConfidence, 50);
+  ASSERT_EQ(mc.referencePosition.positionConfidenceEllipse.semiMajorOrientation, 3601);
+  ASSERT_EQ(mc.referencePosition.altitude.altitudeValue, 800001);
+  ASSERT_EQ(mc.referencePosition.altitude.altitudeConfidence, 15);
+  ASSERT_NE(mc.segmentationInfo, nullptr);
+  ASSERT_EQ(mc.segmentationInfo->totalMsgNo, 3);
+  ASSERT_EQ(mc.segmentationInfo->thisMsgNo, 2);
+  ASSERT_EQ(mc.messageRateRange, nullptr);
+  ASSERT_EQ(msg->payload.cpmContainers.list.count, 0);
+
+  ASSERT_EQ(skipped.size(), 2);
+  ASSERT_EQ(skipped[0].container_id, 5);
+  ASSERT_EQ(skipped[1].container_id, 3);
+  ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+}
+
+TEST(CpmDecoderTests, findsContainersOfAsn1cEncoding)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  const auto& cpm = buildCPM(builder, { 1, 3, 5 });
+  const auto data = encodeUper(asn_DEF_CollectivePerceptionMessage, &cpm);
+
+  std::vector<EncodedCpmContainer> containers;
+  ASSERT_TRUE(findCpmContainers(data.data(), data.size(), containers));
+  ASSERT_EQ(containers.size(), 3);
+  for (size_t i = 0; i < containers.size(); i++)
+  {
+    const auto& expected = *cpm.payload.cpmContainers.list.array[i];
+    ASSERT_EQ(containers[i].container_id, expected.containerId);
+    WrappedCpmContainer* container = nullptr;
+    ASSERT_EQ(decodeCpmContainer(&container, data.data(), data.size(), containers[i]).code, RC_OK);
+    ASSERT_EQ(encodeUper(asn_DEF_WrappedCpmContainer, container), encodeUper(asn_DEF_WrappedCpmContainer, &expected));
+    ASN_STRUCT_FREE(asn_DEF_WrappedCpmContainer, container);
+  }
+
+  for (size_t size = 0; size < data.size(); size++)
+  {
+    ASSERT_FALSE(findCpmContainers(data.data(), size, containers)) << size;
+  }
+}
+
+TEST(CpmDecoderTests, countsPerceivedObjectsOfAsn1cEncoding)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  // 256 objects exceed the extensible size constraint of perceivedObjects, so the list size is an extension
+  for (size_t num_objects : { 0, 1, 255, 256 })
+  {
+    for (const auto& container_ids : { std::initializer_list<long>{ 5 }, std::initializer_list<long>{ 1, 5, 3, 5 } })
+    {
+      const auto data = encodeUper(asn_DEF_CollectivePerceptionMessage, &buildCPM(builder, container_ids, num_objects));
+      size_t count = 0;
+      ASSERT_TRUE(countCpmPerceivedObjects(data.data(), data.size(), count));
+      auto* msg = decodeFull(data);
+      ASSERT_NE(msg, nullptr);
+      ASSERT_EQ(count, countElements(*msg)) << num_objects;
+      ASSERT_EQ(count, num_objects * (container_ids.size() == 1 ? 1 : 2));
+      ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+    }
+  }
+}
+
+TEST(CpmDecoderTests, selectiveDecodingMatchesFullDecoding)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  const auto data = encodeUper(asn_DEF_CollectivePerceptionMessage, &buildCPM(builder, { 1, 3, 5 }));
+  auto* full = decodeFull(data);
+  ASSERT_NE(full, nullptr);
+  const auto& full_containers = full->payload.cpmContainers.list;
+
+  for (uint32_t mask : { 0u, cpmContainerMask({ 5 }), cpmContainerMask({ 1, 3 }), cpmContainerMask({ 1, 3, 5 }) })
+  {
+    CollectivePerceptionMessage* msg = nullptr;
+    std::vector<EncodedCpmContainer> skipped;
+    const auto ret = decodeCPMSelective(&msg, data.data(), data.size(), mask, &skipped);
+    ASSERT_EQ(ret.code, RC_OK) << mask;
+    ASSERT_EQ(ret.consumed, data.size());
+    ASSERT_EQ(msg->header.protocolVersion, full->header.protocolVersion);
+    ASSERT_EQ(msg->header.messageId, full->header.messageId);
+    ASSERT_EQ(msg->header.stationId, full->header.stationId);
+    ASSERT_EQ(encodeUper(asn_DEF_ManagementContainer, &msg->payload.managementContainer),
+              encodeUper(asn_DEF_ManagementContainer, &full->payload.managementContainer));
+
+    // selected containers are decoded in order, the others can be decoded later
+    size_t num_decoded = 0;
+    size_t num_skipped = 0;
+    for (int i = 0; i < full_containers.count; i++)
+    {
+      const auto& expected = *full_containers.array[i];
+      const auto expected_encoding = encodeUper(asn_DEF_WrappedCpmContainer, &expected);
+      if ((mask & (1u << expected.containerId)) != 0)
+      {
+        ASSERT_LT(num_decoded, static_cast<size_t>(msg->payload.cpmContainers.list.count));
+        const auto* container = msg->payload.cpmContainers.list.array[num_decoded++];
+        ASSERT_EQ(encodeUper(asn_DEF_WrappedCpmContainer, container), expected_encoding);
+        continue;
+      }
+      ASSERT_LT(num_skipped, skipped.size());
+      const auto& encoded = skipped[num_skipped++];
+      ASSERT_EQ(encoded.container_id, expected.containerId);
+      WrappedCpmContainer* container = nullptr;
+      ASSERT_EQ(decodeCpmContainer(&container, data.data(), data.size(), encoded).code, RC_OK);
+      ASSERT_EQ(encodeUper(asn_DEF_WrappedCpmContainer, container), expected_encoding);
+      ASN_STRUCT_FREE(asn_DEF_WrappedCpmContainer, container);
+    }
+    ASSERT_EQ(num_decoded, static_cast<size_t>(msg->payload.cpmContainers.list.count));
+    ASSERT_EQ(num_skipped, skipped.size());
+    ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+  }
+  ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, full);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
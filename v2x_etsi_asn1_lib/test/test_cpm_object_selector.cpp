@@ -0,0 +1,109 @@
+#include <v2x_etsi_asn1_lib/cpm_object_selector.h>
+#include <gtest/gtest.h>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+using Clock = CpmObjectSelector::Clock;
+
+namespace
+{
+// Object moving along x with the given speed (cm/s), positions in cm
+struct TestObject
+{
+  TestObject(long id, long speed)
+  {
+    obj.objectId = &object_id;
+    object_id = id;
+    obj.velocity = &velocity;
+    velocity.present = Velocity3dWithConfidence_PR_polarVelocity;
+    velocity.choice.polarVelocity.velocityMagnitude.speedValue = speed;
+    velocity.choice.polarVelocity.velocityDirection.value = 0;
+  }
+
+  PerceivedObject obj{};
+  Identifier2B_t object_id{};
+  Velocity3dWithConfidence_t velocity{};
+};
+}  // namespace
+
+TEST(CpmObjectSelectorTests, includesObjectsOnChanges)
+{
+  CpmObjectSelector selector;
+  TestObject standing(1, 0);
+  TestObject moving(2, 1000);
+  const std::vector<const PerceivedObject*> objects{ &standing.obj, &moving.obj };
+  const auto start = Clock::time_point{};
+
+  // new objects are always included
+  ASSERT_EQ(selector.select(objects, start).size(), 2);
+
+  // after 100 ms, the moving object is 1 m further, nothing changed enough
+  moving.obj.position.xCoordinate.value += 100;
+  ASSERT_TRUE(selector.select(objects, start + 100ms).empty());
+
+  // after 500 ms, the moving object is 5 m further
+  moving.obj.position.xCoordinate.value += 400;
+  auto selected = selector.select(objects, start + 500ms);
+  ASSERT_EQ(selected.size(), 1);
+  ASSERT_EQ(selected[0], &moving.obj);
+
+  // speed and direction changes
+  moving.velocity.choice.polarVelocity.velocityMagnitude.speedValue += 60;
+  ASSERT_EQ(selector.select(objects, start + 600ms).size(), 1);
+  moving.velocity.choice.polarVelocity.velocityDirection.value = 3550;
+  ASSERT_EQ(selector.select(objects, start + 700ms).size(), 1);
+  // the direction of a standing object is ignored
+  standing.velocity.choice.polarVelocity.velocityDirection.value = 900;
+  ASSERT_TRUE(selector.select(objects, start + 800ms).empty());
+
+  // the standing object is sent again after 1 s
+  selected = selector.select(objects, start + 1000ms);
+  ASSERT_EQ(selected.size(), 1);
+  ASSERT_EQ(selected[0], &standing.obj);
+}
+
+TEST(CpmObjectSelectorTests, forgetsObjectsWhichAreNoLongerTracked)
+{
+  CpmObjectSelector selector;
+  TestObject a(1, 0);
+  TestObject b(2, 0);
+  const auto start = Clock::time_point{};
+  ASSERT_EQ(selector.select({ &a.obj, &b.obj }, start).size(), 2);
+  ASSERT_TRUE(selector.select({ &a.obj }, start + 100ms).empty());
+  auto selected = selector.select({ &a.obj, &b.obj }, start + 200ms);
+  ASSERT_EQ(selected.size(), 1);
+  ASSERT_EQ(selected[0], &b.obj);
+}
+
+TEST(CpmObjectSelectorTests, skipsYoungObjects)
+{
+  CpmObjectRules rules;
+  rules.min_object_age = 300ms;
+  CpmObjectSelector selector(rules);
+  TestObject obj(1, 0);
+  DeltaTimeMilliSecondSigned_t age = 100;
+  obj.obj.objectAge = &age;
+  ASSERT_TRUE(selector.select({ &obj.obj }).empty());
+  age = 300;
+  ASSERT_EQ(selector.select({ &obj.obj }).size(), 1);
+}
+
+TEST(CpmObjectSelectorTests, skipsObjectsAnnouncingThemselves)
+{
+  auto stations = std::make_shared<StationTable>(16, 1s);
+  CpmObjectSelector selector({}, stations);
+  TestObject obj(1, 0);
+  StationId_t station_id = 42;
+  obj.obj.associatedStationID = &station_id;
+
+  ASSERT_EQ(selector.select({ &obj.obj }).size(), 1);
+  ASSERT_EQ(selector.numRedundant(), 0);
+
+  StationState state;
+  state.station_id = 42;
+  ASSERT_TRUE(stations->update(state));
+  ASSERT_TRUE(selector.select({ &obj.obj }).empty());
+  ASSERT_EQ(selector.numRedundant(), 1);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,113 @@
+#include <v2x_etsi_asn1_lib/cpm_segmenter.h>
+#include <gtest/gtest.h>
+#include "test_messages.h"
+
+#include <set>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using test::TestCPM;
+using test::TestObjects;
+
+namespace
+{
+constexpr uint64_t reference_time = 600000000000;
+
+CollectivePerceptionMessage* decode(const std::vector<uint8_t>& segment)
+{
+  CollectivePerceptionMessage* msg = nullptr;
+  auto ret = uper_decode_complete(
+      nullptr, &asn_DEF_CollectivePerceptionMessage, reinterpret_cast<void**>(&msg), segment.data(), segment.size());
+  EXPECT_EQ(ret.code, RC_OK);
+  return msg;
+}
+}  // namespace
+
+TEST(CpmSegmenterTests, singleSegmentHasNoSegmentationInfo)
+{
+  TestCPM cpm;
+  TestObjects objects(3);
+  SegmentedCPM result;
+  ASSERT_TRUE(encodeSegmentedCPM(*cpm.msg, objects.objects, 1000, result));
+  ASSERT_EQ(result.segments.size(), 1);
+  ASSERT_TRUE(result.omitted_objects.empty());
+
+  auto* msg = decode(result.segments[0]);
+  ASSERT_NE(msg, nullptr);
+  ASSERT_EQ(msg->payload.managementContainer.segmentationInfo, nullptr);
+  ASSERT_EQ(msg->payload.cpmContainers.list.count, 1);
+  const auto& container = msg->payload.cpmContainers.list.array[0]->containerData.choice.PerceivedObjectContainer;
+  ASSERT_EQ(container.numberOfPerceivedObjects, 3);
+  ASSERT_EQ(container.perceivedObjects.list.count, 3);
+  ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+}
+
+TEST(CpmSegmenterTests, splitsObjectsIntoSegments)
+{
+  TestCPM cpm;
+  TestObjects objects(60);
+  const size_t max_size = 200;
+  SegmentedCPM result;
+  ASSERT_TRUE(encodeSegmentedCPM(*cpm.msg, objects.objects, max_size, result));
+  ASSERT_GT(result.segments.size(), 1);
+  ASSERT_LE(result.segments.size(), max_cpm_segments);
+  ASSERT_TRUE(result.omitted_objects.empty());
+
+  std::set<long> object_ids;
+  for (size_t i = 0; i < result.segments.size(); i++)
+  {
+    ASSERT_LE(result.segments[i].size(), max_size);
+    auto* msg = decode(result.segments[i]);
+    ASSERT_NE(msg, nullptr);
+    const auto& mc = msg->payload.managementContainer;
+    uint64_t time = 0;
+    ASSERT_EQ(asn_INTEGER2umax(&mc.referenceTime, &time), 0);
+    ASSERT_EQ(time, reference_time);
+    ASSERT_NE(mc.segmentationInfo, nullptr);
+    ASSERT_EQ(mc.segmentationInfo->totalMsgNo, result.segments.size());
+    ASSERT_EQ(mc.segmentationInfo->thisMsgNo, i + 1);
+
+    ASSERT_EQ(msg->payload.cpmContainers.list.count, 1);
+    const auto& container = msg->payload.cpmContainers.list.array[0]->containerData.choice.PerceivedObjectContainer;
+    ASSERT_EQ(container.numberOfPerceivedObjects, 60);
+    for (int j = 0; j < container.perceivedObjects.list.count; j++)
+    {
+      ASSERT_TRUE(object_ids.insert(*container.perceivedObjects.list.array[j]->objectId).second);
+    }
+    ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+  }
+  ASSERT_EQ(object_ids.size(), 60);
+}
+
+TEST(CpmSegmenterTests, omitsObjectsBeyondMaximumNumberOfSegments)
+{
+  TestCPM cpm;
+  TestObjects objects(500);
+  SegmentedCPM result;
+  ASSERT_TRUE(encodeSegmentedCPM(*cpm.msg, objects.objects, 100, result));
+  ASSERT_EQ(result.segments.size(), max_cpm_segments);
+  ASSERT_FALSE(result.omitted_objects.empty());
+
+  size_t num_included = 0;
+  for (const auto& segment : result.segments)
+  {
+    ASSERT_LE(segment.size(), 100);
+    auto* msg = decode(segment);
+    ASSERT_NE(msg, nullptr);
+    num_included +=
+        msg->payload.cpmContainers.list.array[0]->containerData.choice.PerceivedObjectContainer.perceivedObjects.list
+            .count;
+    ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+  }
+  ASSERT_EQ(num_included + result.omitted_objects.size(), 500);
+}
+
+TEST(CpmSegmenterTests, rejectsTooSmallSegments)
+{
+  TestCPM cpm;
+  TestObjects objects(1);
+  SegmentedCPM result;
+  ASSERT_FALSE(encodeSegmentedCPM(*cpm.msg, objects.objects, 10, result));
+  ASSERT_TRUE(result.segments.empty());
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
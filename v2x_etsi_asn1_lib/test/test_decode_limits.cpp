@@ -0,0 +1,156 @@
+#include <v2x_etsi_asn1_lib/decode_limits.h>
+#include <v2x_etsi_asn1_lib/cpm_decoder.h>
+#include <v2x_etsi_asn1_lib/loopback_transport.h>
+#include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+#include <gtest/gtest.h>
+#include "test_messages.h"
+
+#include <atomic>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+using test::encodeTestCPM;
+
+namespace
+{
+DecodeLimitResult decodeCPM(const std::vector<uint8_t>& data,
+                            const DecodeLimits& limits,
+                            std::optional<uint32_t> cpm_container_mask = {})
+{
+  void* msg = nullptr;
+  const auto result = decodeETSIMsgLimited(&asn_DEF_CollectivePerceptionMessage,
+                                           WireEncoding::UPER,
+                                           &msg,
+                                           data.data(),
+                                           data.size(),
+                                           limits,
+                                           cpm_container_mask);
+  ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+  return result;
+}
+
+struct TestTransceiver : ETSIAMQPTransceiverBase
+{
+  using ETSIAMQPTransceiverBase::findHandler;
+
+  void handleCPM(const std::shared_ptr<const CollectivePerceptionMessage>& /*msg*/,
+                 const BinaryETSIMessage& /*msg_bin*/) override
+  {
+    num_cpms++;
+  }
+
+  std::atomic<int> num_cpms = 0;
+};
+}  // namespace
+
+TEST(DecodeLimitsTests, decodesWithinLimits)
+{
+  const auto data = encodeTestCPM(20);
+  ASSERT_EQ(decodeCPM(data, defaultDecodeLimits(ETSIMessageType::CPM)), DecodeLimitResult::Ok);
+  ASSERT_EQ(decodeCPM(data, {}), DecodeLimitResult::Ok);
+}
+
+TEST(DecodeLimitsTests, rejectsLargeMessages)
+{
+  const auto data = encodeTestCPM(20);
+  DecodeLimits limits;
+  limits.max_size = data.size() - 1;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::TooLarge);
+}
+
+TEST(DecodeLimitsTests, rejectsTooManyElements)
+{
+  const auto data = encodeTestCPM(20);
+  DecodeLimits limits;
+  limits.max_elements = 20;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::Ok);
+  limits.max_elements = 19;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::TooManyElements);
+  // UPER encoded CPMs are rejected before decoding, which would exceed this budget with its first allocation
+  limits.max_allocation = 1;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::TooManyElements);
+  ASSERT_EQ(decodeCPM(data, limits, cpmContainerMask({ 5 })), DecodeLimitResult::TooManyElements);
+  limits.max_elements = 20;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::AllocationExceeded);
+}
+
+TEST(DecodeLimitsTests, boundsStackUsage)
+{
+  const auto data = encodeTestCPM(20);
+  DecodeLimits limits;
+  limits.max_stack_size = 64 * 1024;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::Ok);
+  ASSERT_EQ(decodeCPM(data, limits, cpmContainerMask({ 5 })), DecodeLimitResult::Ok);
+  // too small for the nested decoders of the perceived objects, also when only decoding selected containers
+  limits.max_stack_size = 1;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::DecodingFailed);
+  ASSERT_EQ(decodeCPM(data, limits, cpmContainerMask({ 5 })), DecodeLimitResult::DecodingFailed);
+  // the management container is decoded without asn1c
+  ASSERT_EQ(decodeCPM(data, limits, 0), DecodeLimitResult::Ok);
+}
+
+TEST(DecodeLimitsTests, rejectsExceededAllocations)
+{
+  const auto data = encodeTestCPM(100);
+  DecodeLimits limits;
+  limits.max_allocation = 1000;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::AllocationExceeded);
+  // the budget only applies within decodeETSIMsgLimited()
+  limits.max_allocation = 0;
+  ASSERT_EQ(decodeCPM(data, limits), DecodeLimitResult::Ok);
+}
+
+TEST(DecodeLimitsTests, countsRejectedMessagesOfTransceiver)
+{
+  auto bus = LoopbackBus::create();
+  TestTransceiver sender;
+  TestTransceiver receiver;
+  DecodeLimits limits = defaultDecodeLimits(ETSIMessageType::CPM);
+  limits.max_elements = 10;
+  ASSERT_TRUE(receiver.setDecodeLimits(ETSIMessageType::CPM, limits));
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  for (size_t num_objects : { 5, 20, 10, 11 })
+  {
+    const auto data = encodeTestCPM(num_objects);
+    ASSERT_TRUE(sender.sendEncodedETSIMsg(
+        reinterpret_cast<const char*>(data.data()), data.size(), ETSIMessageType::CPM));
+  }
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+  ASSERT_EQ(receiver.num_cpms, 2);
+  ASSERT_EQ(receiver.numRejectedMessages(), 2);
+}
+
+TEST(DecodeLimitsTests, ignoresLimitsOfUnknownMessageTypes)
+{
+  TestTransceiver transceiver;
+  const auto unknown_type = static_cast<ETSIMessageType>(4096);
+  ASSERT_FALSE(transceiver.setDecodeLimits(unknown_type, DecodeLimits()));
+  ASSERT_FALSE(transceiver.setSendPriority(unknown_type, SendPriority::High));
+  ASSERT_EQ(transceiver.findHandler(unknown_type), nullptr);
+
+  const auto unlisted_type = static_cast<ETSIMessageType>(ETSIMessageType::DENM + 10);
+  ASSERT_FALSE(transceiver.setDecodeLimits(unlisted_type, DecodeLimits()));
+  ASSERT_TRUE(transceiver.findHandler(unlisted_type)->subject.empty());
+}
+
+TEST(DecodeLimitsTests, countsTrajectoryPoints)
+{
+  MCM msg{};
+  ASSERT_EQ(countElements(msg), 0);
+  msg.mcm.mcmParameters.maneuverContainer.present = ManeuverContainer_PR_roadUserContainer;
+  PlannedTrajectory_t trajectory{};
+  std::vector<TrajectoryPoint_t> points(5);
+  std::vector<TrajectoryPoint_t*> point_ptrs;
+  for (auto& point : points)
+  {
+    point_ptrs.push_back(&point);
+  }
+  trajectory.trajectoryPointContainer.list.array = point_ptrs.data();
+  trajectory.trajectoryPointContainer.list.count = static_cast<int>(point_ptrs.size());
+  msg.mcm.mcmParameters.maneuverContainer.choice.roadUserContainer.plannedTrajectory = &trajectory;
+  ASSERT_EQ(countElements(msg), 5);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
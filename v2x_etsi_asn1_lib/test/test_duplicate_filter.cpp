@@ -0,0 +1,48 @@
+#include <v2x_etsi_asn1_lib/duplicate_filter.h>
+#include <gtest/gtest.h>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+TEST(DuplicateFilterTests, detectsDuplicatesWithinWindow)
+{
+  DuplicateFilter filter(1000ms, 16);
+  std::vector<uint8_t> payload = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+  DuplicateFilter::Clock::time_point t{ 100s };
+
+  ASSERT_FALSE(filter.isDuplicate(2050, 42, payload.data(), payload.size(), t));
+  ASSERT_TRUE(filter.isDuplicate(2050, 42, payload.data(), payload.size(), t + 10ms));
+  ASSERT_TRUE(filter.isDuplicate(2050, 42, payload.data(), payload.size(), t + 900ms));
+  ASSERT_EQ(filter.numDuplicates(), 2);
+
+  // different station, message type or payload
+  ASSERT_FALSE(filter.isDuplicate(2050, 43, payload.data(), payload.size(), t + 10ms));
+  ASSERT_FALSE(filter.isDuplicate(2049, 42, payload.data(), payload.size(), t + 10ms));
+  payload.back()++;
+  ASSERT_FALSE(filter.isDuplicate(2050, 42, payload.data(), payload.size(), t + 10ms));
+}
+
+TEST(DuplicateFilterTests, forgetsMessagesAfterWindow)
+{
+  DuplicateFilter filter(1000ms, 16);
+  std::vector<uint8_t> payload = { 1, 2, 3 };
+  DuplicateFilter::Clock::time_point t{ 100s };
+
+  ASSERT_FALSE(filter.isDuplicate(2050, 42, payload.data(), payload.size(), t));
+  ASSERT_FALSE(filter.isDuplicate(2050, 42, payload.data(), payload.size(), t + 1500ms));
+}
+
+TEST(DuplicateFilterTests, boundedCapacity)
+{
+  DuplicateFilter filter(1000ms, 8);
+  DuplicateFilter::Clock::time_point t{ 100s };
+  for (uint32_t i = 0; i < 100; i++)
+  {
+    ASSERT_FALSE(filter.isDuplicate(2050, i, nullptr, 0, t));
+  }
+  ASSERT_GT(filter.numOverflows(), 0);
+  ASSERT_TRUE(filter.isDuplicate(2050, 0, nullptr, 0, t));
+}
+
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,116 @@
+#include <v2x_etsi_asn1_lib/generation_manager.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+using Clock = GenerationManager::Clock;
+
+TEST(GenerationManagerTests, stationaryVehicleSendsAtMaxInterval)
+{
+  GenerationManager manager(GenerationRules::cam());
+  const GenerationState state{ 48.4, 9.9, 90.0, 0.0 };
+  const auto start = Clock::time_point{};
+  size_t num_sent = 0;
+  for (auto t = 0ms; t < 10s; t += 100ms)
+  {
+    num_sent += manager.check(state, start + t).send;
+  }
+  ASSERT_EQ(num_sent, 10);
+}
+
+TEST(GenerationManagerTests, firstMessageHasLowFrequencyContainer)
+{
+  GenerationManager manager(GenerationRules::cam());
+  const GenerationState state{ 48.4, 9.9, 90.0, 0.0 };
+  const auto start = Clock::time_point{};
+  auto decision = manager.check(state, start);
+  ASSERT_TRUE(decision.send);
+  ASSERT_TRUE(decision.include_low_frequency_container);
+  ASSERT_FALSE(manager.check(state, start + 100ms).send);
+
+  decision = manager.check(state, start + 1s);
+  ASSERT_TRUE(decision.send);
+  ASSERT_TRUE(decision.include_low_frequency_container);
+
+  manager.reset();
+  decision = manager.check(state, start + 1100ms);
+  ASSERT_TRUE(decision.send);
+  ASSERT_TRUE(decision.include_low_frequency_container);
+}
+
+TEST(GenerationManagerTests, triggersOnDynamics)
+{
+  const auto start = Clock::time_point{};
+  const GenerationState state{ 48.4, 9.9, 90.0, 10.0 };
+
+  GenerationManager manager(GenerationRules::cam());
+  ASSERT_TRUE(manager.check(state, start).send);
+
+  // not before T_GenCamMin
+  auto turned = state;
+  turned.heading += 5.0;
+  ASSERT_FALSE(manager.check(turned, start + 50ms).send);
+  ASSERT_TRUE(manager.check(turned, start + 100ms).send);
+
+  auto accelerated = turned;
+  accelerated.speed += 0.6;
+  ASSERT_TRUE(manager.check(accelerated, start + 200ms).send);
+
+  // 1e-4 degrees of latitude are about 11 m
+  auto moved = accelerated;
+  moved.latitude += 1e-4;
+  ASSERT_TRUE(manager.check(moved, start + 300ms).send);
+
+  // heading wraps around north
+  GenerationManager north(GenerationRules::cam());
+  GenerationState heading{ 48.4, 9.9, 359.0, 0.0 };
+  ASSERT_TRUE(north.check(heading, start).send);
+  heading.heading = 2.0;
+  ASSERT_FALSE(north.check(heading, start + 100ms).send);
+  heading.heading = NAN;
+  ASSERT_FALSE(north.check(heading, start + 200ms).send);
+}
+
+TEST(GenerationManagerTests, keepsTriggeredIntervalForConsecutiveMessages)
+{
+  GenerationManager manager(GenerationRules::cam());
+  const auto start = Clock::time_point{};
+  GenerationState state{ 48.4, 9.9, 90.0, 10.0 };
+  ASSERT_TRUE(manager.check(state, start).send);
+  state.speed += 1.0;
+  ASSERT_TRUE(manager.check(state, start + 300ms).send);
+  ASSERT_EQ(manager.interval(), 300ms);
+
+  // the vehicle keeps its speed, three messages are sent at the triggered interval, then T_GenCamMax applies
+  auto t = start + 300ms;
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_FALSE(manager.check(state, t + 200ms).send);
+    t += 300ms;
+    ASSERT_TRUE(manager.check(state, t).send);
+  }
+  ASSERT_EQ(manager.interval(), 1000ms);
+  ASSERT_FALSE(manager.check(state, t + 900ms).send);
+  ASSERT_TRUE(manager.check(state, t + 1000ms).send);
+}
+
+TEST(GenerationManagerTests, vamUsesMaxIntervalAfterTrigger)
+{
+  GenerationManager manager(GenerationRules::vam());
+  const auto start = Clock::time_point{};
+  GenerationState state{ 48.4, 9.9, 90.0, 1.0 };
+  ASSERT_TRUE(manager.check(state, start).send);
+  state.speed += 1.0;
+  auto decision = manager.check(state, start + 300ms);
+  ASSERT_TRUE(decision.send);
+  ASSERT_FALSE(decision.include_low_frequency_container);
+  ASSERT_EQ(manager.interval(), 5000ms);
+  ASSERT_FALSE(manager.check(state, start + 5200ms).send);
+  decision = manager.check(state, start + 5300ms);
+  ASSERT_TRUE(decision.send);
+  ASSERT_TRUE(decision.include_low_frequency_container);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
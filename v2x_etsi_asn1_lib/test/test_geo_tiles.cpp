@@ -0,0 +1,67 @@
+#include <v2x_etsi_asn1_lib/geo_tiles.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+TEST(GeoTilesTests, computesQuadkeys)
+{
+  // tile x = 3, y = 5 at zoom level 3
+  EXPECT_EQ(quadkey(-55.0, -22.5, 3), "213");
+  EXPECT_EQ(quadkey(0.1, 0.1, 1), "1");
+  EXPECT_EQ(quadkey(-0.1, -0.1, 1), "2");
+  EXPECT_EQ(quadkey(89.0, -179.9, 4), "0000");
+  EXPECT_EQ(quadkey(48.4, 9.99, 30).size(), max_quadkey_zoom);
+  EXPECT_EQ(quadkeyProperty(14), "qk14");
+
+  const auto key = quadkey(48.4, 9.99, 16);
+  for (unsigned zoom = 1; zoom < 16; zoom++)
+  {
+    EXPECT_EQ(quadkey(48.4, 9.99, zoom), key.substr(0, zoom));
+  }
+}
+
+TEST(GeoTilesTests, findsTilesInArea)
+{
+  const auto single = quadkeysInArea(48.4, 9.99, 0.0, 14);
+  ASSERT_EQ(single.size(), 1);
+  EXPECT_EQ(single[0], quadkey(48.4, 9.99, 14));
+
+  // tiles at zoom 14 are about 1.6 km wide at this latitude
+  const auto keys = quadkeysInArea(48.4, 9.99, 2000.0, 14);
+  EXPECT_GE(keys.size(), 9);
+  EXPECT_LE(keys.size(), 16);
+  for (const double offset : { -0.015, 0.0, 0.015 })
+  {
+    EXPECT_NE(std::find(keys.begin(), keys.end(), quadkey(48.4 + offset, 9.99 + offset, 14)), keys.end());
+  }
+}
+
+TEST(GeoTilesTests, wrapsLongitudes)
+{
+  EXPECT_EQ(quadkey(48.4, 9.99 + 360.0, 14), quadkey(48.4, 9.99, 14));
+  EXPECT_EQ(quadkey(48.4, 9.99 - 720.0, 14), quadkey(48.4, 9.99, 14));
+  EXPECT_EQ(quadkey(0.1, 180.1, 10), quadkey(0.1, -179.9, 10));
+  // 180 degrees are in the last tile, like in the Bing Maps tile system
+  EXPECT_EQ(quadkey(0.1, 180.0, 4), quadkey(0.1, 179.9, 4));
+
+  // about 20 m on each side of the antimeridian
+  const auto keys = quadkeysInArea(0.1, 179.9999, 50.0, 14);
+  EXPECT_EQ(keys.size(), 2);
+  for (const double longitude : { 179.9999, -179.9999 })
+  {
+    EXPECT_NE(std::find(keys.begin(), keys.end(), quadkey(0.1, longitude, 14)), keys.end()) << longitude;
+  }
+}
+
+TEST(GeoTilesTests, buildsSelectors)
+{
+  EXPECT_EQ(quadkeySelector(-55.0, -22.5, 0.0, 3), "qk3 IN ('213')");
+  const auto selector = quadkeySelector(48.4, 9.99, 2000.0, 14);
+  EXPECT_EQ(selector.rfind("qk14 IN ('", 0), 0);
+  EXPECT_EQ(selector.back(), ')');
+  EXPECT_EQ(static_cast<size_t>(std::count(selector.begin(), selector.end(), '\'')),
+            2 * quadkeysInArea(48.4, 9.99, 2000.0, 14).size());
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
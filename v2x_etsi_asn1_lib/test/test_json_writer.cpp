@@ -0,0 +1,238 @@
+#include <v2x_etsi_asn1_lib/json_writer.h>
+#include <gtest/gtest.h>
+#include "test_messages.h"
+
+#include <IA5String.h>
+
+#include <string>
+#include <string_view>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+namespace
+{
+// Checks that every line holds a JSON value with balanced brackets outside of strings and without trailing commas
+bool isWellFormed(std::string_view json)
+{
+  std::string open;
+  bool in_string = false;
+  char previous = '\n';
+  for (size_t i = 0; i < json.size(); i++)
+  {
+    const char c = json[i];
+    if (in_string)
+    {
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        return false;
+      }
+      if (c == '\\')
+      {
+        i++;
+      }
+      else if (c == '"')
+      {
+        in_string = false;
+      }
+      continue;
+    }
+    switch (c)
+    {
+      case '"':
+        in_string = true;
+        break;
+      case '{':
+      case '[':
+        open += c;
+        break;
+      case '}':
+      case ']':
+        if (open.empty() || open.back() != (c == '}' ? '{' : '[') || previous == ',')
+        {
+          return false;
+        }
+        open.pop_back();
+        break;
+      case ',':
+        if (previous == ',' || previous == '{' || previous == '[')
+        {
+          return false;
+        }
+        break;
+      case '\n':
+        if (!open.empty() || previous == '\n')
+        {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+    previous = c;
+  }
+  return !in_string && previous == '\n';
+}
+
+// CPM with a latitude and an unavailable longitude
+struct TestPositionCPM : test::TestCPM
+{
+  TestPositionCPM() : TestCPM(600000001234)
+  {
+    msg->payload.managementContainer.referencePosition.latitude = 484000000;
+    msg->payload.managementContainer.referencePosition.longitude = Longitude_unavailable;
+  }
+};
+}  // namespace
+
+TEST(JsonWriterTests, writesRawValues)
+{
+  TestPositionCPM cpm;
+  JsonWriter writer;
+  ASSERT_TRUE(writer.write(asn_DEF_CollectivePerceptionMessage, cpm.msg));
+  const std::string json(writer.buffer());
+  EXPECT_NE(json.find("\"header\":{\"protocolVersion\":2,\"messageId\":14,\"stationId\":1234}"), std::string::npos);
+  EXPECT_NE(json.find("\"referenceTime\":600000001234"), std::string::npos);
+  EXPECT_NE(json.find("\"latitude\":484000000"), std::string::npos);
+  EXPECT_NE(json.find("\"longitude\":1800000001"), std::string::npos);
+  EXPECT_EQ(json.back(), '\n');
+  EXPECT_EQ(json.find('\n'), json.size() - 1);
+  EXPECT_TRUE(isWellFormed(json));
+}
+
+TEST(JsonWriterTests, writesSIUnits)
+{
+  TestPositionCPM cpm;
+  JsonWriter writer(true);
+  ASSERT_TRUE(writer.write(asn_DEF_CollectivePerceptionMessage, cpm.msg));
+  const std::string json(writer.buffer());
+  EXPECT_NE(json.find("\"referenceTime\":600000001.234"), std::string::npos);
+  EXPECT_NE(json.find("\"latitude\":48.4"), std::string::npos);
+  EXPECT_NE(json.find("\"longitude\":\"unavailable\""), std::string::npos);
+  EXPECT_TRUE(isWellFormed(json));
+}
+
+TEST(JsonWriterTests, appendsMessages)
+{
+  TestPositionCPM cpm;
+  JsonWriter writer;
+  ASSERT_TRUE(writer.write(asn_DEF_CollectivePerceptionMessage, cpm.msg));
+  const auto size = writer.buffer().size();
+  ASSERT_TRUE(writer.write(asn_DEF_CollectivePerceptionMessage, cpm.msg));
+  EXPECT_EQ(writer.buffer().size(), 2 * size);
+  EXPECT_EQ(writer.buffer().substr(0, size), writer.buffer().substr(size));
+  EXPECT_TRUE(isWellFormed(writer.buffer()));
+  writer.clear();
+  EXPECT_TRUE(writer.buffer().empty());
+}
+
+TEST(JsonWriterTests, writesCAMContainers)
+{
+  MessageBuilder<CAM> builder;
+  test::buildCAM(builder, 7, 12.5);
+  auto& params = builder.get()->cam.camParameters;
+  auto& lf = builder.create(params.lowFrequencyContainer);
+  lf.present = LowFrequencyContainer_PR_basicVehicleContainerLowFrequency;
+  lf.choice.basicVehicleContainerLowFrequency.vehicleRole = VehicleRole_publicTransport;
+  // low beam headlights and left turn signal on, empty path history
+  const uint8_t lights = 0xa0;
+  builder.setBits(lf.choice.basicVehicleContainerLowFrequency.exteriorLights, &lights, 8);
+  auto& special = builder.create(params.specialVehicleContainer);
+  special.present = SpecialVehicleContainer_PR_publicTransportContainer;
+  special.choice.publicTransportContainer.embarkationStatus = true;
+  auto& activation = builder.create(special.choice.publicTransportContainer.ptActivation);
+  activation.ptActivationType = 1;
+  const uint8_t data[] = { 0x0a, 0xff };
+  builder.setOctets(activation.ptActivationData, data, sizeof(data));
+
+  JsonWriter writer;
+  ASSERT_TRUE(writer.write(asn_DEF_CAM, builder.get()));
+  EXPECT_EQ(writer.buffer(),
+            "{\"header\":{\"protocolVersion\":2,\"messageId\":2,\"stationId\":7},"
+            "\"cam\":{\"generationDeltaTime\":1234,\"camParameters\":{"
+            "\"basicContainer\":{\"stationType\":5,"
+            "\"referencePosition\":{\"latitude\":484000000,\"longitude\":100000000,"
+            "\"positionConfidenceEllipse\":{\"semiMajorAxisLength\":4095,\"semiMinorAxisLength\":4095,"
+            "\"semiMajorAxisOrientation\":3601},"
+            "\"altitude\":{\"altitudeValue\":50000,\"altitudeConfidence\":\"unavailable\"}}},"
+            "\"highFrequencyContainer\":{\"basicVehicleContainerHighFrequency\":{"
+            "\"heading\":{\"headingValue\":900,\"headingConfidence\":20},"
+            "\"speed\":{\"speedValue\":1250,\"speedConfidence\":20},"
+            "\"driveDirection\":\"forward\","
+            "\"vehicleLength\":{\"vehicleLengthValue\":1023,\"vehicleLengthConfidenceIndication\":\"unavailable\"},"
+            "\"vehicleWidth\":62,\"longitudinalAcceleration\":{\"value\":161,\"confidence\":102},"
+            "\"curvature\":{\"curvatureValue\":1023,\"curvatureConfidence\":\"unavailable\"},"
+            "\"curvatureCalculationMode\":\"unavailable\","
+            "\"yawRate\":{\"yawRateValue\":32767,\"yawRateConfidence\":\"unavailable\"}}},"
+            "\"lowFrequencyContainer\":{\"basicVehicleContainerLowFrequency\":{"
+            "\"vehicleRole\":\"publicTransport\",\"exteriorLights\":\"10100000\",\"pathHistory\":[]}},"
+            "\"specialVehicleContainer\":{\"publicTransportContainer\":{"
+            "\"embarkationStatus\":true,"
+            "\"ptActivation\":{\"ptActivationType\":1,\"ptActivationData\":\"0aff\"}}}}}}\n");
+  EXPECT_TRUE(isWellFormed(writer.buffer()));
+}
+
+TEST(JsonWriterTests, writesCPMContainers)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  test::buildCPM(builder, 1234);
+  test::appendPerceivedObject(builder, 1, 10.0, -5.0);
+
+  JsonWriter writer;
+  ASSERT_TRUE(writer.write(asn_DEF_CollectivePerceptionMessage, builder.get()));
+  EXPECT_EQ(writer.buffer(),
+            "{\"header\":{\"protocolVersion\":2,\"messageId\":14,\"stationId\":1234},"
+            "\"payload\":{\"managementContainer\":{\"referenceTime\":600000000000,"
+            "\"referencePosition\":{\"latitude\":484000000,\"longitude\":100000000,"
+            "\"positionConfidenceEllipse\":{\"semiMajorConfidence\":4095,\"semiMinorConfidence\":4095,"
+            "\"semiMajorOrientation\":3601},"
+            "\"altitude\":{\"altitudeValue\":50000,\"altitudeConfidence\":\"unavailable\"}}},"
+            "\"cpmContainers\":[{\"containerId\":5,\"containerData\":{\"PerceivedObjectContainer\":{"
+            "\"numberOfPerceivedObjects\":1,\"perceivedObjects\":[{\"objectId\":1,\"measurementDeltaTime\":0,"
+            "\"position\":{\"xCoordinate\":{\"value\":1000,\"confidence\":20},"
+            "\"yCoordinate\":{\"value\":-500,\"confidence\":20}}}]}}}]}}\n");
+  EXPECT_TRUE(isWellFormed(writer.buffer()));
+}
+
+TEST(JsonWriterTests, omitsAbsentOptionalMembers)
+{
+  MessageBuilder<VAM> builder;
+  test::buildVAM(builder, 9);
+  JsonWriter writer;
+  ASSERT_TRUE(writer.write(asn_DEF_VAM, builder.get()));
+  EXPECT_EQ(writer.buffer(),
+            "{\"header\":{\"protocolVersion\":3,\"messageId\":16,\"stationId\":9},"
+            "\"vam\":{\"generationDeltaTime\":1234,\"vamParameters\":{"
+            "\"basicContainer\":{\"stationType\":1,"
+            "\"referencePosition\":{\"latitude\":484000000,\"longitude\":100000000,"
+            "\"positionConfidenceEllipse\":{\"semiMajorAxisLength\":4095,\"semiMinorAxisLength\":4095,"
+            "\"semiMajorAxisOrientation\":3601},"
+            "\"altitude\":{\"altitudeValue\":50000,\"altitudeConfidence\":\"unavailable\"}}},"
+            "\"vruHighFrequencyContainer\":{\"heading\":{\"value\":900,\"confidence\":127},"
+            "\"speed\":{\"speedValue\":150,\"speedConfidence\":20},"
+            "\"longitudinalAcceleration\":{\"longitudinalAccelerationValue\":161,"
+            "\"longitudinalAccelerationConfidence\":102}}}}}\n");
+  EXPECT_TRUE(isWellFormed(writer.buffer()));
+}
+
+TEST(JsonWriterTests, escapesStrings)
+{
+  char text[] = "a\"b\\c\n\x01" "d";
+  IA5String_t str{};
+  str.buf = reinterpret_cast<uint8_t*>(text);
+  str.size = sizeof(text) - 1;
+  JsonWriter writer;
+  ASSERT_TRUE(writer.write(asn_DEF_IA5String, &str));
+  EXPECT_EQ(writer.buffer(), "\"a\\\"b\\\\c\\u000a\\u0001d\"\n");
+  EXPECT_TRUE(isWellFormed(writer.buffer()));
+}
+
+TEST(JsonWriterTests, detectsMalformedJson)
+{
+  EXPECT_TRUE(isWellFormed("{\"a\":[1,{\"b\":\"}],\\\"\"}]}\n"));
+  EXPECT_FALSE(isWellFormed("{\"a\":[1,2,]}\n"));
+  EXPECT_FALSE(isWellFormed("{\"a\":1,}\n"));
+  EXPECT_FALSE(isWellFormed("{\"a\":[1}]\n"));
+  EXPECT_FALSE(isWellFormed("{\"a\":1\n"));
+  EXPECT_FALSE(isWellFormed("{\"a\":\"1}\n"));
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,173 @@
+#include <v2x_etsi_asn1_lib/loopback_transport.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+namespace
+{
+struct RecordingSink : ETSIMessageSink
+{
+  void deliver(const proton::message& message) override
+  {
+    messages.push_back(message);
+  }
+  void deliver(const BinaryETSIMessage& /*message*/) override
+  {
+    num_binary++;
+  }
+
+  std::vector<proton::message> messages;
+  int num_binary = 0;
+};
+
+OutgoingETSIMessage makeMessage(const std::vector<uint8_t>& payload,
+                                ETSIMessageType message_type = ETSIMessageType::CAM,
+                                std::chrono::milliseconds ttl = 1000ms)
+{
+  OutgoingETSIMessage msg;
+  msg.message_type = message_type;
+  msg.subject = message_type == ETSIMessageType::CAM ? "cam" : "cpm";
+  msg.station_id = 42;
+  msg.time = std::chrono::system_clock::time_point(1700000000123ms);
+  msg.ttl = ttl;
+  msg.data = payload.data();
+  msg.size = payload.size();
+  return msg;
+}
+}  // namespace
+
+TEST(LoopbackTransportTests, deliversToAllOtherTransports)
+{
+  auto bus = LoopbackBus::create();
+  auto sender = bus->attach();
+  auto receiver1 = bus->attach();
+  auto receiver2 = bus->attach();
+
+  std::vector<uint8_t> payload = { 1, 2, 3 };
+  ASSERT_TRUE(sender->send(makeMessage(payload)));
+  ASSERT_EQ(bus->numSent(), 1);
+
+  for (auto* receiver : { receiver1.get(), receiver2.get() })
+  {
+    RecordingSink sink;
+    ASSERT_TRUE(receiver->receive(sink));
+    ASSERT_EQ(sink.messages.size(), 1);
+    ASSERT_EQ(sink.num_binary, 0);
+    const auto& msg = sink.messages.front();
+    ASSERT_EQ(msg.subject(), "cam");
+    ASSERT_EQ(msg.ttl().milliseconds(), 1000);
+    ASSERT_EQ(msg.creation_time().milliseconds(), 1700000000123);
+    ASSERT_EQ(receiver->numReceived(), 1);
+  }
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+
+  // the sender does not receive its own message
+  sender->close();
+  RecordingSink sink;
+  ASSERT_FALSE(sender->receive(sink));
+  ASSERT_TRUE(sink.messages.empty());
+  ASSERT_FALSE(sender->send(makeMessage(payload)));
+}
+
+TEST(LoopbackTransportTests, appliesFilter)
+{
+  auto bus = LoopbackBus::create();
+  auto sender = bus->attach();
+  auto receiver = bus->attach([](const proton::message& msg) { return msg.subject() == "cpm"; });
+
+  std::vector<uint8_t> payload = { 1 };
+  sender->send(makeMessage(payload, ETSIMessageType::CAM));
+  sender->send(makeMessage(payload, ETSIMessageType::CPM));
+
+  RecordingSink sink;
+  ASSERT_TRUE(receiver->receive(sink));
+  ASSERT_EQ(sink.messages.size(), 1);
+  ASSERT_EQ(sink.messages.front().subject(), "cpm");
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+}
+
+TEST(LoopbackTransportTests, dropsExpiredMessages)
+{
+  auto bus = LoopbackBus::create();
+  auto sender = bus->attach();
+  auto receiver = bus->attach();
+
+  std::vector<uint8_t> payload = { 1 };
+  sender->send(makeMessage(payload, ETSIMessageType::CPM, 10ms));
+  std::this_thread::sleep_for(20ms);
+
+  RecordingSink sink;
+  ASSERT_TRUE(receiver->receive(sink));
+  ASSERT_TRUE(sink.messages.empty());
+  ASSERT_EQ(receiver->numExpired(), 1);
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+}
+
+TEST(LoopbackTransportTests, waitsForReceivers)
+{
+  auto bus = LoopbackBus::create();
+  auto sender = bus->attach();
+  auto receiver = bus->attach();
+
+  RecordingSink sink;
+  std::thread receiver_thread([&]() {
+    while (receiver->receive(sink))
+    {
+    }
+  });
+
+  std::vector<uint8_t> payload = { 1 };
+  for (int i = 0; i < 1000; i++)
+  {
+    sender->send(makeMessage(payload));
+  }
+  ASSERT_TRUE(bus->waitUntilIdle(5s));
+  ASSERT_EQ(sink.messages.size(), 1000);
+
+  receiver->close();
+  receiver_thread.join();
+
+  // closed and destroyed transports do not keep the bus busy
+  sender->send(makeMessage(payload));
+  auto other = bus->attach();
+  sender->send(makeMessage(payload));
+  other.reset();
+  ASSERT_TRUE(bus->waitUntilIdle(0ms));
+}
+
+TEST(LoopbackTransportTests, sendsBatchOfManyStations)
+{
+  auto bus = LoopbackBus::create();
+  std::shared_ptr<ETSITransport> sender = bus->attach();
+  auto receiver = bus->attach();
+
+  std::vector<uint8_t> payload = { 1, 2 };
+  std::vector<OutgoingETSIMessage> batch;
+  for (StationId_t station_id = 1; station_id <= 100; station_id++)
+  {
+    batch.push_back(makeMessage(payload));
+    batch.back().station_id = station_id;
+  }
+  ASSERT_EQ(sender->sendBatch(batch), batch.size());
+  ASSERT_EQ(bus->numSent(), batch.size());
+
+  RecordingSink sink;
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    ASSERT_TRUE(receiver->receive(sink));
+  }
+  ASSERT_EQ(sink.messages.size(), batch.size());
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    ASSERT_EQ(proton::get<uint32_t>(sink.messages[i].properties().get("station_id")), i + 1);
+  }
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+
+  sender->close();
+  ASSERT_EQ(sender->sendBatch(batch), 0);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,135 @@
+#include <v2x_etsi_asn1_lib/mcm_trajectories.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <v2x_etsi_asn1_lib/time_conversions.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr double origin_latitude = 48.4;
+constexpr double origin_longitude = 10.0;
+constexpr uint64_t start_time = 1'700'000'000'000'000'000;
+constexpr uint64_t second = 1'000'000'000;
+
+// Straight trajectory from (x, y) with the given velocity, one sample per second for num seconds
+std::vector<TrajectorySample> makeSamples(double x, double y, double vx, double vy, int num)
+{
+  std::vector<TrajectorySample> samples;
+  for (int i = 0; i < num; i++)
+  {
+    TrajectorySample sample;
+    sample.time = start_time + i * second;
+    sample.x = x + i * vx;
+    sample.y = y + i * vy;
+    sample.speed = std::hypot(vx, vy);
+    sample.heading = std::atan2(vx, vy) * 180. / M_PI;
+    samples.push_back(sample);
+  }
+  return samples;
+}
+}  // namespace
+
+TEST(McmTrajectorySetTests, decodesPlannedTrajectory)
+{
+  MessageBuilder<MCM> builder;
+  auto& mcm = builder.reset();
+  mcm.header.stationId = 7;
+  mcm.mcm.generationDeltaTime = UnixTime2GenerationDeltaTime(start_time);
+  setReferencePosition(mcm.mcm.mcmParameters.basicContainer.referencePosition, origin_latitude, origin_longitude, 0.);
+  auto& container = mcm.mcm.mcmParameters.maneuverContainer;
+  container.present = ManeuverContainer_PR_roadUserContainer;
+  auto& road_user = container.choice.roadUserContainer;
+  road_user.roadUserState.length = 40;
+  road_user.roadUserState.width = 30;
+  auto& trajectory = builder.create(road_user.plannedTrajectory);
+  // points at 0.1 s, 0.3 s and 0.5 s, 10 m/s east
+  trajectory.startDeltaTime = 100;
+  trajectory.deltaTime = 200;
+  for (int i = 0; i < 3; i++)
+  {
+    auto& point = builder.append(trajectory.trajectoryPointContainer.list);
+    point.waypoint.xDistance = 100 + i * 200;
+    point.waypoint.yDistance = -50;
+    point.speed = 1000;
+    point.heading = 900;
+  }
+
+  McmTrajectorySet set(origin_latitude, origin_longitude, 100ms, 8);
+  set.reset(start_time);
+  ASSERT_EQ(set.addMCM(mcm, start_time), 0);
+  ASSERT_EQ(set.size(), 1);
+  ASSERT_EQ(set.stationId(0), 7);
+  ASSERT_NEAR(set.radius(0), 2.5, 1e-5);
+  ASSERT_GE(set.stride(), set.numSteps());
+
+  // steps 1 to 5 lie within the trajectory
+  for (size_t s : { 0, 6, 7 })
+  {
+    ASSERT_TRUE(std::isnan(set.x(0)[s])) << s;
+  }
+  for (size_t s = 1; s <= 5; s++)
+  {
+    ASSERT_NEAR(set.x(0)[s], s, 1e-3) << s;
+    ASSERT_NEAR(set.y(0)[s], -0.5, 1e-3) << s;
+    ASSERT_NEAR(set.speed(0)[s], 10., 1e-3) << s;
+    ASSERT_NEAR(set.heading(0)[s], 90., 1e-3) << s;
+  }
+
+  // no planned trajectory
+  road_user.plannedTrajectory = nullptr;
+  ASSERT_FALSE(set.addMCM(mcm, start_time));
+}
+
+TEST(McmTrajectorySetTests, detectsCrossingConflict)
+{
+  McmTrajectorySet set(origin_latitude, origin_longitude, 100ms, 100);
+  set.reset(start_time);
+  // both reach (0, 0) after 5 s, the third one drives parallel to the first one
+  ASSERT_EQ(set.addTrajectory(1, 2.f, makeSamples(-50., 0., 10., 0., 11)), 0);
+  ASSERT_EQ(set.addTrajectory(2, 2.f, makeSamples(0., -50., 0., 10., 11)), 1);
+  ASSERT_EQ(set.addTrajectory(3, 2.f, makeSamples(-50., 100., 10., 0., 11)), 2);
+
+  const auto conflicts = set.findConflicts(1.f);
+  ASSERT_EQ(conflicts.size(), 1);
+  ASSERT_EQ(conflicts[0].first, 0);
+  ASSERT_EQ(conflicts[0].second, 1);
+  // the distance sqrt(2) * |10 m/s * t - 50 m| drops below 5 m at t = 5 s - 0.5 s / sqrt(2), they meet at t = 5 s
+  ASSERT_NEAR(static_cast<double>(conflicts[0].time - start_time), (5. - 0.5 / std::sqrt(2.)) * second, 1e6);
+  ASSERT_NEAR(static_cast<double>(conflicts[0].closest_time - start_time), 5. * second, 1e6);
+  ASSERT_NEAR(conflicts[0].distance, 0., 1e-3);
+
+  ASSERT_EQ(set.findConflicts(2, 1.f).size(), 0);
+  ASSERT_EQ(set.findConflicts(1, 1.f).size(), 1);
+
+  set.reset(start_time);
+  ASSERT_EQ(set.size(), 0);
+}
+
+TEST(McmTrajectorySetTests, detectsPassingBetweenSteps)
+{
+  // opposing road users pass each other half way between two steps of the grid
+  McmTrajectorySet set(origin_latitude, origin_longitude, 1s, 4);
+  set.reset(start_time);
+  set.addTrajectory(1, 1.f, makeSamples(-10., 0., 20., 0., 4));
+  set.addTrajectory(2, 1.f, makeSamples(10., 0.5, -20., 0., 4));
+
+  const auto conflict = set.findConflict(0, 1, 0.f);
+  ASSERT_TRUE(conflict);
+  ASSERT_NEAR(conflict->distance, 0.5, 1e-3);
+  ASSERT_EQ(conflict->closest_time, start_time + second / 2);
+  // 40 m/s * |t - 0.5 s| drops below sqrt(2^2 - 0.5^2) m within the same step
+  const double entry_offset = std::sqrt(3.75) / 40.;
+  ASSERT_NEAR(static_cast<double>(conflict->time - start_time), (0.5 - entry_offset) * second, 1e6);
+
+  // a lateral gap larger than the radii
+  set.reset(start_time);
+  set.addTrajectory(1, 1.f, makeSamples(-10., 0., 20., 0., 4));
+  set.addTrajectory(2, 1.f, makeSamples(10., 3., -20., 0., 4));
+  ASSERT_FALSE(set.findConflict(0, 1, 0.f));
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,145 @@
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <v2x_etsi_asn1_lib/encoding.h>
+#include <gtest/gtest.h>
+
+#include <CollectivePerceptionMessage.h>
+
+#include <cmath>
+#include <cstdlib>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+TEST(MessageArenaTests, allocatesAlignedZeroedMemory)
+{
+  MessageArena arena(1024);
+  auto* a = static_cast<uint8_t*>(arena.allocate(3, 1));
+  auto* b = arena.create<double>();
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(double), 0);
+  ASSERT_GE(reinterpret_cast<uint8_t*>(b), a + 3);
+  ASSERT_EQ(*b, 0.0);
+  *b = 1.0;
+  // larger than a block
+  auto* c = arena.createArray<uint8_t>(4096);
+  ASSERT_NE(c, nullptr);
+  c[4095] = 1;
+
+  arena.reset();
+  ASSERT_EQ(arena.used(), 0);
+  arena.allocate(3, 1);
+  ASSERT_EQ(*arena.create<double>(), 0.0);
+}
+
+TEST(MessageArenaTests, reusesBlocks)
+{
+  MessageArena arena(1024);
+  for (int i = 0; i < 100; i++)
+  {
+    arena.createArray<uint64_t>(100);
+  }
+  const auto capacity = arena.capacity();
+  const auto used = arena.used();
+  for (int cycle = 0; cycle < 10; cycle++)
+  {
+    arena.reset();
+    for (int i = 0; i < 100; i++)
+    {
+      arena.createArray<uint64_t>(100);
+    }
+    ASSERT_EQ(arena.capacity(), capacity);
+    ASSERT_EQ(arena.used(), used);
+  }
+}
+
+TEST(MessageBuilderTests, setsIntegers)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  builder.reset();
+  for (const uint64_t value : { 0ul, 127ul, 128ul, 255ul, 600000000000ul, UINT64_MAX })
+  {
+    INTEGER_t integer{};
+    builder.setInteger(integer, value);
+    uintmax_t decoded;
+    ASSERT_EQ(asn_INTEGER2umax(&integer, &decoded), 0);
+    ASSERT_EQ(decoded, value);
+  }
+}
+
+TEST(MessageBuilderTests, buildsEncodableMessages)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder(1024);
+  size_t capacity = 0;
+  for (int cycle = 0; cycle < 3; cycle++)
+  {
+    auto& cpm = builder.reset();
+    cpm.header.protocolVersion = 2;
+    cpm.header.messageId = MessageId_cpm;
+    cpm.header.stationId = 1234;
+    builder.setInteger(cpm.payload.managementContainer.referenceTime, 600000000000);
+    setReferencePosition(cpm.payload.managementContainer.referencePosition, 48.4, 10.0, 500.0);
+
+    auto& container = builder.append(cpm.payload.cpmContainers.list);
+    container.containerId = 5;
+    container.containerData.present = WrappedCpmContainer__containerData_PR_PerceivedObjectContainer;
+    auto& object_container = container.containerData.choice.PerceivedObjectContainer;
+    for (long i = 0; i < 100; i++)
+    {
+      auto& obj = builder.append(object_container.perceivedObjects.list);
+      builder.create(obj.objectId) = i;
+      setCartesianCoordinate(obj.position.xCoordinate, static_cast<double>(i), 0.1);
+      setCartesianCoordinate(obj.position.yCoordinate, -static_cast<double>(i), NAN);
+    }
+    object_container.numberOfPerceivedObjects = object_container.perceivedObjects.list.count;
+
+    auto res = encodeETSIMsg(&asn_DEF_CollectivePerceptionMessage, WireEncoding::UPER, builder.get());
+    ASSERT_NE(res.buffer, nullptr);
+    void* decoded = nullptr;
+    ASSERT_EQ(decodeETSIMsg(&asn_DEF_CollectivePerceptionMessage,
+                            WireEncoding::UPER,
+                            &decoded,
+                            res.buffer,
+                            static_cast<size_t>(res.result.encoded))
+                  .code,
+              RC_OK);
+    free(res.buffer);
+
+    const auto* msg = static_cast<const CollectivePerceptionMessage*>(decoded);
+    EXPECT_EQ(msg->header.stationId, 1234);
+    EXPECT_EQ(msg->payload.managementContainer.referencePosition.latitude, 484000000);
+    const auto& objects =
+        msg->payload.cpmContainers.list.array[0]->containerData.choice.PerceivedObjectContainer.perceivedObjects.list;
+    ASSERT_EQ(objects.count, 100);
+    EXPECT_EQ(*objects.array[99]->objectId, 99);
+    EXPECT_EQ(objects.array[99]->position.xCoordinate.value, 9900);
+    EXPECT_EQ(objects.array[99]->position.yCoordinate.confidence, CoordinateConfidence_unavailable);
+    ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, decoded);
+
+    // later cycles build the same message in the blocks of the first one
+    if (cycle == 0)
+    {
+      capacity = builder.arena().capacity();
+    }
+    EXPECT_EQ(builder.arena().capacity(), capacity);
+  }
+}
+
+TEST(MessageBuilderTests, scalesValues)
+{
+  Speed_t speed;
+  setSpeed(speed, 12.34, 0.1);
+  EXPECT_EQ(speed.speedValue, 1234);
+  EXPECT_EQ(speed.speedConfidence, 20);
+  setSpeed(speed, 1000.0, NAN);
+  EXPECT_EQ(speed.speedValue, SpeedValue_outOfRange);
+  EXPECT_EQ(speed.speedConfidence, SpeedConfidence_unavailable);
+  setSpeed(speed, NAN, 0.0);
+  EXPECT_EQ(speed.speedValue, SpeedValue_unavailable);
+  EXPECT_EQ(speed.speedConfidence, 1);
+
+  Heading_t heading;
+  setHeading(heading, -90.0, 1.0);
+  EXPECT_EQ(heading.headingValue, 2700);
+  setHeading(heading, 359.99, 1.0);
+  EXPECT_EQ(heading.headingValue, 0);
+  EXPECT_EQ(heading.headingConfidence, 20);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
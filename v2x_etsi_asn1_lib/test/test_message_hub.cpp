@@ -0,0 +1,164 @@
+#include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+#include <v2x_etsi_asn1_lib/loopback_transport.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <gtest/gtest.h>
+#include "test_messages.h"
+
+#include <mutex>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+namespace
+{
+HubMessage makeHubMessage(ETSIMessageType message_type,
+                          StationId_t station_id,
+                          std::optional<StationId_t> destination_station_id = {})
+{
+  auto msg_bin = std::make_shared<BinaryETSIMessage>();
+  msg_bin->message_type = message_type;
+  msg_bin->station_id = station_id;
+  msg_bin->destination_station_id = destination_station_id;
+  if (message_type == ETSIMessageType::CAM)
+  {
+    return { &asn_DEF_CAM, allocateETSIMsg<CAM>(asn_DEF_CAM), msg_bin };
+  }
+  return { &asn_DEF_VAM, allocateETSIMsg<VAM>(asn_DEF_VAM), msg_bin };
+}
+
+std::vector<StationId_t> popAll(HubSubscription& subscription)
+{
+  std::vector<StationId_t> station_ids;
+  HubMessage message;
+  while (subscription.tryPop(message))
+  {
+    station_ids.push_back(message.msg_bin->station_id);
+  }
+  return station_ids;
+}
+}  // namespace
+
+TEST(MessageHubTests, filtersMessages)
+{
+  MessageHub hub;
+  ASSERT_FALSE(hub.hasSubscribers());
+  auto all = hub.subscribe();
+  auto cams = hub.subscribe({ { ETSIMessageType::CAM }, {}, {} });
+  auto stations = hub.subscribe({ {}, { 2, 3 }, {} });
+  auto addressed = hub.subscribe({ {}, {}, 7 });
+  ASSERT_TRUE(hub.hasSubscribers());
+
+  hub.publish(makeHubMessage(ETSIMessageType::CAM, 1));
+  hub.publish(makeHubMessage(ETSIMessageType::VAM, 2));
+  hub.publish(makeHubMessage(ETSIMessageType::CAM, 3, 7));
+  hub.publish(makeHubMessage(ETSIMessageType::CAM, 4, 8));
+
+  ASSERT_EQ(popAll(*all), std::vector<StationId_t>({ 1, 2, 3, 4 }));
+  ASSERT_EQ(popAll(*cams), std::vector<StationId_t>({ 1, 3, 4 }));
+  ASSERT_EQ(popAll(*stations), std::vector<StationId_t>({ 2, 3 }));
+  ASSERT_EQ(popAll(*addressed), std::vector<StationId_t>({ 1, 2, 3 }));
+
+  hub.unsubscribe(all);
+  hub.publish(makeHubMessage(ETSIMessageType::CAM, 5));
+  ASSERT_TRUE(popAll(*all).empty());
+  ASSERT_EQ(popAll(*cams), std::vector<StationId_t>({ 5 }));
+}
+
+TEST(MessageHubTests, sharesMessagesBetweenSubscribers)
+{
+  MessageHub hub;
+  auto first = hub.subscribe();
+  auto second = hub.subscribe();
+  const auto published = makeHubMessage(ETSIMessageType::CAM, 1);
+  hub.publish(published);
+
+  HubMessage a;
+  HubMessage b;
+  ASSERT_TRUE(first->pop(a, 0ms));
+  ASSERT_TRUE(second->pop(b, 0ms));
+  ASSERT_EQ(a.msg, published.msg);
+  ASSERT_EQ(b.msg, published.msg);
+  ASSERT_EQ(b.msg_bin, published.msg_bin);
+  ASSERT_EQ(a.get<CAM>(asn_DEF_CAM).get(), published.msg.get());
+  ASSERT_EQ(a.get<VAM>(asn_DEF_VAM), nullptr);
+}
+
+TEST(MessageHubTests, slowSubscribersDropOldestMessages)
+{
+  MessageHub hub;
+  auto slow = hub.subscribe({}, 2);
+  auto fast = hub.subscribe({}, 100);
+  for (StationId_t station_id = 1; station_id <= 10; station_id++)
+  {
+    hub.publish(makeHubMessage(ETSIMessageType::CAM, station_id));
+  }
+  ASSERT_EQ(slow->numDropped(), 8);
+  ASSERT_EQ(popAll(*slow), std::vector<StationId_t>({ 9, 10 }));
+  ASSERT_EQ(fast->numDropped(), 0);
+  ASSERT_EQ(popAll(*fast).size(), 10);
+}
+
+TEST(MessageHubTests, unsubscribeWakesWaitingSubscriber)
+{
+  MessageHub hub;
+  auto subscription = hub.subscribe();
+  const auto start = std::chrono::steady_clock::now();
+  std::thread consumer([&]() {
+    HubMessage message;
+    ASSERT_FALSE(subscription->pop(message, 5s));
+  });
+  std::this_thread::sleep_for(10ms);
+  hub.unsubscribe(subscription);
+  consumer.join();
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+  ASSERT_FALSE(hub.hasSubscribers());
+}
+
+TEST(MessageHubTests, transceiverPublishesDecodedMessages)
+{
+  auto bus = LoopbackBus::create();
+  ETSIAMQPTransceiverBase sender;
+  ETSIAMQPTransceiverBase receiver;
+  std::mutex lock;
+  std::vector<std::shared_ptr<const CollectivePerceptionMessage>> handled;
+  ASSERT_TRUE(receiver.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage,
+      ETSIMessageType::CPM,
+      [&](const std::shared_ptr<const CollectivePerceptionMessage>& msg, const BinaryETSIMessage& /*msg_bin*/) {
+        std::lock_guard<std::mutex> l(lock);
+        handled.push_back(msg);
+      }));
+  auto hub = receiver.enableMessageHub();
+  ASSERT_EQ(receiver.enableMessageHub(), hub);
+  auto all = hub->subscribe();
+  auto cpms = hub->subscribe({ { ETSIMessageType::CPM }, { 1 }, {} });
+  auto cams = hub->subscribe({ { ETSIMessageType::CAM }, {}, {} });
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  test::buildCPM(builder, 7);
+  ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get()));
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+
+  // the handler is still called, and the subscribers get the same decoded message instead of a copy
+  ASSERT_EQ(handled.size(), 1);
+  HubMessage a;
+  HubMessage b;
+  ASSERT_TRUE(all->pop(a, 0ms));
+  ASSERT_TRUE(cpms->pop(b, 0ms));
+  ASSERT_FALSE(cams->tryPop(b));
+  ASSERT_EQ(a.get<CollectivePerceptionMessage>(asn_DEF_CollectivePerceptionMessage), handled[0]);
+  ASSERT_EQ(b.msg, a.msg);
+  ASSERT_EQ(b.msg_bin, a.msg_bin);
+  ASSERT_EQ(a.msg_bin->message_type, ETSIMessageType::CPM);
+  ASSERT_EQ(a.msg_bin->station_id, 1);
+  ASSERT_EQ(handled[0]->header.stationId, 7);
+  ASSERT_FALSE(all->tryPop(a));
+
+  receiver.disconnect();
+  sender.disconnect();
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
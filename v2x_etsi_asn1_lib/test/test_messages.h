@@ -0,0 +1,171 @@
+#ifndef V2X_ETSI_ASN1_LIB_TEST_TEST_MESSAGES_H_
+#define V2X_ETSI_ASN1_LIB_TEST_TEST_MESSAGES_H_
+
+#include <v2x_etsi_asn1_lib/cpm_segmenter.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <gtest/gtest.h>
+
+#include <CAM.h>
+#include <CollectivePerceptionMessage.h>
+#include <PerceivedObject.h>
+#include <VAM.h>
+
+#include <cstdint>
+#include <vector>
+
+// Messages shared by the tests
+namespace mrm::v2x_etsi_asn1_lib::test
+{
+// CPM with a header and a reference time, but no containers
+struct TestCPM
+{
+  explicit TestCPM(uint64_t reference_time = 600000000000)
+  {
+    msg = static_cast<CollectivePerceptionMessage*>(calloc(1, sizeof(CollectivePerceptionMessage)));
+    msg->header.protocolVersion = 2;
+    msg->header.messageId = MessageId_cpm;
+    msg->header.stationId = 1234;
+    asn_umax2INTEGER(&msg->payload.managementContainer.referenceTime, reference_time);
+  }
+
+  ~TestCPM()
+  {
+    ASN_STRUCT_FREE(asn_DEF_CollectivePerceptionMessage, msg);
+  }
+
+  TestCPM(const TestCPM&) = delete;
+  TestCPM& operator=(const TestCPM&) = delete;
+
+  CollectivePerceptionMessage* msg;
+};
+
+// Perceived objects with object ID i at (i, -i) metres
+struct TestObjects
+{
+  explicit TestObjects(size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      auto* obj = static_cast<PerceivedObject*>(calloc(1, sizeof(PerceivedObject)));
+      obj->objectId = static_cast<Identifier2B_t*>(calloc(1, sizeof(Identifier2B_t)));
+      *obj->objectId = static_cast<long>(i);
+      obj->position.xCoordinate.value = static_cast<long>(i) * 100;
+      obj->position.xCoordinate.confidence = CoordinateConfidence_unavailable;
+      obj->position.yCoordinate.value = -static_cast<long>(i) * 100;
+      obj->position.yCoordinate.confidence = CoordinateConfidence_unavailable;
+      objects.push_back(obj);
+    }
+  }
+
+  ~TestObjects()
+  {
+    for (const auto* obj : objects)
+    {
+      ASN_STRUCT_FREE(asn_DEF_PerceivedObject, const_cast<PerceivedObject*>(obj));
+    }
+  }
+
+  TestObjects(const TestObjects&) = delete;
+  TestObjects& operator=(const TestObjects&) = delete;
+
+  std::vector<const PerceivedObject*> objects;
+};
+
+// CPM at 48.4, 10.0 with a header and a reference time, but no containers
+inline void buildCPM(MessageBuilder<CollectivePerceptionMessage>& builder, StationId_t station_id)
+{
+  auto& cpm = builder.reset();
+  cpm.header.protocolVersion = 2;
+  cpm.header.messageId = MessageId_cpm;
+  cpm.header.stationId = station_id;
+  builder.setInteger(cpm.payload.managementContainer.referenceTime, 600000000000);
+  setReferencePosition(cpm.payload.managementContainer.referencePosition, 48.4, 10.0, 500.0);
+}
+
+inline void buildCPM(MessageBuilder<CollectivePerceptionMessage>& builder,
+                     StationId_t station_id,
+                     double latitude,
+                     double longitude)
+{
+  buildCPM(builder, station_id);
+  setReferencePosition(builder.get()->payload.managementContainer.referencePosition, latitude, longitude, 500.0);
+}
+
+// Appends a PerceivedObjectContainer with one perceived object at (x, y) metres to the CPM started by buildCPM()
+inline void appendPerceivedObject(MessageBuilder<CollectivePerceptionMessage>& builder,
+                                  Identifier2B_t object_id,
+                                  double x,
+                                  double y)
+{
+  auto& container = builder.append(builder.get()->payload.cpmContainers.list);
+  container.containerId = 5;
+  container.containerData.present = WrappedCpmContainer__containerData_PR_PerceivedObjectContainer;
+  auto& object_container = container.containerData.choice.PerceivedObjectContainer;
+  object_container.numberOfPerceivedObjects = 1;
+  auto& obj = builder.append(object_container.perceivedObjects.list);
+  builder.create(obj.objectId) = object_id;
+  setCartesianCoordinate(obj.position.xCoordinate, x, 0.1);
+  setCartesianCoordinate(obj.position.yCoordinate, y, 0.1);
+}
+
+// CAM of a passenger car at 48.4, 10.0 heading east, the other high frequency values are unavailable
+inline void buildCAM(MessageBuilder<CAM>& builder, StationId_t station_id, double speed = 10.0)
+{
+  auto& cam = builder.reset();
+  cam.header.protocolVersion = 2;
+  cam.header.messageId = MessageId_cam;
+  cam.header.stationId = station_id;
+  cam.cam.generationDeltaTime = 1234;
+  auto& basic = cam.cam.camParameters.basicContainer;
+  basic.stationType = TrafficParticipantType_passengerCar;
+  setReferencePosition(basic.referencePosition, 48.4, 10.0, 500.0);
+  auto& container = cam.cam.camParameters.highFrequencyContainer;
+  container.present = HighFrequencyContainer_PR_basicVehicleContainerHighFrequency;
+  auto& hf = container.choice.basicVehicleContainerHighFrequency;
+  setHeading(hf.heading, 90.0, 1.0);
+  setSpeed(hf.speed, speed, 0.1);
+  hf.driveDirection = DriveDirection_forward;
+  hf.vehicleLength.vehicleLengthValue = VehicleLengthValue_unavailable;
+  hf.vehicleLength.vehicleLengthConfidenceIndication = VehicleLengthConfidenceIndication_unavailable;
+  hf.vehicleWidth = VehicleWidth_unavailable;
+  hf.longitudinalAcceleration.value = AccelerationValue_unavailable;
+  hf.longitudinalAcceleration.confidence = AccelerationConfidence_unavailable;
+  hf.curvature.curvatureValue = CurvatureValue_unavailable;
+  hf.curvature.curvatureConfidence = CurvatureConfidence_unavailable;
+  hf.curvatureCalculationMode = CurvatureCalculationMode_unavailable;
+  hf.yawRate.yawRateValue = YawRateValue_unavailable;
+  hf.yawRate.yawRateConfidence = YawRateConfidence_unavailable;
+}
+
+// VAM of a pedestrian at 48.4, 10.0 walking east, without any of the OPTIONAL high frequency values
+inline void buildVAM(MessageBuilder<VAM>& builder, StationId_t station_id, double speed = 1.5)
+{
+  auto& vam = builder.reset();
+  vam.header.protocolVersion = 3;
+  vam.header.messageId = MessageId_vam;
+  vam.header.stationId = station_id;
+  vam.vam.generationDeltaTime = 1234;
+  auto& basic = vam.vam.vamParameters.basicContainer;
+  basic.stationType = TrafficParticipantType_pedestrian;
+  setReferencePosition(basic.referencePosition, 48.4, 10.0, 500.0);
+  auto& hf = vam.vam.vamParameters.vruHighFrequencyContainer;
+  hf.heading.value = 900;
+  hf.heading.confidence = Wgs84AngleConfidence_unavailable;
+  setSpeed(hf.speed, speed, 0.1);
+  hf.longitudinalAcceleration.longitudinalAccelerationValue = LongitudinalAccelerationValue_unavailable;
+  hf.longitudinalAcceleration.longitudinalAccelerationConfidence = AccelerationConfidence_unavailable;
+}
+
+// UPER encoded CPM with one PerceivedObjectContainer of the given number of perceived objects
+inline std::vector<uint8_t> encodeTestCPM(size_t num_objects)
+{
+  TestCPM cpm;
+  TestObjects objects(num_objects);
+  SegmentedCPM result;
+  EXPECT_TRUE(encodeSegmentedCPM(*cpm.msg, objects.objects, 64 * 1024, result));
+  EXPECT_EQ(result.segments.size(), 1);
+  return result.segments.empty() ? std::vector<uint8_t>() : result.segments[0];
+}
+}  // namespace mrm::v2x_etsi_asn1_lib::test
+
+#endif /* V2X_ETSI_ASN1_LIB_TEST_TEST_MESSAGES_H_ */
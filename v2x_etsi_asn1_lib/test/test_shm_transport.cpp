@@ -0,0 +1,216 @@
+#include <v2x_etsi_asn1_lib/shm_transport.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+class ShmTransportTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    name_ = "v2x_etsi_asn1_lib_test_" + std::to_string(getpid());
+    ShmTransport::remove(name_);
+  }
+  void TearDown() override
+  {
+    ShmTransport::remove(name_);
+  }
+
+  static OutgoingETSIMessage makeMessage(const std::vector<uint8_t>& payload,
+                                         StationId_t station_id,
+                                         std::chrono::milliseconds ttl = 1000ms)
+  {
+    OutgoingETSIMessage msg;
+    msg.message_type = ETSIMessageType::CAM;
+    msg.subject = "cam";
+    msg.station_id = station_id;
+    msg.time = std::chrono::system_clock::now();
+    msg.ttl = ttl;
+    msg.data = payload.data();
+    msg.size = payload.size();
+    return msg;
+  }
+
+  std::string name_;
+};
+
+TEST_F(ShmTransportTests, deliversToAllOtherReaders)
+{
+  auto sender = ShmTransport::open(name_, 8, 64);
+  auto reader1 = ShmTransport::open(name_, 8, 64);
+  auto reader2 = ShmTransport::open(name_, 8, 64);
+  ASSERT_TRUE(sender && reader1 && reader2);
+
+  std::vector<uint8_t> payload = { 1, 2, 3, 4 };
+  auto out = makeMessage(payload, 42);
+  out.destination_station_id = 7;
+  out.encoding = WireEncoding::OER;
+  ASSERT_TRUE(sender->send(out));
+
+  for (auto* reader : { reader1.get(), reader2.get() })
+  {
+    BinaryETSIMessage msg;
+    ASSERT_TRUE(reader->tryReceive(msg));
+    ASSERT_EQ(msg.message_type, ETSIMessageType::CAM);
+    ASSERT_EQ(msg.station_id, 42);
+    ASSERT_EQ(msg.destination_station_id, std::optional<StationId_t>(7));
+    ASSERT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(msg.time - out.time).count(), 0);
+    ASSERT_EQ(msg.data, payload);
+    ASSERT_EQ(msg.encoding, WireEncoding::OER);
+    ASSERT_FALSE(reader->tryReceive(msg));
+  }
+
+  // own messages are not received
+  BinaryETSIMessage msg;
+  ASSERT_FALSE(sender->tryReceive(msg));
+}
+
+TEST_F(ShmTransportTests, rejectsIncompatibleLayoutAndOversizedMessages)
+{
+  auto transport = ShmTransport::open(name_, 8, 64);
+  ASSERT_TRUE(transport);
+  ASSERT_FALSE(ShmTransport::open(name_, 16, 64));
+
+  std::vector<uint8_t> payload(65);
+  ASSERT_FALSE(transport->send(makeMessage(payload, 1)));
+}
+
+TEST_F(ShmTransportTests, slowReaderLosesOldestMessages)
+{
+  auto sender = ShmTransport::open(name_, 8, 64);
+  auto reader = ShmTransport::open(name_, 8, 64);
+  ASSERT_TRUE(sender && reader);
+
+  for (uint8_t i = 0; i < 20; i++)
+  {
+    std::vector<uint8_t> payload = { i };
+    ASSERT_TRUE(sender->send(makeMessage(payload, 1)));
+  }
+  BinaryETSIMessage msg;
+  for (uint8_t i = 12; i < 20; i++)
+  {
+    ASSERT_TRUE(reader->tryReceive(msg));
+    ASSERT_EQ(msg.data, std::vector<uint8_t>{ i });
+  }
+  ASSERT_FALSE(reader->tryReceive(msg));
+  ASSERT_EQ(reader->numLost(), 12);
+}
+
+TEST_F(ShmTransportTests, dropsExpiredMessages)
+{
+  auto sender = ShmTransport::open(name_, 8, 64);
+  auto reader = ShmTransport::open(name_, 8, 64);
+  ASSERT_TRUE(sender && reader);
+
+  std::vector<uint8_t> payload = { 1 };
+  auto out = makeMessage(payload, 1, 100ms);
+  out.time -= 1s;
+  ASSERT_TRUE(sender->send(out));
+  ASSERT_TRUE(sender->send(makeMessage(payload, 2)));
+
+  BinaryETSIMessage msg;
+  ASSERT_TRUE(reader->tryReceive(msg));
+  ASSERT_EQ(msg.station_id, 2);
+  ASSERT_FALSE(reader->tryReceive(msg));
+}
+
+TEST_F(ShmTransportTests, concurrentSenders)
+{
+  constexpr int num_senders = 4;
+  constexpr int num_messages = 10000;
+  auto reader = ShmTransport::open(name_, 1024, 64);
+  ASSERT_TRUE(reader);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_senders; i++)
+  {
+    threads.emplace_back([this, i]() {
+      auto sender = ShmTransport::open(name_, 1024, 64);
+      for (int j = 0; j < num_messages; j++)
+      {
+        std::vector<uint8_t> payload(16, static_cast<uint8_t>(j));
+        sender->send(makeMessage(payload, i));
+      }
+    });
+  }
+
+  // torn messages are only counted here, failing while the senders are joinable would terminate
+  uint64_t received = 0;
+  uint64_t torn = 0;
+  BinaryETSIMessage msg;
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (received + reader->numLost() < num_senders * num_messages && std::chrono::steady_clock::now() < deadline)
+  {
+    if (reader->tryReceive(msg))
+    {
+      // the payload must never be torn
+      if (msg.data.size() != 16 || std::count(msg.data.begin(), msg.data.end(), msg.data.front()) != 16)
+      {
+        torn++;
+      }
+      received++;
+    }
+  }
+  for (auto& t : threads)
+  {
+    t.join();
+  }
+  ASSERT_EQ(torn, 0);
+  ASSERT_EQ(received + reader->numLost(), num_senders * num_messages);
+}
+
+TEST_F(ShmTransportTests, lappingSendersNeverPublishTornSlots)
+{
+  // with only two slots, senders constantly reuse the slots others are still writing
+  constexpr int num_senders = 4;
+  constexpr int num_messages = 20000;
+  auto reader = ShmTransport::open(name_, 2, 256);
+  ASSERT_TRUE(reader);
+
+  std::atomic<int> num_done = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_senders; i++)
+  {
+    threads.emplace_back([this, i, &num_done]() {
+      auto sender = ShmTransport::open(name_, 2, 256);
+      for (int j = 0; j < num_messages; j++)
+      {
+        std::vector<uint8_t> payload(256, static_cast<uint8_t>(i * 32 + j % 32));
+        sender->send(makeMessage(payload, i));
+      }
+      num_done++;
+    });
+  }
+
+  // torn messages are only counted here, failing while the senders are joinable would terminate
+  uint64_t received = 0;
+  uint64_t torn = 0;
+  BinaryETSIMessage msg;
+  while (num_done < num_senders)
+  {
+    if (reader->tryReceive(msg))
+    {
+      // payload and metadata must stem from the same message
+      if (msg.data.size() != 256 || std::count(msg.data.begin(), msg.data.end(), msg.data.front()) != 256 ||
+          msg.station_id != msg.data.front() / 32u)
+      {
+        torn++;
+      }
+      received++;
+    }
+  }
+  for (auto& t : threads)
+  {
+    t.join();
+  }
+  ASSERT_EQ(torn, 0) << "of " << received << " received messages";
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,84 @@
+#include <v2x_etsi_asn1_lib/spatial_index.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+TEST(SpatialIndexTests, projection)
+{
+  SpatialIndex index(48.4, 9.95, 50.0, 1s);
+  auto p = index.toLocal(48.4, 9.95);
+  ASSERT_NEAR(p.x, 0.0, 1e-9);
+  ASSERT_NEAR(p.y, 0.0, 1e-9);
+  p = index.toLocal(48.401, 9.95);
+  ASSERT_NEAR(p.y, 111.2, 0.1);
+  p = index.toLocal(48.4, 9.951);
+  ASSERT_NEAR(p.x, 73.8, 0.1);
+}
+
+TEST(SpatialIndexTests, radiusQueryMatchesLinearScan)
+{
+  SpatialIndex index(48.4, 9.95, 25.0, 1s);
+  SpatialIndex::Clock::time_point t{ 100s };
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1000., 1000.);
+  std::vector<LocalPoint> points;
+  for (uint32_t i = 0; i < 2000; i++)
+  {
+    points.push_back({ dist(rng), dist(rng) });
+    index.updateObject(i / 100, i % 100, points.back(), t);
+  }
+  // move all objects once, so the index has to relocate them
+  for (uint32_t i = 0; i < 2000; i++)
+  {
+    points[i] = { dist(rng), dist(rng) };
+    index.updateObject(i / 100, i % 100, points[i], t);
+  }
+  ASSERT_EQ(index.size(), 2000);
+
+  for (double radius : { 10., 100., 3000. })
+  {
+    LocalPoint center{ 12., -34. };
+    auto res = index.queryRadius(center, radius, t);
+    size_t expected = std::count_if(points.begin(), points.end(), [&](const auto& p) {
+      return std::hypot(p.x - center.x, p.y - center.y) <= radius;
+    });
+    ASSERT_EQ(res.size(), expected);
+  }
+}
+
+TEST(SpatialIndexTests, polygonQuery)
+{
+  SpatialIndex index(0.0, 0.0, 10.0, 1s);
+  SpatialIndex::Clock::time_point t{ 100s };
+  index.updateStation(1, { 5., 5. }, t);
+  index.updateStation(2, { 15., 5. }, t);
+  index.updateObject(1, 7, { 5., 25. }, t);
+
+  // straight corridor
+  std::vector<LocalPoint> polygon = { { 0., 0. }, { 10., 0. }, { 10., 30. }, { 0., 30. } };
+  auto res = index.queryPolygon(polygon, t);
+  ASSERT_EQ(res.size(), 2);
+  for (const auto& e : res)
+  {
+    ASSERT_EQ(e.station_id, 1);
+  }
+}
+
+TEST(SpatialIndexTests, expiry)
+{
+  SpatialIndex index(0.0, 0.0, 10.0, 1s);
+  SpatialIndex::Clock::time_point t{ 100s };
+  index.updateStation(1, { 5., 5. }, t);
+  index.updateStation(2, { 6., 5. }, t + 800ms);
+  ASSERT_EQ(index.queryRadius({ 5., 5. }, 5., t + 1500ms).size(), 1);
+  index.expire(t + 1500ms);
+  ASSERT_EQ(index.size(), 1);
+  index.expire(t + 3s);
+  ASSERT_EQ(index.size(), 0);
+}
+
+}  // namespace mrm::v2x_etsi_asn1_lib
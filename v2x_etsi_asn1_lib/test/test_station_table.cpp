@@ -0,0 +1,86 @@
+#include <v2x_etsi_asn1_lib/station_table.h>
+#include <gtest/gtest.h>
+#include <optional>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+
+static StationState makeState(uint32_t station_id, double speed)
+{
+  StationState state;
+  state.station_id = station_id;
+  state.message_type = ETSIMessageType::CAM;
+  state.speed = speed;
+  state.latitude = speed;
+  return state;
+}
+
+TEST(StationTableTests, updateAndGet)
+{
+  StationTable table(16, 1s);
+  StationTable::Clock::time_point t{ 100s };
+  ASSERT_FALSE(table.get(42, t));
+  ASSERT_TRUE(table.update(makeState(42, 1.0), t));
+  ASSERT_TRUE(table.update(makeState(0, 3.0), t));
+  ASSERT_TRUE(table.update(makeState(42, 2.0), t));
+
+  auto state = table.get(42, t);
+  ASSERT_TRUE(state);
+  ASSERT_EQ(state->station_id, 42);
+  ASSERT_EQ(state->speed, 2.0);
+  ASSERT_EQ(table.get(0, t)->speed, 3.0);
+  ASSERT_EQ(table.snapshot(t).size(), 2);
+}
+
+TEST(StationTableTests, expiry)
+{
+  StationTable table(4, 1s);
+  ASSERT_EQ(table.capacity(), 8);
+  StationTable::Clock::time_point t{ 100s };
+  for (uint32_t i = 0; i < table.capacity(); i++)
+  {
+    ASSERT_TRUE(table.update(makeState(i, 1.0), t));
+  }
+  ASSERT_FALSE(table.update(makeState(1000, 1.0), t));
+  ASSERT_FALSE(table.get(0, t + 2s));
+  ASSERT_TRUE(table.snapshot(t + 2s).empty());
+
+  // slots of silent stations are reused
+  ASSERT_TRUE(table.update(makeState(1000, 1.0), t + 2s));
+  ASSERT_TRUE(table.get(1000, t + 2s));
+  ASSERT_EQ(table.snapshot(t + 2s).size(), 1);
+}
+
+TEST(StationTableTests, concurrentReaders)
+{
+  StationTable table(64, 10s);
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    for (int i = 0; i < 100000; i++)
+    {
+      table.update(makeState(i % 32, i));
+    }
+    done = true;
+  });
+  // failing while the writer is joinable would terminate, so the first torn state is checked after the join
+  std::optional<StationState> torn;
+  while (!done && !torn)
+  {
+    for (const auto& state : table.snapshot())
+    {
+      // all fields of a state must stem from the same update
+      if (state.speed != state.latitude || static_cast<uint32_t>(state.speed) % 32 != state.station_id)
+      {
+        torn = state;
+        break;
+      }
+    }
+  }
+  writer.join();
+  ASSERT_FALSE(torn.has_value()) << "station " << torn->station_id << ": speed " << torn->speed << ", latitude "
+                                 << torn->latitude;
+}
+
+}  // namespace mrm::v2x_etsi_asn1_lib
@@ -0,0 +1,492 @@
+#include <v2x_etsi_asn1_lib/v2x_etsi_asn1_lib.h>
+#include <v2x_etsi_asn1_lib/encoding.h>
+#include <v2x_etsi_asn1_lib/geo_tiles.h>
+#include <v2x_etsi_asn1_lib/loopback_transport.h>
+#include <v2x_etsi_asn1_lib/message_builder.h>
+#include <v2x_amqp_connector_lib/local_broker.h>
+#include <gtest/gtest.h>
+#include "test_messages.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace mrm::v2x_etsi_asn1_lib
+{
+using namespace std::chrono_literals;
+using test::buildCAM;
+using test::buildCPM;
+
+namespace
+{
+// Message type outside of type2str and of the dense handler range
+const auto custom_type = static_cast<ETSIMessageType>(4096);
+
+struct TestTransceiver : ETSIAMQPTransceiverBase
+{
+  using ETSIAMQPTransceiverBase::findHandler;
+  using ETSIAMQPTransceiverBase::handleMessage;
+
+  void handleCAM(const std::shared_ptr<const CAM>& msg, const BinaryETSIMessage& msg_bin) override
+  {
+    std::lock_guard<std::mutex> l(lock);
+    cams.push_back(msg);
+    encodings.push_back(msg_bin.encoding);
+  }
+
+  void handleCPM(const std::shared_ptr<const CollectivePerceptionMessage>& msg,
+                 const BinaryETSIMessage& msg_bin) override
+  {
+    std::lock_guard<std::mutex> l(lock);
+    cpm_station_ids.push_back(msg_bin.station_id);
+    cpm_header_station_ids.push_back(msg->header.stationId);
+    cpms.push_back(msg);
+    encodings.push_back(msg_bin.encoding);
+  }
+
+  std::mutex lock;
+  // station IDs of the AMQP message properties and of the message headers
+  std::vector<StationId_t> cpm_station_ids;
+  std::vector<StationId_t> cpm_header_station_ids;
+  std::vector<std::shared_ptr<const CAM>> cams;
+  std::vector<std::shared_ptr<const CollectivePerceptionMessage>> cpms;
+  // wire encodings of all received messages
+  std::vector<WireEncoding> encodings;
+};
+
+struct RecordingSink : ETSIMessageSink
+{
+  void deliver(const proton::message& message) override
+  {
+    messages.push_back(message);
+  }
+  void deliver(const BinaryETSIMessage& /*message*/) override
+  {
+  }
+
+  std::vector<proton::message> messages;
+};
+
+bool waitFor(const std::function<bool()>& condition)
+{
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (!condition())
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+// Subjects of the next num messages, closes the client if they do not arrive in time
+std::vector<std::string> receiveSubjects(mrm::v2x_amqp_connector_lib::AMQPClient& client, size_t num)
+{
+  auto received = std::async(std::launch::async, [&]() {
+    std::vector<std::string> subjects;
+    while (subjects.size() < num)
+    {
+      auto msg = client.receive();
+      if (!msg)
+      {
+        break;
+      }
+      subjects.push_back(msg->subject());
+    }
+    return subjects;
+  });
+  if (received.wait_for(5s) != std::future_status::ready)
+  {
+    client.close();
+  }
+  return received.get();
+}
+
+// Sends two CPMs followed by two CPMs as custom message type of high priority in one batch through a local broker,
+// returns the subjects in the order they arrived
+std::vector<std::string> sendPrioritizedBatch(TestTransceiver& sender)
+{
+  mrm::v2x_amqp_connector_lib::LocalBroker broker;
+  EXPECT_TRUE(broker.start());
+  const auto url = "127.0.0.1:" + std::to_string(broker.port());
+  mrm::v2x_amqp_connector_lib::AMQPClient receiver(url, "etsi", "", "anonymous", "");
+  EXPECT_TRUE(sender.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage,
+      custom_type,
+      [](const std::shared_ptr<const CollectivePerceptionMessage>& /*msg*/, const BinaryETSIMessage& /*msg_bin*/) {},
+      "custom"));
+  EXPECT_TRUE(sender.setSendPriority(custom_type, SendPriority::High));
+  sender.connect(1, url, "", "etsi", "anonymous", "");
+  if (!waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }))
+  {
+    ADD_FAILURE() << "not connected to the local broker";
+    return {};
+  }
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7);
+  std::vector<StationETSIMessage> msgs;
+  for (const auto message_type : { ETSIMessageType::CPM, ETSIMessageType::CPM, custom_type, custom_type })
+  {
+    msgs.push_back({ 7, &asn_DEF_CollectivePerceptionMessage, message_type, builder.get() });
+  }
+  EXPECT_EQ(sender.sendETSIMsgBatch(msgs), 4);
+  auto subjects = receiveSubjects(receiver, 4);
+
+  // one lane per SendPriority
+  const auto stats = sender.sendLaneStats();
+  EXPECT_EQ(stats.size(), num_send_priorities);
+  if (stats.size() == num_send_priorities)
+  {
+    EXPECT_EQ(stats[static_cast<size_t>(SendPriority::High)].sent, 2);
+    EXPECT_EQ(stats[static_cast<size_t>(SendPriority::Normal)].sent, 0);
+    EXPECT_EQ(stats[static_cast<size_t>(SendPriority::Low)].sent, 2);
+  }
+  sender.disconnect();
+  return subjects;
+}
+}  // namespace
+
+TEST(TransceiverTests, registersHandlerOfCustomMessageType)
+{
+  auto bus = LoopbackBus::create();
+  TestTransceiver sender;
+  TestTransceiver receiver;
+  std::atomic<int> num_received = 0;
+  auto handler = [&](const std::shared_ptr<const CollectivePerceptionMessage>& msg, const BinaryETSIMessage& msg_bin) {
+    if (msg->header.stationId == 7 && msg_bin.message_type == custom_type)
+    {
+      num_received++;
+    }
+  };
+  ASSERT_TRUE(sender.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage, custom_type, handler, "custom"));
+  ASSERT_TRUE(receiver.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage, custom_type, handler, "custom"));
+  ASSERT_EQ(receiver.findHandler(custom_type)->subject, "custom");
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7);
+  ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CollectivePerceptionMessage, custom_type, builder.get()));
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+  ASSERT_EQ(num_received, 1);
+  // the built-in CPM handler is not involved
+  ASSERT_TRUE(receiver.cpm_station_ids.empty());
+}
+
+TEST(TransceiverTests, rejectsHandlerWithoutSubject)
+{
+  TestTransceiver transceiver;
+  auto handler = [](const std::shared_ptr<const CollectivePerceptionMessage>& /*msg*/,
+                    const BinaryETSIMessage& /*msg_bin*/) {};
+  ASSERT_FALSE(transceiver.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage, custom_type, handler));
+  ASSERT_EQ(transceiver.findHandler(custom_type), nullptr);
+
+  // within the dense range, but not listed in type2str
+  const auto unlisted_type = static_cast<ETSIMessageType>(ETSIMessageType::DENM + 10);
+  ASSERT_FALSE(transceiver.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage, unlisted_type, handler));
+  ASSERT_EQ(transceiver.findHandler(unlisted_type)->dispatch, nullptr);
+  ASSERT_TRUE(transceiver.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage, unlisted_type, handler, "unlisted"));
+  ASSERT_NE(transceiver.findHandler(unlisted_type)->dispatch, nullptr);
+}
+
+TEST(TransceiverTests, replacesBuiltInHandlerKeepingItsLimits)
+{
+  auto bus = LoopbackBus::create();
+  TestTransceiver sender;
+  TestTransceiver receiver;
+  DecodeLimits limits = defaultDecodeLimits(ETSIMessageType::CPM);
+  limits.max_elements = 3;
+  receiver.setDecodeLimits(ETSIMessageType::CPM, limits);
+  receiver.setSendPriority(ETSIMessageType::CPM, SendPriority::High);
+  std::atomic<int> num_received = 0;
+  ASSERT_TRUE(receiver.registerHandler<CollectivePerceptionMessage>(
+      asn_DEF_CollectivePerceptionMessage,
+      ETSIMessageType::CPM,
+      [&](const std::shared_ptr<const CollectivePerceptionMessage>& /*msg*/, const BinaryETSIMessage& /*msg_bin*/) {
+        num_received++;
+      }));
+  const auto* handler = receiver.findHandler(ETSIMessageType::CPM);
+  ASSERT_EQ(handler->subject, "cpm");
+  ASSERT_EQ(handler->limits.max_elements, 3);
+  ASSERT_EQ(handler->priority, SendPriority::High);
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7);
+  ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get()));
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+  ASSERT_EQ(num_received, 1);
+  ASSERT_TRUE(receiver.cpm_station_ids.empty());
+}
+
+TEST(TransceiverTests, prioritizesDENMsOverCPMsByDefault)
+{
+  TestTransceiver transceiver;
+  ASSERT_EQ(transceiver.findHandler(ETSIMessageType::DENM)->priority, SendPriority::High);
+  ASSERT_EQ(transceiver.findHandler(ETSIMessageType::CAM)->priority, SendPriority::Normal);
+  ASSERT_EQ(transceiver.findHandler(ETSIMessageType::MCM)->priority, SendPriority::Normal);
+  ASSERT_EQ(transceiver.findHandler(ETSIMessageType::CPM)->priority, SendPriority::Low);
+  ASSERT_TRUE(transceiver.setSendPriority(ETSIMessageType::CPM, SendPriority::Normal));
+  ASSERT_EQ(transceiver.findHandler(ETSIMessageType::CPM)->priority, SendPriority::Normal);
+  // without a transport, nothing is queued
+  ASSERT_TRUE(transceiver.sendLaneStats().empty());
+}
+
+TEST(TransceiverTests, sendsInOrderOfPriority)
+{
+  TestTransceiver sender;
+  ASSERT_EQ(sendPrioritizedBatch(sender), std::vector<std::string>({ "custom", "custom", "cpm", "cpm" }));
+}
+
+TEST(TransceiverTests, sendsWeightedByPriority)
+{
+  TestTransceiver sender;
+  sender.setSendScheduling(mrm::v2x_amqp_connector_lib::LaneScheduling::Weighted, { 1, 1, 1 });
+  ASSERT_EQ(sendPrioritizedBatch(sender), std::vector<std::string>({ "custom", "cpm", "custom", "cpm" }));
+}
+
+TEST(TransceiverTests, sendsOnBehalfOfOtherStations)
+{
+  auto bus = LoopbackBus::create();
+  TestTransceiver sender;
+  TestTransceiver receiver;
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7);
+  ASSERT_TRUE(sender.sendETSIMsgAs(100, &asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get()));
+  auto encoded = encodeETSIMsg(&asn_DEF_CollectivePerceptionMessage, WireEncoding::UPER, builder.get());
+  ASSERT_NE(encoded.buffer, nullptr);
+  ASSERT_TRUE(sender.sendEncodedETSIMsgAs(
+      101, static_cast<const char*>(encoded.buffer), encoded.result.encoded, ETSIMessageType::CPM));
+  free(encoded.buffer);
+
+  // a CAM without high frequency container cannot be encoded, it is skipped and not counted as sent
+  MessageBuilder<CAM> invalid_cam;
+  invalid_cam.reset();
+  std::vector<StationETSIMessage> batch;
+  for (StationId_t station_id = 200; station_id < 205; station_id++)
+  {
+    batch.push_back({ station_id, &asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get() });
+  }
+  batch[2] = { 202, &asn_DEF_CAM, ETSIMessageType::CAM, invalid_cam.get() };
+  ASSERT_EQ(sender.sendETSIMsgBatch(batch), 4);
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+
+  // the station ID on the wire is the one of each message, the message headers are not changed
+  ASSERT_EQ(receiver.cpm_station_ids, std::vector<StationId_t>({ 100, 101, 200, 201, 203, 204 }));
+  ASSERT_EQ(receiver.cpm_header_station_ids, std::vector<StationId_t>(6, 7));
+}
+
+TEST(TransceiverTests, decodesMessagesOfAllWireEncodings)
+{
+  MessageBuilder<CAM> cam_builder;
+  buildCAM(cam_builder, 7, 12.5);
+  MessageBuilder<CollectivePerceptionMessage> cpm_builder;
+  buildCPM(cpm_builder, 8, 52.5, 13.4);
+
+  for (const auto encoding : { WireEncoding::UPER, WireEncoding::APER, WireEncoding::OER })
+  {
+    auto bus = LoopbackBus::create();
+    TestTransceiver sender;
+    TestTransceiver receiver;
+    sender.setWireEncoding(encoding);
+    sender.connect(1, bus->attach());
+    receiver.connect(2, bus->attach());
+    auto raw_receiver = bus->attach();
+
+    ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CAM, ETSIMessageType::CAM, cam_builder.get()));
+    ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, cpm_builder.get()));
+
+    // the encoding is only named in the properties if it is not the default UPER
+    RecordingSink sink;
+    ASSERT_TRUE(raw_receiver->receive(sink));
+    ASSERT_TRUE(raw_receiver->receive(sink));
+    for (const auto& message : sink.messages)
+    {
+      ASSERT_EQ(message.properties().exists("enc"), encoding != WireEncoding::UPER);
+      if (encoding != WireEncoding::UPER)
+      {
+        ASSERT_EQ(proton::get<std::string>(message.properties().get("enc")), toString(encoding));
+      }
+    }
+    ASSERT_TRUE(bus->waitUntilIdle(1s));
+
+    ASSERT_EQ(receiver.encodings, std::vector<WireEncoding>({ encoding, encoding })) << toString(encoding);
+    ASSERT_EQ(receiver.cams.size(), 1);
+    const auto& cam = *receiver.cams[0];
+    ASSERT_EQ(cam.header.stationId, 7);
+    ASSERT_EQ(cam.cam.generationDeltaTime, 1234);
+    ASSERT_EQ(cam.cam.camParameters.basicContainer.referencePosition.latitude, 484000000);
+    ASSERT_EQ(cam.cam.camParameters.highFrequencyContainer.present,
+              HighFrequencyContainer_PR_basicVehicleContainerHighFrequency);
+    const auto& hf = cam.cam.camParameters.highFrequencyContainer.choice.basicVehicleContainerHighFrequency;
+    ASSERT_EQ(hf.speed.speedValue, 1250);
+    ASSERT_EQ(hf.heading.headingValue, 900);
+    ASSERT_EQ(hf.yawRate.yawRateValue, YawRateValue_unavailable);
+
+    ASSERT_EQ(receiver.cpms.size(), 1);
+    const auto& cpm = *receiver.cpms[0];
+    ASSERT_EQ(cpm.header.stationId, 8);
+    uint64_t reference_time = 0;
+    ASSERT_EQ(asn_INTEGER2umax(&cpm.payload.managementContainer.referenceTime, &reference_time), 0);
+    ASSERT_EQ(reference_time, 600000000000);
+    ASSERT_EQ(cpm.payload.managementContainer.referencePosition.latitude, 525000000);
+    ASSERT_EQ(cpm.payload.managementContainer.referencePosition.longitude, 134000000);
+  }
+}
+
+TEST(TransceiverTests, dropsMessagesOfUnknownWireEncoding)
+{
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7);
+  auto encoded = encodeETSIMsg(&asn_DEF_CollectivePerceptionMessage, WireEncoding::UPER, builder.get());
+  ASSERT_NE(encoded.buffer, nullptr);
+  OutgoingETSIMessage outgoing;
+  outgoing.message_type = ETSIMessageType::CPM;
+  outgoing.subject = "cpm";
+  outgoing.station_id = 1;
+  outgoing.data = static_cast<const uint8_t*>(encoded.buffer);
+  outgoing.size = encoded.result.encoded;
+  auto message = makeProtonMessage(outgoing);
+  free(encoded.buffer);
+
+  TestTransceiver receiver;
+  receiver.handleMessage(message);
+  ASSERT_EQ(receiver.cpm_station_ids.size(), 1);
+
+  for (const std::string enc : { "ber", "UPER", "" })
+  {
+    message.properties().put("enc", enc);
+    receiver.handleMessage(message);
+    ASSERT_EQ(receiver.cpm_station_ids.size(), 1) << enc;
+  }
+  message.properties().put("enc", std::string("uper"));
+  receiver.handleMessage(message);
+  ASSERT_EQ(receiver.cpm_station_ids.size(), 2);
+}
+
+TEST(TransceiverTests, addsQuadkeysOfReferencePosition)
+{
+  auto bus = LoopbackBus::create();
+  TestTransceiver sender;
+  sender.enableGeoTileProperties({ 10, 13, 16 });
+  sender.connect(1, bus->attach());
+  auto receiver = bus->attach();
+
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7, 48.4, 10.0);
+  ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get()));
+  // sendEncodedETSIMsg() takes the given position instead of decoding the message
+  auto encoded = encodeETSIMsg(&asn_DEF_CollectivePerceptionMessage, WireEncoding::UPER, builder.get());
+  ASSERT_NE(encoded.buffer, nullptr);
+  ASSERT_TRUE(sender.sendEncodedETSIMsg(static_cast<const char*>(encoded.buffer),
+                                        encoded.result.encoded,
+                                        ETSIMessageType::CPM,
+                                        {},
+                                        WireEncoding::UPER,
+                                        GeoPosition{ 52.5, 13.4 }));
+  free(encoded.buffer);
+
+  RecordingSink sink;
+  ASSERT_TRUE(receiver->receive(sink));
+  ASSERT_TRUE(receiver->receive(sink));
+  ASSERT_EQ(sink.messages.size(), 2);
+  const GeoPosition positions[] = { { 48.4, 10.0 }, { 52.5, 13.4 } };
+  for (size_t i = 0; i < 2; i++)
+  {
+    const auto& properties = sink.messages[i].properties();
+    for (unsigned zoom : { 10, 13, 16 })
+    {
+      ASSERT_EQ(proton::get<std::string>(properties.get(quadkeyProperty(zoom))),
+                quadkey(positions[i].latitude, positions[i].longitude, zoom))
+          << i << " " << zoom;
+    }
+    ASSERT_FALSE(properties.exists(quadkeyProperty(14)));
+  }
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+}
+
+TEST(TransceiverTests, indexesPerceivedObjectsOfReceivedCPMs)
+{
+  auto bus = LoopbackBus::create();
+  TestTransceiver sender;
+  TestTransceiver receiver;
+  receiver.enableSpatialIndex(48.4, 10.0);
+  sender.connect(1, bus->attach());
+  receiver.connect(2, bus->attach());
+
+  // object positions are relative to the reference position, which is the origin of the index
+  MessageBuilder<CollectivePerceptionMessage> builder;
+  buildCPM(builder, 7, 48.4, 10.0);
+  test::appendPerceivedObject(builder, 3, 10.0, -5.0);
+  ASSERT_TRUE(sender.sendETSIMsg(&asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get()));
+  ASSERT_TRUE(bus->waitUntilIdle(1s));
+
+  const auto entities = receiver.spatialIndex()->queryRadius({ 10.0, -5.0 }, 0.1);
+  ASSERT_EQ(entities.size(), 1);
+  ASSERT_EQ(entities[0].kind, SpatialEntity::Kind::PerceivedObject);
+  ASSERT_EQ(entities[0].station_id, 7);
+  ASSERT_EQ(entities[0].object_id, 3);
+  ASSERT_NEAR(entities[0].position.x, 10.0, 1e-3);
+  ASSERT_NEAR(entities[0].position.y, -5.0, 1e-3);
+}
+
+TEST(TransceiverTests, replacesReceiveFilterAtRuntime)
+{
+  mrm::v2x_amqp_connector_lib::LocalBroker broker;
+  ASSERT_TRUE(broker.start());
+  const auto url = "127.0.0.1:" + std::to_string(broker.port());
+  TestTransceiver sender;
+  TestTransceiver receiver;
+  sender.enableGeoTileProperties({ 14 });
+  receiver.connect(2, url, "etsi", "", "anonymous", "", quadkeySelector(52.5, 13.4, 1000.0, 14));
+  sender.connect(1, url, "", "etsi", "anonymous", "");
+  ASSERT_TRUE(waitFor([&]() { return broker.stats().receivers == 1 && sender.is_sender_connected(); }));
+  auto received = [&]() {
+    std::lock_guard<std::mutex> l(receiver.lock);
+    return receiver.cpm_station_ids;
+  };
+
+  MessageBuilder<CollectivePerceptionMessage> ulm;
+  MessageBuilder<CollectivePerceptionMessage> berlin;
+  MessageBuilder<CollectivePerceptionMessage> ulm_last;
+  buildCPM(ulm, 7, 48.4, 10.0);
+  buildCPM(berlin, 8, 52.5, 13.4);
+  buildCPM(ulm_last, 9, 48.4, 10.0);
+  auto send = [&](MessageBuilder<CollectivePerceptionMessage>& builder) {
+    // on behalf of the station in the header, which the receiver gets as station ID of the message
+    return sender.sendETSIMsgAs(
+        builder.get()->header.stationId, &asn_DEF_CollectivePerceptionMessage, ETSIMessageType::CPM, builder.get());
+  };
+  ASSERT_TRUE(send(ulm));
+  ASSERT_TRUE(send(berlin));
+  ASSERT_TRUE(waitFor([&]() { return !received().empty(); }));
+  ASSERT_EQ(received(), std::vector<StationId_t>({ 8 }));
+
+  // messages arriving while the receiver is re-attached are not received, so send until the new selector is used
+  ASSERT_TRUE(receiver.setReceiveFilter(quadkeySelector(48.4, 10.0, 1000.0, 14)));
+  ASSERT_TRUE(waitFor([&]() {
+    send(ulm);
+    std::this_thread::sleep_for(10ms);
+    return received().back() == 7;
+  }));
+  ASSERT_TRUE(send(berlin));
+  ASSERT_TRUE(send(ulm_last));
+  ASSERT_TRUE(waitFor([&]() { return received().back() == 9; }));
+  const auto station_ids = received();
+  ASSERT_EQ(std::count(station_ids.begin(), station_ids.end(), 8), 1);
+  ASSERT_EQ(broker.stats().receivers, 1);
+}
+}  // namespace mrm::v2x_etsi_asn1_lib
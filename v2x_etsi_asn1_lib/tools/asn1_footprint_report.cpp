@@ -0,0 +1,97 @@
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Compares the full asn1 library with the trimmed asn1_pdus one: size of the libraries and of the asn1_startup
+// binaries linked against them, and the median time to start, run and exit those binaries.
+//
+//   asn1_footprint_report <libasn1.so> <libasn1_pdus.a> <asn1_startup_full> <asn1_startup_pdus> [runs]
+
+extern char** environ;
+
+namespace
+{
+struct Variant
+{
+  std::string name;
+  std::filesystem::path library;
+  std::filesystem::path binary;
+  std::vector<double> startup_ms;
+};
+
+// Wall time of one run of the binary in milliseconds, negative if it could not be run
+double runOnce(const std::filesystem::path& binary)
+{
+  const std::string path = binary.string();
+  char* argv[] = { const_cast<char*>(path.c_str()), nullptr };
+  const auto start = std::chrono::steady_clock::now();
+  pid_t pid;
+  if (posix_spawn(&pid, path.c_str(), nullptr, nullptr, argv, environ) != 0)
+  {
+    return -1.0;
+  }
+  int status;
+  if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+  {
+    return -1.0;
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double kiloBytes(const std::filesystem::path& path)
+{
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  return ec ? 0.0 : static_cast<double>(size) / 1024.0;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 5)
+  {
+    std::cerr << "usage: " << argv[0] << " <libasn1.so> <libasn1_pdus.a> <asn1_startup_full> <asn1_startup_pdus> [runs]"
+              << std::endl;
+    return 1;
+  }
+  const int runs = argc > 5 ? std::max(1, std::atoi(argv[5])) : 200;
+  std::vector<Variant> variants = { { "full (shared)", argv[1], argv[3], {} },
+                                    { "PDUs (static, LTO)", argv[2], argv[4], {} } };
+
+  // interleaved, so that both see the same system load
+  for (int i = 0; i < runs; i++)
+  {
+    for (auto& variant : variants)
+    {
+      const double ms = runOnce(variant.binary);
+      if (ms < 0.0)
+      {
+        std::cerr << "Could not run " << variant.binary << std::endl;
+        return 1;
+      }
+      variant.startup_ms.push_back(ms);
+    }
+  }
+
+  std::cout << std::left << std::setw(20) << "asn1 library" << std::right << std::setw(14) << "library [kB]"
+            << std::setw(14) << "binary [kB]" << std::setw(16) << "startup [ms]" << std::endl;
+  for (auto& variant : variants)
+  {
+    auto& ms = variant.startup_ms;
+    std::nth_element(ms.begin(), ms.begin() + ms.size() / 2, ms.end());
+    std::cout << std::left << std::setw(20) << variant.name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << kiloBytes(variant.library) << std::setw(14) << kiloBytes(variant.binary)
+              << std::setw(16) << std::setprecision(3) << ms[ms.size() / 2] << std::endl;
+  }
+  std::cout << "(median of " << runs << " runs; the static library is linked into the binary, and its size is that "
+            << "of the LTO objects)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,19 @@
+#include "asn1_pdus.h"
+
+#include <cstdint>
+
+// Minimal process using the codec of the V2X_ETSI_ASN1_PDUS, built against the full asn1 library and against
+// asn1_pdus to compare their startup time: it runs the UPER decoder of each PDU once and exits.
+int main()
+{
+  const asn_TYPE_descriptor_t* pdus[] = { ASN1_PDU_DESCRIPTORS };
+  // whether decoding zeros fails does not matter
+  const uint8_t data[8] = {};
+  for (const auto* td : pdus)
+  {
+    void* msg = nullptr;
+    uper_decode_complete(nullptr, td, &msg, data, sizeof(data));
+    ASN_STRUCT_FREE(*td, msg);
+  }
+  return 0;
+}